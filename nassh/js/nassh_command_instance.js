@@ -1166,6 +1166,8 @@ CommandInstance.prototype.connectToFinalize_ = async function(params, options) {
 
   const argv = {
     debugTrace: options['--debug-trace-syscalls'],
+    debugProfile: options['--debug-profile-syscalls'],
+    debugRecord: options['--debug-record-syscalls'],
     command: params.command,
   };
   argv.terminalWidth = this.io.terminal_.screenSize.width;
@@ -1468,6 +1470,8 @@ CommandInstance.prototype.initWasmSubproc_ =
     async function(argv, environ, {
       executable,
       trace = false,
+      profile = false,
+      record = false,
       captureStdout = false,
     } = {}) {
 
@@ -1480,6 +1484,8 @@ CommandInstance.prototype.initWasmSubproc_ =
     environ: environ,
     terminal: this.io.terminal_,
     trace: trace,
+    profile: profile,
+    record: record,
     authAgent: this.authAgent_,
     authAgentAppID: this.authAgentAppID_,
     relay: this.relay_,
@@ -1522,6 +1528,8 @@ CommandInstance.prototype.initProgram_ = async function(argv) {
         argv.environment, {
           captureStdout: true,
           trace: argv.debugTrace,
+          profile: argv.debugProfile,
+          record: argv.debugRecord,
         });
     this.io.println(localize('PLUGIN_LOADING_COMPLETE'));
     // We don't check the exit status as we'll process the output below.
@@ -1556,6 +1564,8 @@ CommandInstance.prototype.initProgram_ = async function(argv) {
     argv.arguments, argv.environment, {
       executable: executable,
       trace: argv.debugTrace,
+      profile: argv.debugProfile,
+      record: argv.debugRecord,
     });
   this.io.println(localize('PLUGIN_LOADING_COMPLETE'));
   subproc.run().then(async (code) => {
@@ -53,6 +53,17 @@ export class Stream {
   onDataAvailable(data) {
     throw Stream.ERR_NOT_IMPLEMENTED;
   }
+
+  /**
+   * Ask the stream to slow down delivering data.
+   *
+   * This is called when the reader has fallen behind, and again when it has
+   * caught up.  Streams that can apply backpressure to their source should
+   * (e.g. by not reading any more), but may keep delivering data meanwhile.
+   *
+   * @param {boolean} paused
+   */
+  setPaused(paused) {}
 }
 
 /**
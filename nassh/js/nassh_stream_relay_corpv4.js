@@ -184,6 +184,9 @@ export class RelayCorpv4WsStream extends Stream {
      */
     this.writeAckCount_ = BigInt(0);
 
+    // Whether we're holding back acks for data we've read (see setPaused).
+    this.paused_ = false;
+
     /**
      * Session id for reconnecting.
      *
@@ -413,6 +416,30 @@ export class RelayCorpv4WsStream extends Stream {
     }
   }
 
+  /**
+   * Ack all the data we've read so far.
+   */
+  sendAck_() {
+    if (this.socket_ && this.socket_.readyState == WebSocket.OPEN) {
+      const ackPacket = new ClientAckPacket(this.readCount_);
+      this.socket_.send(ackPacket.frame);
+    }
+  }
+
+  /**
+   * The relay only sends so much data before it waits for acks, so holding
+   * them back stops the server while our reader catches up.
+   *
+   * @param {boolean} paused
+   * @override
+   */
+  setPaused(paused) {
+    this.paused_ = paused;
+    if (!paused) {
+      this.sendAck_();
+    }
+  }
+
   /**
    * Callback when new data is available from the server.
    *
@@ -437,8 +464,9 @@ export class RelayCorpv4WsStream extends Stream {
             data.byteOffset, data.byteOffset + data.byteLength));
 
         this.readCount_ += BigInt(packet.length);
-        const ackPacket = new ClientAckPacket(this.readCount_);
-        this.socket_.send(ackPacket.frame);
+        if (!this.paused_) {
+          this.sendAck_();
+        }
         break;
       }
 
@@ -232,6 +232,35 @@ it('RelayCorpv4WS basic', async () => {
   assert.isTrue(streamClosed);
 });
 
+/**
+ * Hold back acks while paused.
+ */
+it('RelayCorpv4WS paused', async () => {
+  const stream = new RelayCorpv4WsStream();
+  stream.socket_ = new WebSocketMock();
+  stream.socket_.readyState = WebSocket.OPEN;
+  const socketData = /** @type {!WebSocketMock} */ (stream.socket_).socketData;
+  stream.onDataAvailable = () => {};
+  const data = new MessageEvent('message', {
+    data: new Uint8Array([
+      0x00, 0x04, 0x00, 0x00, 0x00, 0x02, 0xff, 0x00,
+    ]).buffer,
+  });
+
+  stream.setPaused(true);
+  stream.onSocketData_(data);
+  stream.onSocketData_(data);
+  assert.equal(4, stream.readCount_);
+  assert.equal(0, socketData.length);
+
+  // Resuming acks everything at once.
+  stream.setPaused(false);
+  assert.deepStrictEqual([new Uint8Array([
+    0x00, 0x07,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04,
+  ])], socketData.map((frame) => new Uint8Array(frame)));
+});
+
 /**
  * Receive onSocketError() before completing connect.
  */
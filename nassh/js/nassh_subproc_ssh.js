@@ -110,9 +110,7 @@ class SftpPipeReadHandle extends FileHandle {
     data.set(this.data);
     data.set(buf, this.data.length);
     this.data = data;
-    if (this.handler.notify_) {
-      this.handler.notify_();
-    }
+    this.handler.onActivity_(this);
     return {nwritten: buf.length};
   }
 
@@ -172,6 +170,8 @@ export class SshSubproc extends WasmSubproc {
    *   environ: !Object<string, string>,
    *   terminal: !hterm.Terminal,
    *   trace: (boolean|undefined),
+   *   profile: (boolean|undefined),
+   *   record: (boolean|undefined),
    *   authAgent: ?Agent,
    *   authAgentAppID: string,
    *   relay: ?Relay,
@@ -183,11 +183,11 @@ export class SshSubproc extends WasmSubproc {
    *   sshPolicy: ?SshPolicy,
    * }} opts
    */
-  constructor({executable, argv, environ, terminal, trace, authAgent,
-               authAgentAppID, relay, secureInput, captureStdout,
+  constructor({executable, argv, environ, terminal, trace, profile, record,
+               authAgent, authAgentAppID, relay, secureInput, captureStdout,
     isSftp, sftpClient, syncStorage, sshPolicy}) {
-    super({executable, argv, environ, terminal, trace, authAgent,
-           authAgentAppID, relay, secureInput, captureStdout});
+    super({executable, argv, environ, terminal, trace, profile, record,
+           authAgent, authAgentAppID, relay, secureInput, captureStdout});
 
     this.isSftp_ = isSftp;
     this.sftpClient_ = sftpClient;
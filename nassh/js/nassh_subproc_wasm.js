@@ -21,13 +21,33 @@ import {Stream} from './nassh_stream.js';
 import {SshAgentStream} from './nassh_stream_sshagent.js';
 import {SshAgentRelayStream} from './nassh_stream_sshagent_relay.js';
 
-import {WASI} from '../../wasi-js-bindings/index.js';
+import {
+  ModuleCache, Scheduler, WASI, WorkerPool,
+} from '../../wasi-js-bindings/index.js';
 
 import * as WasshProcess from '../wassh/js/process.js';
 import {cleanupChromeSockets} from '../wassh/js/sockets.js';
 import * as WasshSyscallHandler from '../wassh/js/syscall_handler.js';
 import {FileHandle, FileHandler} from '../wassh/js/vfs.js';
 
+/**
+ * Compiled programs shared by all processes in this page.
+ */
+const moduleCache = new ModuleCache();
+
+/**
+ * Spare workers shared by all processes in this page, by worker URI.
+ *
+ * @type {!Map<string, !WorkerPool>}
+ */
+const workerPools = new Map();
+
+/**
+ * Services syscalls fairly across all processes in this page, so a busy
+ * session (e.g. a big transfer) doesn't hold up the others.
+ */
+const scheduler = new Scheduler();
+
 /**
  * A path backed by a key in a specific lib.Storage.
  *
@@ -268,6 +288,8 @@ export class WasmSubproc {
    *   environ: !Object<string, string>,
    *   terminal: !hterm.Terminal,
    *   trace: (boolean|undefined),
+   *   profile: (boolean|undefined),
+   *   record: (boolean|undefined),
    *   authAgent: ?Agent,
    *   authAgentAppID: string,
    *   relay: ?Relay,
@@ -275,13 +297,15 @@ export class WasmSubproc {
    *   captureStdout: (boolean|undefined),
    * }} opts
    */
-  constructor({executable, argv, environ, terminal, trace, authAgent,
-               authAgentAppID, relay, secureInput, captureStdout}) {
+  constructor({executable, argv, environ, terminal, trace, profile, record,
+               authAgent, authAgentAppID, relay, secureInput, captureStdout}) {
     this.executable_ = executable;
     this.argv_ = argv;
     this.environ_ = environ;
     this.terminal_ = terminal;
     this.trace_ = trace === undefined ? false : trace;
+    this.profile_ = profile === undefined ? false : profile;
+    this.record_ = record === undefined ? false : record;
     this.authAgent_ = authAgent;
     this.authAgentAppID_ = authAgentAppID;
     this.relay_ = relay;
@@ -302,6 +326,14 @@ export class WasmSubproc {
       this.environ_['SSH_AUTH_SOCK'] = `/AF_UNIX/agent/${this.authAgentAppID_}`;
     }
 
+    const workerUri = `../wassh/js/worker.js?trace=${this.trace_}` +
+        `&profile=${this.profile_}&record=${this.record_}`;
+    let workerPool = workerPools.get(workerUri);
+    if (workerPool === undefined) {
+      workerPool = new WorkerPool(sanitizeScriptUrl(workerUri));
+      workerPools.set(workerUri, workerPool);
+    }
+
     const settings = {
       executable: this.executable_,
       argv: [this.executable_, ...this.argv_],
@@ -318,14 +350,16 @@ export class WasmSubproc {
       // NB: Max buffer to support in a single syscall; OpenSSH is known to call
       // read() on 256KiB data, so use a bit bigger for locking overhead.
       sabSize: 257 * 1024,
+      moduleCache,
+      workerPool,
+      scheduler,
     };
     await settings.handler.init();
 
     await this.initHandler_(settings.handler);
 
     this.process_ = new WasshProcess.Background(
-        sanitizeScriptUrl(`../wassh/js/worker.js?trace=${this.trace_}`),
-        settings);
+        workerPool.workerUri, settings);
   }
 
   /**
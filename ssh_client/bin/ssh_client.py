@@ -278,6 +278,12 @@ def _toolchain_wasm_env(target: str) -> dict:
     incdir = sysroot / "include" / target
     pcdir = libdir / "pkgconfig"
 
+    # Our allocator has to be linked before libc so it replaces dlmalloc.
+    # See wassh-libc-sup/src/malloc.c for details.
+    malloc_libs = ()
+    if os.environ.get("WASSH_MALLOC", "1") != "0":
+        malloc_libs = ("-lwassh-malloc",)
+
     ret = {
         # Only use single core here due to known bug in 89 release:
         # https://github.com/WebAssembly/binaryen/issues/2273
@@ -307,6 +313,7 @@ def _toolchain_wasm_env(target: str) -> dict:
         "LDFLAGS": " ".join(
             (
                 f"-L{libdir}",
+                *malloc_libs,
                 "-lwassh-libc-sup",
                 "-lwasi-emulated-getpid",
                 "-lwasi-emulated-process-clocks",
@@ -12,6 +12,7 @@ ncpus=$(getconf _NPROCESSORS_ONLN || echo 2)
 
 DEBUG=0
 OFFICIAL_RELEASE=0
+WASSH_MALLOC=1
 
 for i in $@; do
   case $i in
@@ -21,13 +22,19 @@ for i in $@; do
     "--official-release")
       OFFICIAL_RELEASE=1
       ;;
+    "--system-malloc")
+      WASSH_MALLOC=0
+      ;;
     *)
-      echo "usage: $0 [--debug]"
+      echo "usage: $0 [--debug] [--system-malloc]"
       exit 1
       ;;
   esac
 done
 
+# Whether to link programs against wassh-libc-sup's allocator.
+export WASSH_MALLOC
+
 cd "$(dirname "$0")"
 mkdir -p output
 
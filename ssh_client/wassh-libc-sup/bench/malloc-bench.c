@@ -0,0 +1,194 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Allocator benchmark that mimics OpenSSH's allocation patterns.
+//
+// An interactive session is mostly a stream of packets: each one allocates a
+// few small bookkeeping objects, and then grows an sshbuf (OpenSSH's dynamic
+// buffer) via realloc() up to the packet size, and frees it all shortly after.
+// Bulk transfers (scp/sftp) do the same but with packets up to the max channel
+// window size.  We also keep a pool of longer lived objects around to fragment
+// the heap like key exchange state & channel structures do.
+//
+// We report the throughput (ops/sec) and how much WASM memory was used.  Since
+// WASM memory never shrinks, the final memory size is also the peak.
+//
+// With our allocator, we also interleave new small spans with large blocks and
+// check the heap only grew by about what was allocated.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef WASSH_MALLOC
+#include <wassh-malloc.h>
+#endif
+
+// How many packets to simulate.
+#define ITERATIONS 200000
+
+// How many long lived objects to keep around.
+#define LIVE_SLOTS 512
+
+// How many packets can be in flight at once.
+#define INFLIGHT 16
+
+// sshbuf grows in 256 byte steps, so mimic that with realloc().
+#define SSHBUF_GROW 256
+
+// Simple deterministic PRNG so runs are comparable.
+static uint32_t rng_state = 1;
+static uint32_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+// Pick a packet size.  Most interactive traffic is tiny (keystrokes & screen
+// updates), with the occasional large bulk packet.
+static size_t packet_size(void) {
+  uint32_t r = rng() % 100;
+  if (r < 70) {
+    return 32 + rng() % 224;
+  } else if (r < 95) {
+    return 256 + rng() % 4096;
+  } else {
+    return 16384 + rng() % (256 * 1024 - 16384);
+  }
+}
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+#ifdef WASSH_MALLOC
+// How many rounds of mixed small & large allocations to make.
+#define MIXED_ROUNDS 64
+
+// Large enough that each one leaves a big tail in the arena.
+#define MIXED_LARGE (600 * 1024)
+
+// Interleave small spans with large blocks, and make sure the arena doesn't
+// leak memory between them.  Returns whether the heap growth looks sane.
+static bool check_mixed(void) {
+  static void* large[MIXED_ROUNDS];
+  static void* small[MIXED_ROUNDS][4096];
+
+  struct wassh_malloc_stats before, after;
+  wassh_malloc_get_stats(&before);
+  for (int i = 0; i < MIXED_ROUNDS; ++i) {
+    large[i] = malloc(MIXED_LARGE);
+    // Fill more than a span of one size so another one is needed.
+    size_t size = 16 << (i % 6);
+    for (size_t n = 0; n < 65536 / size; ++n) {
+      small[i][n] = malloc(size);
+    }
+  }
+  wassh_malloc_get_stats(&after);
+
+  size_t grew = after.heap_size - before.heap_size;
+  size_t used = after.in_use - before.in_use;
+  printf("mixed heap:  grew %zu KiB for %zu KiB in use\n", grew / 1024,
+         used / 1024);
+
+  for (int i = 0; i < MIXED_ROUNDS; ++i) {
+    free(large[i]);
+    size_t size = 16 << (i % 6);
+    for (size_t n = 0; n < 65536 / size; ++n) {
+      free(small[i][n]);
+    }
+  }
+
+  // Allow for the arena's growth granularity & alignment padding.
+  return grew <= used + used / 8 + 1024 * 1024;
+}
+#endif
+
+struct packet {
+  char* buf;
+  size_t len;
+  void* meta[3];
+};
+
+int main(void) {
+  size_t start_mem = __builtin_wasm_memory_size(0) * 65536;
+  void* live[LIVE_SLOTS] = {};
+  struct packet inflight[INFLIGHT] = {};
+  uint64_t ops = 0;
+
+  uint64_t start = now_ns();
+  for (int i = 0; i < ITERATIONS; ++i) {
+    // Release the oldest packet.
+    struct packet* pkt = &inflight[i % INFLIGHT];
+    free(pkt->buf);
+    for (size_t m = 0; m < 3; ++m) {
+      free(pkt->meta[m]);
+    }
+    ops += 4;
+
+    // Build a new one.
+    for (size_t m = 0; m < 3; ++m) {
+      pkt->meta[m] = malloc(16 + rng() % 112);
+      ++ops;
+    }
+    pkt->len = packet_size();
+    pkt->buf = NULL;
+    for (size_t len = 0; len < pkt->len;) {
+      len += SSHBUF_GROW;
+      if (len > pkt->len) {
+        len = pkt->len;
+      }
+      pkt->buf = realloc(pkt->buf, len);
+      if (!pkt->buf) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+      }
+      ++ops;
+    }
+    memset(pkt->buf, i, pkt->len);
+
+    // Churn a long lived object every so often.
+    if (i % 8 == 0) {
+      size_t slot = rng() % LIVE_SLOTS;
+      free(live[slot]);
+      live[slot] = malloc(64 + rng() % 2048);
+      ops += 2;
+    }
+  }
+  uint64_t elapsed = now_ns() - start;
+
+  size_t end_mem = __builtin_wasm_memory_size(0) * 65536;
+  printf("allocator:   %s\n",
+#ifdef WASSH_MALLOC
+         "wassh"
+#else
+         "dlmalloc"
+#endif
+  );
+  printf("ops:         %llu\n", (unsigned long long)ops);
+  printf("time:        %.3f ms\n", elapsed / 1e6);
+  printf("ops/sec:     %.0f\n", ops / (elapsed / 1e9));
+  printf("peak memory: %zu KiB (grew %zu KiB)\n", end_mem / 1024,
+         (end_mem - start_mem) / 1024);
+
+#ifdef WASSH_MALLOC
+  struct wassh_malloc_stats stats;
+  wassh_malloc_get_stats(&stats);
+  printf("heap size:   %zu KiB\n", stats.heap_size / 1024);
+  printf("peak in use: %zu KiB\n", stats.peak_in_use / 1024);
+
+  if (!check_mixed()) {
+    fprintf(stderr, "heap grew more than expected\n");
+    return 1;
+  }
+#endif
+
+  return 0;
+}
@@ -0,0 +1,278 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Micro-benchmarks for the syscall boundary.
+//
+// Each benchmark times a tight loop of a single syscall and reports ns/op, and
+// MB/s for the ones that move data.  This is meant to track regressions in the
+// WASM<->JS crossing across releases & runtimes, so the loops do as little as
+// possible beyond the syscall itself.
+//
+// The default build exercises our __wassh_* imports through the C library APIs
+// that wrap them.  The WASI_ONLY build sticks to standard WASI syscalls so it
+// can run under other runtimes (like wasmtime) as a point of comparison.
+//
+// Usage: syscall-bench [-n iterations] [-u host:port] [-e host:port]
+//   -n: How many times to run each loop (default 10000).
+//   -u: Where to send UDP packets (default 127.0.0.1:9, the discard service).
+//   -e: A TCP echo server for send/recv round trips (skipped by default).
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef WASI_ONLY
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#endif
+
+// Payload sizes to try for the benchmarks that move data.
+static const size_t kSizes[] = {16, 256, 4096, 32768};
+#define NUM_SIZES (sizeof(kSizes) / sizeof(*kSizes))
+#define MAX_SIZE 32768
+
+static unsigned long iterations = 10000;
+static char buf[MAX_SIZE];
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Print one result line.  |size| is the payload per op, or 0 if none.
+static void report(const char* name, size_t size, uint64_t elapsed) {
+  double ns_per_op = (double)elapsed / iterations;
+  printf("%-24s %6zu B %12.1f ns/op", name, size, ns_per_op);
+  if (size) {
+    printf(" %10.2f MB/s", size * 1e3 / ns_per_op);
+  }
+  printf("\n");
+}
+
+static void skip(const char* name, const char* reason) {
+  printf("%-24s skipped: %s\n", name, reason);
+}
+
+static void bench_clock_gettime(void) {
+  struct timespec ts;
+  uint64_t start = now_ns();
+  for (unsigned long i = 0; i < iterations; ++i) {
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+  }
+  report("clock_gettime", 0, now_ns() - start);
+}
+
+static void bench_poll(void) {
+  struct pollfd pfd = {.fd = STDOUT_FILENO, .events = POLLOUT};
+  uint64_t start = now_ns();
+  for (unsigned long i = 0; i < iterations; ++i) {
+    if (poll(&pfd, 1, 0) < 0) {
+      skip("poll", strerror(errno));
+      return;
+    }
+  }
+  report("poll", 0, now_ns() - start);
+}
+
+static void bench_write(void) {
+  int fd = open("/dev/null", O_WRONLY);
+  if (fd < 0) {
+    skip("fd_write", strerror(errno));
+    return;
+  }
+
+  for (size_t s = 0; s < NUM_SIZES; ++s) {
+    uint64_t start = now_ns();
+    for (unsigned long i = 0; i < iterations; ++i) {
+      if (write(fd, buf, kSizes[s]) < 0) {
+        skip("fd_write", strerror(errno));
+        close(fd);
+        return;
+      }
+    }
+    report("fd_write", kSizes[s], now_ns() - start);
+  }
+  close(fd);
+}
+
+#ifndef WASI_ONLY
+
+// Parse "host:port" into |sin|.
+static int parse_addr(const char* str, struct sockaddr_in* sin) {
+  char host[64];
+  const char* colon = strrchr(str, ':');
+  if (!colon || (size_t)(colon - str) >= sizeof(host)) {
+    return -1;
+  }
+  memcpy(host, str, colon - str);
+  host[colon - str] = '\0';
+
+  memset(sin, 0, sizeof(*sin));
+  sin->sin_family = AF_INET;
+  sin->sin_port = htons(atoi(colon + 1));
+  return inet_pton(AF_INET, host, &sin->sin_addr) == 1 ? 0 : -1;
+}
+
+static void bench_dup(void) {
+  uint64_t start = now_ns();
+  for (unsigned long i = 0; i < iterations; ++i) {
+    int fd = dup(STDOUT_FILENO);
+    if (fd < 0) {
+      skip("fd_dup+close", strerror(errno));
+      return;
+    }
+    close(fd);
+  }
+  report("fd_dup+close", 0, now_ns() - start);
+}
+
+static void bench_tty_get_window_size(void) {
+  struct winsize ws;
+  uint64_t start = now_ns();
+  for (unsigned long i = 0; i < iterations; ++i) {
+    if (ioctl(STDIN_FILENO, TIOCGWINSZ, &ws) < 0) {
+      skip("tty_get_window_size", strerror(errno));
+      return;
+    }
+  }
+  report("tty_get_window_size", 0, now_ns() - start);
+}
+
+static void bench_udp(const struct sockaddr_in* sin) {
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock < 0) {
+    skip("sock_sendto", strerror(errno));
+    return;
+  }
+
+  for (size_t s = 0; s < NUM_SIZES; ++s) {
+    uint64_t start = now_ns();
+    for (unsigned long i = 0; i < iterations; ++i) {
+      if (sendto(sock, buf, kSizes[s], 0, (const struct sockaddr*)sin,
+                 sizeof(*sin)) < 0) {
+        skip("sock_sendto", strerror(errno));
+        goto done;
+      }
+    }
+    report("sock_sendto", kSizes[s], now_ns() - start);
+  }
+
+  // Nothing is coming back, so this is the cost of the crossing alone.
+  uint64_t start = now_ns();
+  for (unsigned long i = 0; i < iterations; ++i) {
+    if (recv(sock, buf, MAX_SIZE, MSG_DONTWAIT) >= 0 || errno != EAGAIN) {
+      skip("sock_recvfrom (empty)", "socket unexpectedly had data");
+      goto done;
+    }
+  }
+  report("sock_recvfrom (empty)", 0, now_ns() - start);
+
+ done:
+  close(sock);
+}
+
+static void bench_echo(const struct sockaddr_in* sin) {
+  int sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock < 0 ||
+      connect(sock, (const struct sockaddr*)sin, sizeof(*sin)) < 0) {
+    skip("sock_sendto+recvfrom", strerror(errno));
+    if (sock >= 0) {
+      close(sock);
+    }
+    return;
+  }
+
+  for (size_t s = 0; s < NUM_SIZES; ++s) {
+    uint64_t start = now_ns();
+    for (unsigned long i = 0; i < iterations; ++i) {
+      if (send(sock, buf, kSizes[s], 0) < 0) {
+        skip("sock_sendto+recvfrom", strerror(errno));
+        goto done;
+      }
+      for (size_t got = 0; got < kSizes[s];) {
+        ssize_t ret = recv(sock, buf, kSizes[s] - got, 0);
+        if (ret <= 0) {
+          skip("sock_sendto+recvfrom", ret ? strerror(errno) : "EOF");
+          goto done;
+        }
+        got += ret;
+      }
+    }
+    report("sock_sendto+recvfrom", kSizes[s], now_ns() - start);
+  }
+
+ done:
+  close(sock);
+}
+
+#endif
+
+int main(int argc, char* argv[]) {
+  const char* udp_target = "127.0.0.1:9";
+  const char* echo_target = NULL;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:u:e:")) != -1) {
+    switch (opt) {
+      case 'n':
+        iterations = strtoul(optarg, NULL, 0);
+        break;
+      case 'u':
+        udp_target = optarg;
+        break;
+      case 'e':
+        echo_target = optarg;
+        break;
+      default:
+        fprintf(stderr,
+                "Usage: %s [-n iterations] [-u host:port] [-e host:port]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  if (iterations == 0) {
+    fprintf(stderr, "iterations must be positive\n");
+    return 1;
+  }
+
+  memset(buf, 'x', sizeof(buf));
+
+  bench_clock_gettime();
+  bench_poll();
+  bench_write();
+
+#ifdef WASI_ONLY
+  (void)udp_target;
+  (void)echo_target;
+#else
+  bench_dup();
+  bench_tty_get_window_size();
+
+  struct sockaddr_in sin;
+  if (parse_addr(udp_target, &sin) == 0) {
+    bench_udp(&sin);
+  } else {
+    skip("sock_sendto", "bad -u address");
+  }
+
+  if (!echo_target) {
+    skip("sock_sendto+recvfrom", "no -e echo server");
+  } else if (parse_addr(echo_target, &sin) == 0) {
+    bench_echo(&sin);
+  } else {
+    skip("sock_sendto+recvfrom", "bad -e address");
+  }
+#endif
+
+  return 0;
+}
@@ -0,0 +1,33 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// https://pubs.opengroup.org/onlinepubs/9799919799/basedefs/fcntl.h.html
+
+#ifndef WASSH_FCNTL_H
+#define WASSH_FCNTL_H
+
+// clang-format off
+#include_next <fcntl.h>
+// clang-format on
+
+#include <sys/cdefs.h>
+#include <sys/types.h>
+
+__BEGIN_DECLS
+
+// Linux splice() API.  Offsets are not supported.
+#define SPLICE_F_MOVE 0x1
+#define SPLICE_F_NONBLOCK 0x2
+#define SPLICE_F_MORE 0x4
+
+ssize_t splice(int fd_in,
+               off_t* off_in,
+               int fd_out,
+               off_t* off_out,
+               size_t len,
+               unsigned int flags);
+
+__END_DECLS
+
+#endif
@@ -35,6 +35,10 @@ __BEGIN_DECLS
 typedef void (*sighandler_t)(int);
 sighandler_t signal(int signum, sighandler_t handler);
 
+// Route signal() through us so we can track handlers for fast delivery.
+sighandler_t wassh_signal(int signum, sighandler_t handler);
+#define signal(signum, handler) wassh_signal(signum, handler)
+
 union sigval {
   int sival_int;
   void* sival_ptr;
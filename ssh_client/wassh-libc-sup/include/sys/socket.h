@@ -18,8 +18,28 @@ __BEGIN_DECLS
 // These are the same defines that sys/socket.h has disabled.
 #define SO_REUSEADDR 2
 #define SO_ERROR 4
+#define SO_SNDBUF 7
+#define SO_RCVBUF 8
 #define SO_KEEPALIVE 9
 
+// wassh-specific option to pick how the runtime queues a socket's data.
+// IP_TOS & IPV6_TCLASS also pick these based on OpenSSH's IPQoS values.
+#define SO_WASSH_PROFILE 0x5700
+#define WASSH_SOCK_PROFILE_DEFAULT 0
+// Keep writes small & send them right away.  For keystrokes.
+#define WASSH_SOCK_PROFILE_INTERACTIVE 1
+// Favor throughput.  For scp/sftp.
+#define WASSH_SOCK_PROFILE_BULK 2
+
+// wassh-specific option to pick which packets a datagram socket drops when its
+// receive queue (SO_RCVBUF) is full.
+#define SO_WASSH_DROP_POLICY 0x5701
+// Drop queued packets to make room.  For protocols that only care about the
+// latest state (e.g. mosh).
+#define WASSH_SOCK_DROP_OLDEST 0
+// Drop new packets like Linux does.
+#define WASSH_SOCK_DROP_NEWEST 1
+
 #define PF_UNSPEC 0
 #define PF_LOCAL 1
 #define PF_UNIX PF_LOCAL
@@ -0,0 +1,36 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Hooks into the allocator in libwassh-malloc.a.  Only available when linked
+// with -lwassh-malloc.
+
+#ifndef WASSH_MALLOC_H
+#define WASSH_MALLOC_H
+
+#include <stddef.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+struct wassh_malloc_stats {
+  // Bytes of WASM memory owned by the allocator.
+  size_t heap_size;
+  // Bytes currently handed out (rounded up to the size class).
+  size_t in_use;
+  // High water mark of |in_use|.
+  size_t peak_in_use;
+  // Number of successful malloc() & free() calls.
+  size_t nmalloc;
+  size_t nfree;
+};
+
+// Fill |stats| with the current allocator statistics.
+void wassh_malloc_get_stats(struct wassh_malloc_stats* stats);
+
+// Print the allocator statistics to stderr.  Same API as glibc.
+void malloc_stats(void);
+
+__END_DECLS
+
+#endif
@@ -56,6 +56,86 @@ __wasi_fd_t fd_dup2(__wasi_fd_t oldfd, __wasi_fd_t newfd) {
   return newfd;
 }
 
+SYSCALL(fd_pipe)(__wasi_filetype_t filetype, __wasi_fd_t* fds);
+int fd_pipe(__wasi_filetype_t filetype, __wasi_fd_t fds[2]) {
+  __wasi_errno_t error = __wassh_fd_pipe(filetype, fds);
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+  return 0;
+}
+
+SYSCALL(fd_pipe_notify)(void);
+int fd_pipe_notify(void) {
+  __wasi_errno_t error = __wassh_fd_pipe_notify();
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+  return 0;
+}
+
+SYSCALL(fd_epoll_create)(__wasi_fd_t* epfd);
+int fd_epoll_create(void) {
+  __wasi_fd_t ret;
+  __wasi_errno_t error = __wassh_fd_epoll_create(&ret);
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+  return ret;
+}
+
+SYSCALL(fd_epoll_ctl)(
+    __wasi_fd_t epfd, int op, __wasi_fd_t fd, uint32_t events, uint64_t data);
+int fd_epoll_ctl(
+    __wasi_fd_t epfd, int op, __wasi_fd_t fd, uint32_t events, uint64_t data) {
+  __wasi_errno_t error = __wassh_fd_epoll_ctl(epfd, op, fd, events, data);
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+  return 0;
+}
+
+SYSCALL(fd_epoll_wait)(__wasi_fd_t epfd,
+                       struct epoll_event* events,
+                       int maxevents,
+                       int64_t timeout,
+                       __wasi_size_t* nready);
+int fd_epoll_wait(__wasi_fd_t epfd,
+                  struct epoll_event* events,
+                  int maxevents,
+                  int64_t timeout,
+                  size_t* nready) {
+  __wasi_errno_t error =
+      __wassh_fd_epoll_wait(epfd, events, maxevents, timeout, nready);
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+  return 0;
+}
+
+SYSCALL(fd_splice)(__wasi_fd_t fd_in,
+                   __wasi_fd_t fd_out,
+                   __wasi_size_t len,
+                   uint32_t flags,
+                   __wasi_size_t* nspliced);
+int fd_splice(__wasi_fd_t fd_in,
+              __wasi_fd_t fd_out,
+              size_t len,
+              unsigned int flags,
+              size_t* nspliced) {
+  __wasi_errno_t error = __wassh_fd_splice(fd_in, fd_out, len, flags, nspliced);
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+  return 0;
+}
+
 SYSCALL(readpassphrase)(const char* prompt,
                         __wasi_size_t prompt_len,
                         char* buf,
@@ -228,6 +308,16 @@ int sock_sendto(__wasi_fd_t sock,
   return 0;
 }
 
+SYSCALL(signal_register)(uint64_t* pending);
+int signal_register(uint64_t* pending) {
+  __wasi_errno_t error = __wassh_signal_register(pending);
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+  return 0;
+}
+
 SYSCALL(tty_get_window_size)(__wasi_fd_t fd, struct winsize* winsize);
 int tty_get_window_size(__wasi_fd_t fd, struct winsize* winsize) {
   __wasi_errno_t error = __wassh_tty_get_window_size(fd, winsize);
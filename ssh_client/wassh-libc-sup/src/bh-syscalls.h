@@ -19,6 +19,7 @@
 
 __BEGIN_DECLS
 
+struct epoll_event;
 struct winsize;
 
 int sock_accept(__wasi_fd_t sock, __wasi_fd_t* newsock);
@@ -52,6 +53,22 @@ int sock_sendto(__wasi_fd_t sock,
                 uint16_t port);
 __wasi_fd_t fd_dup(__wasi_fd_t oldfd);
 __wasi_fd_t fd_dup2(__wasi_fd_t oldfd, __wasi_fd_t newfd);
+int fd_pipe(__wasi_filetype_t filetype, __wasi_fd_t fds[2]);
+int fd_pipe_notify(void);
+int fd_epoll_create(void);
+int fd_epoll_ctl(
+    __wasi_fd_t epfd, int op, __wasi_fd_t fd, uint32_t events, uint64_t data);
+int fd_epoll_wait(__wasi_fd_t epfd,
+                  struct epoll_event* events,
+                  int maxevents,
+                  int64_t timeout,
+                  size_t* nready);
+int fd_splice(__wasi_fd_t fd_in,
+              __wasi_fd_t fd_out,
+              size_t len,
+              unsigned int flags,
+              size_t* nspliced);
+int signal_register(uint64_t* pending);
 int tty_get_window_size(__wasi_fd_t fd, struct winsize* winsize);
 int tty_set_window_size(__wasi_fd_t fd, const struct winsize* winsize);
 char* wassh_readpassphrase(const char* prompt,
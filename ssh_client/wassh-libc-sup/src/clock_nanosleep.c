@@ -0,0 +1,73 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Implementation for clock_nanosleep().
+//
+// This is the same as wasi-libc except signals that interrupt the sleep have
+// their handlers run before we return EINTR.  wasi-libc implements nanosleep(),
+// sleep(), & usleep() on top of this, so they all pick it up.
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <wasi/api.h>
+
+#include "signal-internal.h"
+
+int clock_nanosleep(clockid_t clock_id,
+                    int flags,
+                    const struct timespec* rqtp,
+                    struct timespec* rmtp) {
+  __wasi_clockid_t id;
+  if (clock_id == CLOCK_REALTIME) {
+    id = __WASI_CLOCKID_REALTIME;
+  } else if (clock_id == CLOCK_MONOTONIC) {
+    id = __WASI_CLOCKID_MONOTONIC;
+  } else {
+    return ENOTSUP;
+  }
+
+  if ((flags & ~TIMER_ABSTIME) != 0 || rqtp->tv_sec < 0 ||
+      rqtp->tv_nsec < 0 || rqtp->tv_nsec >= 1000000000) {
+    return EINVAL;
+  }
+
+  // Clamp absurdly long sleeps rather than overflow.
+  __wasi_timestamp_t timeout = UINT64_MAX;
+  if ((uint64_t)rqtp->tv_sec < UINT64_MAX / 1000000000 - 1) {
+    timeout = (__wasi_timestamp_t)rqtp->tv_sec * 1000000000 + rqtp->tv_nsec;
+  }
+
+  // Remember when we started so we can report how much time is left.
+  bool relative = !(flags & TIMER_ABSTIME);
+  __wasi_timestamp_t start = 0;
+  if (relative && rmtp) {
+    __wasi_clock_time_get(id, 1, &start);
+  }
+
+  const __wasi_subscription_t subscription = {
+      .u.tag = __WASI_EVENTTYPE_CLOCK,
+      .u.u.clock.id = id,
+      .u.u.clock.timeout = timeout,
+      .u.u.clock.flags =
+          relative ? 0 : __WASI_SUBCLOCKFLAGS_SUBSCRIPTION_CLOCK_ABSTIME,
+  };
+  __wasi_event_t event;
+  size_t nevents;
+  __wasi_errno_t error = signal_poll_oneoff(&subscription, &event, 1, &nevents);
+  if (error == __WASI_ERRNO_INTR && relative && rmtp) {
+    __wasi_timestamp_t now = start;
+    __wasi_clock_time_get(id, 1, &now);
+    __wasi_timestamp_t elapsed = now - start;
+    __wasi_timestamp_t left = timeout > elapsed ? timeout - elapsed : 0;
+    rmtp->tv_sec = left / 1000000000;
+    rmtp->tv_nsec = left % 1000000000;
+  }
+  if (error != 0) {
+    return error;
+  }
+  return event.error;
+}
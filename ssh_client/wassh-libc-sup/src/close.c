@@ -0,0 +1,35 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Implementation for close().
+
+#include <errno.h>
+#include <unistd.h>
+
+#include <wasi/api.h>
+#include <wasi/libc.h>
+
+#include "debug.h"
+#include "epoll-internal.h"
+#include "pipe.h"
+
+int close(int fd) {
+  _ENTER("fd=%i", fd);
+
+  // Make sure preopens have processed before we close any fds, otherwise the
+  // preopen scan will get confused by the hole in the fd table.
+  __wasilibc_populate_preopens();
+
+  epoll_close(fd);
+  pipe_close(fd);
+
+  int ret = 0;
+  __wasi_errno_t error = __wasi_fd_close(fd);
+  if (error != 0) {
+    errno = error;
+    ret = -1;
+  }
+  _EXIT_ERRNO(ret, "");
+  return ret;
+}
@@ -9,10 +9,14 @@
 
 #include "bh-syscalls.h"
 #include "debug.h"
+#include "pipe.h"
 
 int dup(int oldfd) {
   _ENTER("oldfd=%i", oldfd);
   int ret = fd_dup(oldfd);
+  if (ret >= 0) {
+    pipe_dup(oldfd, ret);
+  }
   _EXIT("ret = %i", ret);
   return ret;
 }
@@ -9,10 +9,14 @@
 
 #include "bh-syscalls.h"
 #include "debug.h"
+#include "pipe.h"
 
 int dup2(int oldfd, int newfd) {
   _ENTER("oldfd=%i newfd=%i", oldfd, newfd);
   int ret = fd_dup2(oldfd, newfd);
+  if (ret >= 0) {
+    pipe_dup(oldfd, newfd);
+  }
   _EXIT("ret = %i", ret);
   return ret;
 }
@@ -0,0 +1,20 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Internal APIs for the epoll() implementation.
+
+#ifndef _WASSH_EPOLL_INTERNAL_H
+#define _WASSH_EPOLL_INTERNAL_H
+
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+// Drop any pipe interests that refer to |fd| (either as the epoll fd, or as a
+// watched fd).  The runtime takes care of all other fds itself.
+void epoll_close(int fd);
+
+__END_DECLS
+
+#endif
@@ -0,0 +1,293 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Implementation for the epoll() family.
+//
+// The runtime keeps the interest set for each epoll fd, and only reports the
+// fds that are ready, so waiting scales with activity rather than with the
+// number of fds like poll() does.  Pipes live in WASM memory, so we track their
+// interests here instead, and check their rings directly.
+
+#include <errno.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+
+#include "bh-syscalls.h"
+#include "debug.h"
+#include "epoll-internal.h"
+#include "pipe.h"
+#include "poll-internal.h"
+#include "signal-internal.h"
+
+// The events we know how to report.
+#define EPOLL_SUPPORTED                                                   \
+  (EPOLLIN | EPOLLOUT | EPOLLRDNORM | EPOLLWRNORM | EPOLLRDHUP | EPOLLERR | \
+   EPOLLHUP)
+
+// Max number of pipe fds that can be watched across all epoll fds.
+#define EPOLL_MAX_PIPES 64
+
+struct epoll_pipe {
+  bool used;
+  int epfd;
+  int fd;
+  uint32_t events;
+  epoll_data_t data;
+};
+
+static struct epoll_pipe epoll_pipes[EPOLL_MAX_PIPES];
+static atomic_flag epoll_pipes_lock = ATOMIC_FLAG_INIT;
+
+static void epoll_pipes_acquire(void) {
+  while (atomic_flag_test_and_set_explicit(&epoll_pipes_lock,
+                                           memory_order_acquire)) {
+  }
+}
+
+static void epoll_pipes_release(void) {
+  atomic_flag_clear_explicit(&epoll_pipes_lock, memory_order_release);
+}
+
+// Find the pipe interest for |fd| in |epfd|.  Must hold the lock.
+static struct epoll_pipe* epoll_pipe_find(int epfd, int fd) {
+  for (size_t i = 0; i < EPOLL_MAX_PIPES; ++i) {
+    struct epoll_pipe* p = &epoll_pipes[i];
+    if (p->used && p->epfd == epfd && p->fd == fd) {
+      return p;
+    }
+  }
+  return NULL;
+}
+
+static int epoll_ctl_pipe(int epfd,
+                          int op,
+                          int fd,
+                          const struct epoll_event* event) {
+  int ret = -1;
+  epoll_pipes_acquire();
+
+  struct epoll_pipe* p = epoll_pipe_find(epfd, fd);
+  switch (op) {
+    case EPOLL_CTL_ADD:
+      if (p) {
+        errno = EEXIST;
+        goto done;
+      }
+      for (size_t i = 0; i < EPOLL_MAX_PIPES; ++i) {
+        if (!epoll_pipes[i].used) {
+          p = &epoll_pipes[i];
+          break;
+        }
+      }
+      if (!p) {
+        errno = ENOMEM;
+        goto done;
+      }
+      p->used = true;
+      p->epfd = epfd;
+      p->fd = fd;
+      // Fallthrough.
+    case EPOLL_CTL_MOD:
+      if (!p) {
+        errno = ENOENT;
+        goto done;
+      }
+      p->events = event->events;
+      p->data = event->data;
+      break;
+
+    case EPOLL_CTL_DEL:
+      if (!p) {
+        errno = ENOENT;
+        goto done;
+      }
+      p->used = false;
+      break;
+
+    default:
+      errno = EINVAL;
+      goto done;
+  }
+  ret = 0;
+
+done:
+  epoll_pipes_release();
+  return ret;
+}
+
+// Fill |events| with any ready pipes in |epfd|, and return how many there are.
+static int epoll_wait_pipes(int epfd,
+                            struct epoll_event* events,
+                            int maxevents) {
+  int ret = 0;
+
+  epoll_pipes_acquire();
+  for (size_t i = 0; i < EPOLL_MAX_PIPES && ret < maxevents; ++i) {
+    struct epoll_pipe* p = &epoll_pipes[i];
+    if (!p->used || p->epfd != epfd) {
+      continue;
+    }
+
+    struct pipe_end* end = pipe_lookup(p->fd);
+    if (!end) {
+      continue;
+    }
+
+    short pevents = 0;
+    if (p->events & (EPOLLIN | EPOLLRDNORM)) {
+      pevents |= POLLRDNORM;
+    }
+    if (p->events & (EPOLLOUT | EPOLLWRNORM)) {
+      pevents |= POLLWRNORM;
+    }
+    short revents = pipe_poll(end, pevents);
+
+    uint32_t epevents = 0;
+    if (revents & POLLRDNORM) {
+      epevents |= p->events & (EPOLLIN | EPOLLRDNORM);
+    }
+    if (revents & POLLWRNORM) {
+      epevents |= p->events & (EPOLLOUT | EPOLLWRNORM);
+    }
+    if (revents & POLLHUP) {
+      epevents |= EPOLLHUP | (p->events & EPOLLRDHUP);
+    }
+    if (revents & POLLERR) {
+      epevents |= EPOLLERR;
+    }
+    if (epevents) {
+      events[ret].events = epevents;
+      events[ret].data = p->data;
+      ++ret;
+    }
+  }
+  epoll_pipes_release();
+
+  return ret;
+}
+
+void epoll_close(int fd) {
+  epoll_pipes_acquire();
+  for (size_t i = 0; i < EPOLL_MAX_PIPES; ++i) {
+    struct epoll_pipe* p = &epoll_pipes[i];
+    if (p->used && (p->epfd == fd || p->fd == fd)) {
+      p->used = false;
+    }
+  }
+  epoll_pipes_release();
+}
+
+int epoll_create1(int flags) {
+  _ENTER("flags=%#x", flags);
+  int ret = -1;
+  if (flags & ~EPOLL_CLOEXEC) {
+    errno = EINVAL;
+  } else {
+    ret = fd_epoll_create();
+  }
+  _EXIT_ERRNO(ret, "");
+  return ret;
+}
+
+int epoll_create(int size) {
+  if (size <= 0) {
+    errno = EINVAL;
+    return -1;
+  }
+  return epoll_create1(0);
+}
+
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event* event) {
+  _ENTER("epfd=%i op=%i fd=%i event=%p", epfd, op, fd, event);
+  int ret = -1;
+
+  if (op != EPOLL_CTL_DEL) {
+    if (event == NULL) {
+      errno = EFAULT;
+      goto done;
+    }
+    if (event->events & ~EPOLL_SUPPORTED) {
+      errno = EINVAL;
+      goto done;
+    }
+  }
+  if (epfd == fd) {
+    errno = EINVAL;
+    goto done;
+  }
+
+  if (pipe_lookup(fd)) {
+    ret = epoll_ctl_pipe(epfd, op, fd, event);
+  } else {
+    ret = fd_epoll_ctl(epfd, op, fd, event ? event->events : 0,
+                       event ? event->data.u64 : 0);
+  }
+
+done:
+  _EXIT_ERRNO(ret, "");
+  return ret;
+}
+
+// Same as epoll_wait(), but |timeout| is in nanoseconds.
+static int epoll_wait_ns(int epfd,
+                         struct epoll_event* events,
+                         int maxevents,
+                         int64_t timeout) {
+  if (maxevents <= 0) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  signal_dispatch_pending();
+
+  int64_t deadline = poll_deadline(timeout);
+  while (1) {
+    // Register before checking the rings so no change is missed.  The runtime
+    // ends the wait early if a pipe changes.
+    pipe_poll_begin();
+    int ready = epoll_wait_pipes(epfd, events, maxevents);
+
+    // If a pipe is already ready, only check the other fds without blocking.
+    int64_t wait = ready ? 0 : poll_remaining(deadline);
+
+    size_t nready = 0;
+    int ret = 0;
+    if (ready < maxevents) {
+      ret = fd_epoll_wait(epfd, events + ready, maxevents - ready, wait,
+                          &nready);
+      // The runtime queues signals while we're waiting.
+      signal_dispatch_pending();
+    }
+    pipe_poll_end();
+    if (ret < 0) {
+      return ready ? ready : ret;
+    }
+
+    int total = ready + nready;
+    if (total || wait == 0) {
+      return total;
+    }
+    // A pipe changed (or the timeout is up), so check everything again.
+  }
+}
+
+int epoll_wait(int epfd,
+               struct epoll_event* events,
+               int maxevents,
+               int timeout) {
+  return epoll_wait_ns(epfd, events, maxevents,
+                       timeout < 0 ? -1 : (int64_t)timeout * 1000000);
+}
+
+int epoll_pwait(int epfd,
+                struct epoll_event* events,
+                int maxevents,
+                int timeout,
+                const sigset_t* sigmask) {
+  (void)sigmask;
+  return epoll_wait(epfd, events, maxevents, timeout);
+}
@@ -6,11 +6,63 @@
 // FIONREAD & FIONBIO, it errors out for all others.  We need others.
 
 #include <errno.h>
+#include <limits.h>
 #include <stdarg.h>
 #include <sys/ioctl.h>
 
+#include <wasi/api.h>
+
 #include "bh-syscalls.h"
 #include "debug.h"
+#include "pipe.h"
+#include "signal-internal.h"
+
+// Get the number of bytes available to read.
+//
+// The runtime reports this in the poll results, so do a quick poll like
+// wasi-libc does.
+static int fd_nread(int fd, int* nread) {
+  struct pipe_end* end = pipe_lookup(fd);
+  if (end) {
+    *nread = pipe_nread(end);
+    return 0;
+  }
+
+  const __wasi_subscription_t subscriptions[2] = {
+      {
+          .userdata = 0,
+          .u.tag = __WASI_EVENTTYPE_FD_READ,
+          .u.u.fd_read.file_descriptor = fd,
+      },
+      {
+          .userdata = 1,
+          .u.tag = __WASI_EVENTTYPE_CLOCK,
+          .u.u.clock.id = __WASI_CLOCKID_MONOTONIC,
+      },
+  };
+  __wasi_event_t events[2];
+  size_t nevents;
+  __wasi_errno_t error =
+      signal_poll_oneoff(subscriptions, events, 2, &nevents);
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+
+  *nread = 0;
+  for (size_t i = 0; i < nevents; ++i) {
+    if (events[i].userdata != 0) {
+      continue;
+    }
+    if (events[i].error != 0) {
+      errno = events[i].error;
+      return -1;
+    }
+    __wasi_filesize_t nbytes = events[i].fd_readwrite.nbytes;
+    *nread = nbytes > INT_MAX ? INT_MAX : nbytes;
+  }
+  return 0;
+}
 
 int ioctl(int fd, int request, ...) {
   _ENTER("fd=%i request=%#x", fd, request);
@@ -19,6 +71,16 @@ int ioctl(int fd, int request, ...) {
   va_start(ap, request);
 
   switch (request) {
+    case FIONREAD: {
+      // Get number of bytes available to read.
+      int* nread = va_arg(ap, int*);
+      ret = fd_nread(fd, nread);
+      if (ret == 0) {
+        _MID("FIONREAD: nread=%i", *nread);
+      }
+      break;
+    }
+
     case TIOCGWINSZ: {
       // Get terminal window size.
       struct winsize* ws = va_arg(ap, struct winsize*);
@@ -0,0 +1,615 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Size-class allocator tuned for OpenSSH.
+//
+// This replaces wasi-libc's dlmalloc when libwassh-malloc.a is linked in.
+// OpenSSH churns through lots of short-lived buffers of a handful of sizes, and
+// WASM memory can never shrink, so we want freed blocks to be reused for the
+// same sizes rather than fragmenting the heap.
+//
+// There are three tiers:
+// * Small (<= SMALL_MAX): Carved out of 64 KiB spans (the WASM page size) that
+//   hold blocks of a single size class.  Spans are page aligned pieces of the
+//   bump arena.  There is no per-block header: a bitmap of span pages tells
+//   free() that the pointer is small, and the span header (found by masking the
+//   pointer) holds the size class.
+// * Medium (<= MEDIUM_MAX): Carved out of the bump arena with a block header.
+//   Freed blocks are only reused for the same size class.
+// * Large: Carved out of the bump arena with a block header.  Freed blocks go
+//   on a best-fit free list, and are split when reused for smaller requests.
+//
+// Small & medium blocks are cached per-thread in front of the shared per-class
+// free lists, so the common case doesn't need the global lock.
+//
+// NB: Don't use the debug helpers here as they might allocate.
+
+#include <errno.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wassh-malloc.h"
+
+#define PAGE_SIZE 65536
+#define PAGE_SHIFT 16
+#define MAX_PAGES (UINT32_MAX / PAGE_SIZE + 1)
+
+// All blocks are aligned to this.
+#define ALIGNMENT 16
+#define ALIGN_UP(x, a) (((x) + (a) - 1) & ~((uintptr_t)(a) - 1))
+
+// The tier boundaries.
+#define SMALL_MAX 1024
+#define MEDIUM_MAX (256 * 1024)
+
+// How many pages to grow the arena by at a time.
+#define ARENA_GROW_PAGES 16
+
+// Max blocks to cache per thread per size class.
+#define TCACHE_SMALL_MAX 64
+#define TCACHE_MEDIUM_MAX 8
+
+// Magic values to catch invalid pointers.
+#define SPAN_MAGIC 0x5350414eU    // "SPAN"
+#define BLOCK_MAGIC 0x424c4b21U   // "BLK!"
+#define ALIGNED_MAGIC 0x414c4e21U  // "ALN!"
+
+// Classes are 16-byte steps up to 128 bytes, then four steps per doubling.
+static const uint32_t class_sizes[] = {
+    16,     32,     48,     64,     80,     96,     112,    128,    160,
+    192,    224,    256,    320,    384,    448,    512,    640,    768,
+    896,    1024,   1280,   1536,   1792,   2048,   2560,   3072,   3584,
+    4096,   5120,   6144,   7168,   8192,   10240,  12288,  14336,  16384,
+    20480,  24576,  28672,  32768,  40960,  49152,  57344,  65536,  81920,
+    98304,  114688, 131072, 163840, 196608, 229376, 262144,
+};
+#define NUM_CLASSES (sizeof(class_sizes) / sizeof(*class_sizes))
+#define SMALL_CLASSES 20
+#define LARGE_CLASS UINT32_MAX
+
+_Static_assert(SMALL_MAX == 1024, "SMALL_CLASSES needs updating");
+_Static_assert(MEDIUM_MAX == 262144, "class_sizes needs updating");
+
+// Header at the start of every small span.
+struct span {
+  uint32_t magic;
+  uint32_t size_class;
+  uint32_t reserved[2];
+};
+
+// Header before every medium & large block.
+struct block {
+  uint32_t magic;
+  // Class index, or LARGE_CLASS.  For ALIGNED_MAGIC, unused.
+  uint32_t size_class;
+  // Usable size (not including this header).  For ALIGNED_MAGIC, the offset
+  // back to the real block.
+  uint32_t size;
+  uint32_t reserved;
+};
+
+_Static_assert(sizeof(struct span) == ALIGNMENT, "span header misaligned");
+_Static_assert(sizeof(struct block) == ALIGNMENT, "block header misaligned");
+
+// Singly linked list of free small & medium blocks.
+struct free_block {
+  struct free_block* next;
+};
+
+// Singly linked list of free large blocks.  This lives after the block header.
+struct free_large {
+  struct free_large* next;
+};
+
+// Per-thread cache of free blocks.
+struct tcache {
+  struct free_block* head[NUM_CLASSES];
+  uint16_t count[NUM_CLASSES];
+};
+static _Thread_local struct tcache tcache;
+
+// State shared by all threads.  Everything here is protected by heap_lock.
+static atomic_flag heap_lock = ATOMIC_FLAG_INIT;
+static struct free_block* free_lists[NUM_CLASSES];
+static struct free_large* free_large;
+static uintptr_t arena_cur;
+static uintptr_t arena_end;
+static bool heap_initialized;
+
+// Bitmap of pages that hold small spans.
+static _Atomic uint32_t span_pages[MAX_PAGES / 32];
+
+// Statistics.
+static _Atomic size_t stat_heap_size;
+static _Atomic size_t stat_in_use;
+static _Atomic size_t stat_peak_in_use;
+static _Atomic size_t stat_nmalloc;
+static _Atomic size_t stat_nfree;
+
+static void heap_acquire(void) {
+  while (atomic_flag_test_and_set_explicit(&heap_lock, memory_order_acquire)) {
+  }
+}
+
+static void heap_release(void) {
+  atomic_flag_clear_explicit(&heap_lock, memory_order_release);
+}
+
+static void stats_alloc(size_t size) {
+  atomic_fetch_add_explicit(&stat_nmalloc, 1, memory_order_relaxed);
+  size_t in_use =
+      atomic_fetch_add_explicit(&stat_in_use, size, memory_order_relaxed) +
+      size;
+  size_t peak = atomic_load_explicit(&stat_peak_in_use, memory_order_relaxed);
+  while (in_use > peak &&
+         !atomic_compare_exchange_weak_explicit(&stat_peak_in_use, &peak,
+                                                in_use, memory_order_relaxed,
+                                                memory_order_relaxed)) {
+  }
+}
+
+static void stats_free(size_t size) {
+  atomic_fetch_add_explicit(&stat_nfree, 1, memory_order_relaxed);
+  atomic_fetch_sub_explicit(&stat_in_use, size, memory_order_relaxed);
+}
+
+// Grow WASM memory by |npages| and return the start of the new memory.
+static uintptr_t grow_pages(size_t npages) {
+  size_t old = __builtin_wasm_memory_grow(0, npages);
+  if (old == SIZE_MAX) {
+    return 0;
+  }
+  atomic_fetch_add_explicit(&stat_heap_size, npages * PAGE_SIZE,
+                            memory_order_relaxed);
+  return old * PAGE_SIZE;
+}
+
+// Use the memory the linker left after static data first.  Must hold the lock.
+static void heap_init(void) {
+  extern unsigned char __heap_base;
+  heap_initialized = true;
+  arena_cur = ALIGN_UP((uintptr_t)&__heap_base, ALIGNMENT);
+  arena_end = __builtin_wasm_memory_size(0) * PAGE_SIZE;
+  if (arena_cur > arena_end) {
+    arena_cur = arena_end;
+  }
+  atomic_fetch_add_explicit(&stat_heap_size, arena_end - arena_cur,
+                            memory_order_relaxed);
+}
+
+// Map a request size to a size class.
+static uint32_t size_to_class(size_t size) {
+  if (size <= 128) {
+    return size ? (size - 1) / 16 : 0;
+  }
+  // Binary search the rest.
+  uint32_t lo = 8, hi = NUM_CLASSES - 1;
+  while (lo < hi) {
+    uint32_t mid = (lo + hi) / 2;
+    if (class_sizes[mid] < size) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// Put the unused memory in [start, end) on the free lists so it isn't lost.
+// Must hold the lock.
+static void arena_retire(uintptr_t start, uintptr_t end) {
+  while (end - start >= sizeof(struct block) + class_sizes[SMALL_CLASSES]) {
+    struct block* b = (void*)start;
+    b->magic = BLOCK_MAGIC;
+    size_t avail = end - start - sizeof(*b);
+
+    // Anything too big for a medium class can serve large requests as is.
+    if (avail > MEDIUM_MAX) {
+      b->size_class = LARGE_CLASS;
+      b->size = avail;
+      struct free_large* fl = (void*)(b + 1);
+      fl->next = free_large;
+      free_large = fl;
+      return;
+    }
+
+    // Otherwise carve out the biggest medium block that fits.
+    uint32_t cls = size_to_class(avail);
+    if (class_sizes[cls] > avail) {
+      --cls;
+    }
+    b->size_class = cls;
+    b->size = class_sizes[cls];
+    struct free_block* fb = (void*)(b + 1);
+    fb->next = free_lists[cls];
+    free_lists[cls] = fb;
+    start += sizeof(*b) + b->size;
+  }
+}
+
+// Carve |size| bytes aligned to |align| (at most PAGE_SIZE) out of the bump
+// arena.  Must hold the lock.
+static void* arena_alloc(size_t size, size_t align) {
+  if (!heap_initialized) {
+    heap_init();
+  }
+
+  // The arena always ends on a page boundary, so this never passes the end.
+  uintptr_t ret = ALIGN_UP(arena_cur, align);
+  if (arena_end - ret < size) {
+    size_t npages = ALIGN_UP(size, PAGE_SIZE) / PAGE_SIZE;
+    if (npages < ARENA_GROW_PAGES) {
+      npages = ARENA_GROW_PAGES;
+    }
+    uintptr_t mem = grow_pages(npages);
+    if (mem == 0) {
+      return NULL;
+    }
+    // Keep using the old arena if the new memory is right after it.  Otherwise
+    // someone else grew memory, so save what's left of the old arena.
+    if (mem != arena_end) {
+      arena_retire(arena_cur, arena_end);
+      arena_cur = mem;
+    }
+    arena_end = mem + npages * PAGE_SIZE;
+    ret = ALIGN_UP(arena_cur, align);
+  }
+
+  // Save the padding we skipped over to align.
+  arena_retire(arena_cur, ret);
+  arena_cur = ret + size;
+  return (void*)ret;
+}
+
+static bool is_span_page(const void* ptr) {
+  uintptr_t page = (uintptr_t)ptr >> PAGE_SHIFT;
+  return atomic_load_explicit(&span_pages[page / 32], memory_order_relaxed) &
+         (1U << (page % 32));
+}
+
+// Carve a new span for |cls| and put all its blocks on the free list.  Must
+// hold the lock.
+static bool span_new(uint32_t cls) {
+  // Spans have to be page aligned so free() can find the header.  Carve them
+  // out of the arena so it stays contiguous as both grow.
+  uintptr_t mem = (uintptr_t)arena_alloc(PAGE_SIZE, PAGE_SIZE);
+  if (mem == 0) {
+    return false;
+  }
+
+  struct span* span = (void*)mem;
+  span->magic = SPAN_MAGIC;
+  span->size_class = cls;
+
+  uintptr_t page = mem >> PAGE_SHIFT;
+  atomic_fetch_or_explicit(&span_pages[page / 32], 1U << (page % 32),
+                           memory_order_relaxed);
+
+  const uint32_t size = class_sizes[cls];
+  uintptr_t p = mem + sizeof(*span);
+  uintptr_t end = mem + PAGE_SIZE;
+  for (; p + size <= end; p += size) {
+    struct free_block* fb = (void*)p;
+    fb->next = free_lists[cls];
+    free_lists[cls] = fb;
+  }
+  return true;
+}
+
+// Refill the thread cache for |cls| from the shared lists.
+static bool tcache_refill(uint32_t cls) {
+  const uint16_t batch =
+      (cls < SMALL_CLASSES ? TCACHE_SMALL_MAX : TCACHE_MEDIUM_MAX) / 2;
+
+  heap_acquire();
+  if (!free_lists[cls]) {
+    if (cls < SMALL_CLASSES) {
+      if (!span_new(cls)) {
+        heap_release();
+        return false;
+      }
+    } else {
+      struct block* b = arena_alloc(sizeof(*b) + class_sizes[cls], ALIGNMENT);
+      if (!b) {
+        heap_release();
+        return false;
+      }
+      b->magic = BLOCK_MAGIC;
+      b->size_class = cls;
+      b->size = class_sizes[cls];
+      struct free_block* fb = (void*)(b + 1);
+      fb->next = NULL;
+      free_lists[cls] = fb;
+    }
+  }
+
+  for (uint16_t i = 0; i < batch && free_lists[cls]; ++i) {
+    struct free_block* fb = free_lists[cls];
+    free_lists[cls] = fb->next;
+    fb->next = tcache.head[cls];
+    tcache.head[cls] = fb;
+    ++tcache.count[cls];
+  }
+  heap_release();
+  return true;
+}
+
+// Return half of the thread cache for |cls| to the shared lists.
+static void tcache_flush(uint32_t cls) {
+  uint16_t n = tcache.count[cls] / 2;
+  heap_acquire();
+  for (uint16_t i = 0; i < n; ++i) {
+    struct free_block* fb = tcache.head[cls];
+    tcache.head[cls] = fb->next;
+    fb->next = free_lists[cls];
+    free_lists[cls] = fb;
+  }
+  heap_release();
+  tcache.count[cls] -= n;
+}
+
+static void* class_alloc(uint32_t cls) {
+  if (!tcache.head[cls] && !tcache_refill(cls)) {
+    return NULL;
+  }
+  struct free_block* fb = tcache.head[cls];
+  tcache.head[cls] = fb->next;
+  --tcache.count[cls];
+  stats_alloc(class_sizes[cls]);
+  return fb;
+}
+
+static void class_free(void* ptr, uint32_t cls) {
+  struct free_block* fb = ptr;
+  fb->next = tcache.head[cls];
+  tcache.head[cls] = fb;
+  ++tcache.count[cls];
+  stats_free(class_sizes[cls]);
+
+  if (tcache.count[cls] >
+      (cls < SMALL_CLASSES ? TCACHE_SMALL_MAX : TCACHE_MEDIUM_MAX)) {
+    tcache_flush(cls);
+  }
+}
+
+static void* large_alloc(size_t size) {
+  size = ALIGN_UP(size, ALIGNMENT);
+  if (size > UINT32_MAX - PAGE_SIZE) {
+    return NULL;
+  }
+
+  heap_acquire();
+
+  // Find the best fitting free block.
+  struct free_large** best = NULL;
+  for (struct free_large** p = &free_large; *p; p = &(*p)->next) {
+    struct block* b = (struct block*)*p - 1;
+    if (b->size >= size &&
+        (!best || b->size < ((struct block*)*best - 1)->size)) {
+      best = p;
+      if (b->size == size) {
+        break;
+      }
+    }
+  }
+
+  struct block* b;
+  if (best) {
+    b = (struct block*)*best - 1;
+    *best = (*best)->next;
+
+    // Split off the tail if it's big enough to be worth reusing.
+    size_t rest = b->size - size;
+    if (rest >= sizeof(*b) + MEDIUM_MAX) {
+      struct block* tail = (void*)((uintptr_t)(b + 1) + size);
+      tail->magic = BLOCK_MAGIC;
+      tail->size_class = LARGE_CLASS;
+      tail->size = rest - sizeof(*tail);
+      struct free_large* fl = (void*)(tail + 1);
+      fl->next = free_large;
+      free_large = fl;
+      b->size = size;
+    }
+  } else {
+    b = arena_alloc(sizeof(*b) + size, ALIGNMENT);
+    if (b) {
+      b->magic = BLOCK_MAGIC;
+      b->size_class = LARGE_CLASS;
+      b->size = size;
+    }
+  }
+
+  heap_release();
+
+  if (!b) {
+    return NULL;
+  }
+  stats_alloc(b->size);
+  return b + 1;
+}
+
+static void large_free(struct block* b) {
+  stats_free(b->size);
+  struct free_large* fl = (void*)(b + 1);
+  heap_acquire();
+  fl->next = free_large;
+  free_large = fl;
+  heap_release();
+}
+
+// Look up the block header for |ptr|, or abort if it's invalid.
+static struct block* ptr_to_block(void* ptr) {
+  struct block* b = (struct block*)ptr - 1;
+  if (b->magic == ALIGNED_MAGIC) {
+    b = (struct block*)((uintptr_t)ptr - b->size) - 1;
+  }
+  if (b->magic != BLOCK_MAGIC) {
+    abort();
+  }
+  return b;
+}
+
+// How many bytes |ptr| can hold.
+static size_t usable_size(void* ptr) {
+  if (is_span_page(ptr)) {
+    struct span* span = (void*)((uintptr_t)ptr & ~(uintptr_t)(PAGE_SIZE - 1));
+    return class_sizes[span->size_class];
+  }
+
+  struct block* b = (struct block*)ptr - 1;
+  if (b->magic == ALIGNED_MAGIC) {
+    struct block* real = ptr_to_block(ptr);
+    return real->size - b->size;
+  }
+  return ptr_to_block(ptr)->size;
+}
+
+void* malloc(size_t size) {
+  void* ret;
+  if (size <= MEDIUM_MAX) {
+    ret = class_alloc(size_to_class(size));
+  } else {
+    ret = large_alloc(size);
+  }
+  if (!ret) {
+    errno = ENOMEM;
+  }
+  return ret;
+}
+
+void free(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+
+  if (is_span_page(ptr)) {
+    struct span* span = (void*)((uintptr_t)ptr & ~(uintptr_t)(PAGE_SIZE - 1));
+    if (span->magic != SPAN_MAGIC) {
+      abort();
+    }
+    class_free(ptr, span->size_class);
+    return;
+  }
+
+  struct block* b = ptr_to_block(ptr);
+  if (b->size_class == LARGE_CLASS) {
+    large_free(b);
+  } else {
+    class_free(b + 1, b->size_class);
+  }
+}
+
+void* calloc(size_t nmemb, size_t size) {
+  size_t total;
+  if (__builtin_mul_overflow(nmemb, size, &total)) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  void* ret = malloc(total);
+  if (ret) {
+    memset(ret, 0, total);
+  }
+  return ret;
+}
+
+void* realloc(void* ptr, size_t size) {
+  if (!ptr) {
+    return malloc(size);
+  }
+
+  // Keep the block if it fits and isn't wasting too much.
+  size_t old_size = usable_size(ptr);
+  if (size <= old_size && size >= old_size / 2) {
+    return ptr;
+  }
+
+  void* ret = malloc(size);
+  if (ret) {
+    memcpy(ret, ptr, size < old_size ? size : old_size);
+    free(ptr);
+  }
+  return ret;
+}
+
+int posix_memalign(void** memptr, size_t alignment, size_t size) {
+  if (alignment < sizeof(void*) || (alignment & (alignment - 1))) {
+    return EINVAL;
+  }
+
+  if (alignment <= ALIGNMENT) {
+    *memptr = malloc(size);
+    return *memptr ? 0 : ENOMEM;
+  }
+
+  // Over allocate from the header-based tiers so there's room for an aligned
+  // pointer plus a header in front of it pointing back to the real block.
+  size_t total;
+  if (__builtin_add_overflow(size, alignment + sizeof(struct block), &total)) {
+    return ENOMEM;
+  }
+  if (total <= SMALL_MAX) {
+    total = SMALL_MAX + 1;
+  }
+  void* raw = malloc(total);
+  if (!raw) {
+    return ENOMEM;
+  }
+
+  uintptr_t aligned = ALIGN_UP((uintptr_t)raw + sizeof(struct block), alignment);
+  struct block* hdr = (struct block*)aligned - 1;
+  hdr->magic = ALIGNED_MAGIC;
+  hdr->size_class = 0;
+  hdr->size = aligned - (uintptr_t)raw;
+  *memptr = (void*)aligned;
+  return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+  void* ret;
+  int error = posix_memalign(&ret, alignment, size);
+  if (error) {
+    errno = error;
+    return NULL;
+  }
+  return ret;
+}
+
+size_t malloc_usable_size(void* ptr) {
+  return ptr ? usable_size(ptr) : 0;
+}
+
+// wasi-libc's dlmalloc defines these for musl's internal use, so we have to
+// as well to keep it from being linked in.
+void* __libc_malloc(size_t size) __attribute__((alias("malloc")));
+void __libc_free(void* ptr) __attribute__((alias("free")));
+void* __libc_calloc(size_t nmemb, size_t size) __attribute__((alias("calloc")));
+
+void wassh_malloc_get_stats(struct wassh_malloc_stats* stats) {
+  stats->heap_size =
+      atomic_load_explicit(&stat_heap_size, memory_order_relaxed);
+  stats->in_use = atomic_load_explicit(&stat_in_use, memory_order_relaxed);
+  stats->peak_in_use =
+      atomic_load_explicit(&stat_peak_in_use, memory_order_relaxed);
+  stats->nmalloc = atomic_load_explicit(&stat_nmalloc, memory_order_relaxed);
+  stats->nfree = atomic_load_explicit(&stat_nfree, memory_order_relaxed);
+}
+
+void malloc_stats(void) {
+  struct wassh_malloc_stats stats;
+  wassh_malloc_get_stats(&stats);
+  fprintf(stderr,
+          "heap size:   %zu\n"
+          "in use:      %zu\n"
+          "peak in use: %zu\n"
+          "mallocs:     %zu\n"
+          "frees:       %zu\n",
+          stats.heap_size, stats.in_use, stats.peak_in_use, stats.nmalloc,
+          stats.nfree);
+}
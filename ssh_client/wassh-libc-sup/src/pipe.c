@@ -0,0 +1,555 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Implementation for pipe() & socketpair().
+//
+// Each direction of data flow is a lock-free single-producer/single-consumer
+// ring buffer in WASM memory.  The writer only ever advances |head| and the
+// reader only ever advances |tail|, so no locks are needed as long as only one
+// thread reads & only one thread writes a given end at a time (which is how
+// programs use pipes in practice).
+//
+// The runtime only allocates placeholder fds (see __wassh_fd_pipe) so the fd
+// numbers are unique.  Data never crosses into JS.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <wasi/api.h>
+#include <wasi/libc.h>
+
+#include "bh-syscalls.h"
+#include "debug.h"
+#include "pipe.h"
+
+// Same default capacity as Linux.  Must be a power of 2.
+#define PIPE_RING_SIZE (64 * 1024)
+_Static_assert((PIPE_RING_SIZE & (PIPE_RING_SIZE - 1)) == 0,
+               "PIPE_RING_SIZE must be a power of 2");
+
+// The runtime keeps all fds below FD_SETSIZE, so a flat table is enough.
+#define PIPE_MAX_FDS 1024
+
+struct pipe_ring {
+  // Free running byte counters.  head - tail is the number of buffered bytes.
+  _Atomic uint32_t head;
+  _Atomic uint32_t tail;
+  // Bumped on every state change so blocked threads can wait on it.
+  _Atomic uint32_t seq;
+  // Whether the read & write sides are still open.
+  _Atomic bool reader;
+  _Atomic bool writer;
+  // Number of pipe ends referring to this ring.
+  _Atomic int refs;
+  uint8_t data[PIPE_RING_SIZE];
+};
+
+struct pipe_end {
+  // The ring we read from (NULL for the write end of a pipe).
+  struct pipe_ring* rx;
+  // The ring we write to (NULL for the read end of a pipe).
+  struct pipe_ring* tx;
+  // Number of fds referring to this end.
+  _Atomic int refs;
+};
+
+static _Atomic(struct pipe_end*) pipe_fds[PIPE_MAX_FDS];
+static atomic_flag pipe_fds_lock = ATOMIC_FLAG_INIT;
+
+// How many poll()/epoll_wait() calls might be waiting in the runtime.
+static _Atomic int pipe_pollers;
+
+static void pipe_fds_acquire(void) {
+  while (atomic_flag_test_and_set_explicit(&pipe_fds_lock,
+                                           memory_order_acquire)) {
+  }
+}
+
+static void pipe_fds_release(void) {
+  atomic_flag_clear_explicit(&pipe_fds_lock, memory_order_release);
+}
+
+// Let anyone blocked on the ring know the state changed.
+//
+// Pollers wait in the runtime on the other fds too, so they can't watch |seq|.
+// Instead we tell the runtime, which ends their wait (or the next one if they
+// haven't started yet) so they recheck the rings.  This covers other threads,
+// and signal handlers that write to a pipe while a poll is blocked.
+static void ring_wake(struct pipe_ring* ring) {
+  atomic_fetch_add_explicit(&ring->seq, 1, memory_order_seq_cst);
+#ifdef __wasm_atomics__
+  __builtin_wasm_memory_atomic_notify((int*)&ring->seq, UINT32_MAX);
+#endif
+  if (atomic_load_explicit(&pipe_pollers, memory_order_seq_cst)) {
+    // Older runtimes don't support this, so their pollers only see pipe
+    // changes once something else wakes them up.  We might be in a signal
+    // handler, so don't clobber errno either way.
+    int old_errno = errno;
+    (void)fd_pipe_notify();
+    errno = old_errno;
+  }
+}
+
+// Wait for the ring to change from the |seq| snapshot.
+//
+// Without threads, nothing else could ever change the ring while we wait, so
+// we return false and let the caller fail with EAGAIN rather than hang.
+static bool ring_wait(struct pipe_ring* ring, uint32_t seq) {
+#ifdef __wasm_atomics__
+  __builtin_wasm_memory_atomic_wait32((int*)&ring->seq, (int)seq, -1);
+  return true;
+#else
+  (void)ring;
+  (void)seq;
+  return false;
+#endif
+}
+
+static size_t ring_used(struct pipe_ring* ring) {
+  return atomic_load_explicit(&ring->head, memory_order_acquire) -
+         atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
+
+// Copy |len| buffered bytes starting at |pos| out of the ring.  Doesn't update
+// |tail| so the caller can peek.  Only call from the reader.
+static void ring_copy_out(struct pipe_ring* ring,
+                          uint32_t pos,
+                          void* buf,
+                          size_t len) {
+  size_t off = pos & (PIPE_RING_SIZE - 1);
+  size_t first = PIPE_RING_SIZE - off;
+  if (first > len) {
+    first = len;
+  }
+  memcpy(buf, &ring->data[off], first);
+  memcpy((uint8_t*)buf + first, ring->data, len - first);
+}
+
+// Copy up to |len| bytes into the ring.  Only call from the writer.
+static size_t ring_write(struct pipe_ring* ring, const void* buf, size_t len) {
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  size_t space = PIPE_RING_SIZE - (head - tail);
+  if (len > space) {
+    len = space;
+  }
+  if (len == 0) {
+    return 0;
+  }
+
+  size_t off = head & (PIPE_RING_SIZE - 1);
+  size_t first = PIPE_RING_SIZE - off;
+  if (first > len) {
+    first = len;
+  }
+  memcpy(&ring->data[off], buf, first);
+  memcpy(ring->data, (const uint8_t*)buf + first, len - first);
+
+  atomic_store_explicit(&ring->head, head + len, memory_order_release);
+  return len;
+}
+
+static void ring_put(struct pipe_ring* ring) {
+  if (atomic_fetch_sub_explicit(&ring->refs, 1, memory_order_acq_rel) == 1) {
+    free(ring);
+  }
+}
+
+static void end_put(struct pipe_end* end) {
+  if (end == NULL ||
+      atomic_fetch_sub_explicit(&end->refs, 1, memory_order_acq_rel) != 1) {
+    return;
+  }
+
+  if (end->rx) {
+    atomic_store(&end->rx->reader, false);
+    ring_wake(end->rx);
+    ring_put(end->rx);
+  }
+  if (end->tx) {
+    atomic_store(&end->tx->writer, false);
+    ring_wake(end->tx);
+    ring_put(end->tx);
+  }
+  free(end);
+}
+
+// Check the runtime for O_NONBLOCK.  This is only done on the slow path when
+// the ring is empty/full so normal transfers don't leave WASM.
+static bool fd_nonblock(int fd) {
+  __wasi_fdstat_t stat;
+  if (__wasi_fd_fdstat_get(fd, &stat) != 0) {
+    return false;
+  }
+  return stat.fs_flags & __WASI_FDFLAGS_NONBLOCK;
+}
+
+static size_t iov_total(const struct iovec* iov, int iovcnt) {
+  size_t ret = 0;
+  for (int i = 0; i < iovcnt; ++i) {
+    ret += iov[i].iov_len;
+  }
+  return ret;
+}
+
+struct pipe_end* pipe_lookup(int fd) {
+  if (fd < 0 || fd >= PIPE_MAX_FDS) {
+    return NULL;
+  }
+  return atomic_load_explicit(&pipe_fds[fd], memory_order_acquire);
+}
+
+ssize_t pipe_readv(int fd,
+                   struct pipe_end* end,
+                   const struct iovec* iov,
+                   int iovcnt,
+                   int flags) {
+  struct pipe_ring* ring = end->rx;
+  if (ring == NULL) {
+    errno = EBADF;
+    return -1;
+  }
+
+  size_t len = iov_total(iov, iovcnt);
+  if (len == 0) {
+    return 0;
+  }
+
+  bool peek = flags & MSG_PEEK;
+  // We can't wait for more data than fits in the ring if we aren't draining it.
+  bool waitall = (flags & MSG_WAITALL) && !peek;
+  size_t total = 0;
+  int i = 0;
+  size_t ioff = 0;
+
+  while (1) {
+    uint32_t seq = atomic_load_explicit(&ring->seq, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t avail = head - tail;
+
+    size_t copied = 0;
+    while (copied < avail && i < iovcnt) {
+      size_t n = iov[i].iov_len - ioff;
+      if (n > avail - copied) {
+        n = avail - copied;
+      }
+      ring_copy_out(ring, tail + copied, (uint8_t*)iov[i].iov_base + ioff, n);
+      copied += n;
+      ioff += n;
+      if (ioff == iov[i].iov_len) {
+        ++i;
+        ioff = 0;
+      }
+    }
+    total += copied;
+    if (copied && !peek) {
+      atomic_store_explicit(&ring->tail, tail + copied, memory_order_release);
+      ring_wake(ring);
+    }
+
+    if (total == len || (total && !waitall)) {
+      return total;
+    }
+
+    // Once the writer is gone and everything is drained, signal EOF.  The
+    // writer might have written more right before closing, so recheck.
+    if (!atomic_load(&ring->writer)) {
+      if (ring_used(ring)) {
+        continue;
+      }
+      return total;
+    }
+
+    if ((flags & MSG_DONTWAIT) || fd_nonblock(fd) || !ring_wait(ring, seq)) {
+      if (total) {
+        return total;
+      }
+      errno = EAGAIN;
+      return -1;
+    }
+  }
+}
+
+ssize_t pipe_writev(int fd,
+                    struct pipe_end* end,
+                    const struct iovec* iov,
+                    int iovcnt,
+                    int flags) {
+  struct pipe_ring* ring = end->tx;
+  if (ring == NULL) {
+    errno = EBADF;
+    return -1;
+  }
+
+  size_t len = iov_total(iov, iovcnt);
+  size_t total = 0;
+  int i = 0;
+  size_t ioff = 0;
+
+  while (1) {
+    uint32_t seq = atomic_load_explicit(&ring->seq, memory_order_acquire);
+
+    if (!atomic_load(&ring->reader)) {
+      if (total) {
+        return total;
+      }
+      errno = EPIPE;
+      return -1;
+    }
+
+    // Writes of up to PIPE_BUF bytes must not be interleaved with other
+    // writes, so only write them once there's room for all of it.
+    size_t space = PIPE_RING_SIZE - ring_used(ring);
+    if (len > PIPE_BUF || space >= len) {
+      size_t copied = 0;
+      while (i < iovcnt) {
+        size_t ret = ring_write(ring, (const uint8_t*)iov[i].iov_base + ioff,
+                                iov[i].iov_len - ioff);
+        copied += ret;
+        ioff += ret;
+        if (ioff < iov[i].iov_len) {
+          break;
+        }
+        ++i;
+        ioff = 0;
+      }
+      total += copied;
+      if (copied) {
+        ring_wake(ring);
+      }
+    }
+
+    if (total == len) {
+      return total;
+    }
+
+    if ((flags & MSG_DONTWAIT) || fd_nonblock(fd) || !ring_wait(ring, seq)) {
+      if (total) {
+        return total;
+      }
+      errno = EAGAIN;
+      return -1;
+    }
+  }
+}
+
+short pipe_poll(struct pipe_end* end, short events) {
+  short revents = 0;
+
+  if (end->rx) {
+    if (ring_used(end->rx)) {
+      revents |= events & POLLRDNORM;
+    }
+    if (!atomic_load(&end->rx->writer)) {
+      revents |= POLLHUP;
+    }
+  }
+
+  if (end->tx) {
+    if (!atomic_load(&end->tx->reader)) {
+      revents |= POLLERR;
+    } else if (PIPE_RING_SIZE - ring_used(end->tx) >= PIPE_BUF) {
+      revents |= events & POLLWRNORM;
+    }
+  }
+
+  return revents;
+}
+
+void pipe_poll_begin(void) {
+  atomic_fetch_add_explicit(&pipe_pollers, 1, memory_order_seq_cst);
+}
+
+void pipe_poll_end(void) {
+  atomic_fetch_sub_explicit(&pipe_pollers, 1, memory_order_seq_cst);
+}
+
+size_t pipe_nread(struct pipe_end* end) {
+  return end->rx ? ring_used(end->rx) : 0;
+}
+
+int pipe_shutdown(struct pipe_end* end, int how) {
+  bool rd, wr;
+  switch (how) {
+    case SHUT_RD:
+      rd = true;
+      wr = false;
+      break;
+    case SHUT_WR:
+      rd = false;
+      wr = true;
+      break;
+    case SHUT_RDWR:
+      rd = wr = true;
+      break;
+    default:
+      errno = EINVAL;
+      return -1;
+  }
+
+  // Shutting down a pipe isn't a thing.
+  if (!end->rx || !end->tx) {
+    errno = ENOTSOCK;
+    return -1;
+  }
+
+  if (rd) {
+    atomic_store(&end->rx->reader, false);
+    ring_wake(end->rx);
+  }
+  if (wr) {
+    atomic_store(&end->tx->writer, false);
+    ring_wake(end->tx);
+  }
+  return 0;
+}
+
+void pipe_dup(int oldfd, int newfd) {
+  if (oldfd == newfd || newfd < 0 || newfd >= PIPE_MAX_FDS) {
+    return;
+  }
+
+  pipe_fds_acquire();
+  struct pipe_end* end = pipe_lookup(oldfd);
+  if (end) {
+    atomic_fetch_add(&end->refs, 1);
+  }
+  struct pipe_end* old = atomic_exchange(&pipe_fds[newfd], end);
+  pipe_fds_release();
+
+  end_put(old);
+}
+
+void pipe_close(int fd) {
+  if (fd < 0 || fd >= PIPE_MAX_FDS) {
+    return;
+  }
+
+  pipe_fds_acquire();
+  struct pipe_end* end = atomic_exchange(&pipe_fds[fd], NULL);
+  pipe_fds_release();
+
+  end_put(end);
+}
+
+static struct pipe_ring* ring_new(void) {
+  struct pipe_ring* ring = calloc(1, sizeof(*ring));
+  if (ring) {
+    ring->reader = true;
+    ring->writer = true;
+  }
+  return ring;
+}
+
+// Create the two ends & register them with |fds|.
+// For pipes, |fds[0]| reads what |fds[1]| writes.  For socketpairs, each end
+// reads what the other writes.
+static int pipe_create(int fds[2], __wasi_filetype_t filetype, bool duplex) {
+  struct pipe_ring* r0 = ring_new();
+  struct pipe_ring* r1 = duplex ? ring_new() : NULL;
+  struct pipe_end* e0 = calloc(1, sizeof(*e0));
+  struct pipe_end* e1 = calloc(1, sizeof(*e1));
+  if (!r0 || (duplex && !r1) || !e0 || !e1) {
+    free(r0);
+    free(r1);
+    free(e0);
+    free(e1);
+    errno = ENOMEM;
+    return -1;
+  }
+
+  e0->refs = e1->refs = 1;
+  e0->rx = r0;
+  e1->tx = r0;
+  r0->refs = 2;
+  if (duplex) {
+    e0->tx = r1;
+    e1->rx = r1;
+    r1->refs = 2;
+  }
+
+  // Make sure preopens have processed before we create new fds as that will
+  // update the file descriptor table, and preopen logic will fail when it hits
+  // a non-preopen fd.
+  __wasilibc_populate_preopens();
+
+  __wasi_fd_t sys_fds[2];
+  int ret = fd_pipe(filetype, sys_fds);
+  if (ret == 0 && (sys_fds[0] >= PIPE_MAX_FDS || sys_fds[1] >= PIPE_MAX_FDS)) {
+    close(sys_fds[0]);
+    close(sys_fds[1]);
+    errno = EMFILE;
+    ret = -1;
+  }
+  if (ret) {
+    end_put(e0);
+    end_put(e1);
+    return ret;
+  }
+
+  pipe_fds_acquire();
+  atomic_store(&pipe_fds[sys_fds[0]], e0);
+  atomic_store(&pipe_fds[sys_fds[1]], e1);
+  pipe_fds_release();
+
+  fds[0] = sys_fds[0];
+  fds[1] = sys_fds[1];
+  return 0;
+}
+
+int pipe(int pipefd[2]) {
+  _ENTER("pipefd=%p", pipefd);
+  int ret = pipe_create(pipefd, __WASI_FILETYPE_UNKNOWN, false);
+  _EXIT_ERRNO(ret, " fds={%i, %i}", pipefd[0], pipefd[1]);
+  return ret;
+}
+
+int socketpair(int domain, int type, int protocol, int sv[2]) {
+  _ENTER("domain=%i type=%i protocol=%i sv=%p", domain, type, protocol, sv);
+  int ret = -1;
+
+  if (domain != AF_UNIX) {
+    errno = EAFNOSUPPORT;
+    goto done;
+  }
+
+  // The rings are byte streams, so there are no datagram boundaries.
+  if ((type & ~(SOCK_NONBLOCK | SOCK_CLOEXEC)) != SOCK_STREAM) {
+    errno = EOPNOTSUPP;
+    goto done;
+  }
+
+  if (protocol != 0) {
+    errno = EPROTONOSUPPORT;
+    goto done;
+  }
+
+  ret = pipe_create(sv, __WASI_FILETYPE_SOCKET_STREAM, true);
+  if (ret == 0 && (type & SOCK_NONBLOCK)) {
+    __wasi_errno_t error =
+        __wasi_fd_fdstat_set_flags(sv[0], __WASI_FDFLAGS_NONBLOCK);
+    if (error == 0) {
+      error = __wasi_fd_fdstat_set_flags(sv[1], __WASI_FDFLAGS_NONBLOCK);
+    }
+    if (error != 0) {
+      close(sv[0]);
+      close(sv[1]);
+      errno = error;
+      ret = -1;
+    }
+  }
+
+done:
+  _EXIT_ERRNO(ret, "");
+  return ret;
+}
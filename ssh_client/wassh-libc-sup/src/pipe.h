@@ -0,0 +1,65 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Internal APIs for the in-memory pipe()/socketpair() implementation.
+//
+// The fds returned by pipe() & socketpair() are real fds in the runtime's fd
+// table (so they never collide with other fds), but all of their data lives in
+// ring buffers in WASM memory.  The standard I/O entry points (read, write,
+// poll, close, etc...) use pipe_lookup() to divert these fds to the helpers
+// here before falling back to the WASI syscalls.
+
+#ifndef _WASSH_PIPE_H
+#define _WASSH_PIPE_H
+
+#include <sys/cdefs.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+__BEGIN_DECLS
+
+struct pipe_end;
+
+// Find the pipe end for |fd|, or NULL if |fd| isn't a pipe.
+struct pipe_end* pipe_lookup(int fd);
+
+// Read/write the ring buffers.  Same semantics as readv() & writev().
+// |flags| are the MSG_* flags from recv() & send().
+ssize_t pipe_readv(int fd,
+                   struct pipe_end* end,
+                   const struct iovec* iov,
+                   int iovcnt,
+                   int flags);
+ssize_t pipe_writev(int fd,
+                    struct pipe_end* end,
+                    const struct iovec* iov,
+                    int iovcnt,
+                    int flags);
+
+// Return the poll() revents for |events| based on the current ring state.
+short pipe_poll(struct pipe_end* end, short events);
+
+// Bracket a poll()/epoll_wait() that checks pipes & then waits in the runtime.
+// While any are in progress, ring changes notify the runtime so the wait ends
+// and the rings get checked again.  Call begin before checking the rings.
+void pipe_poll_begin(void);
+void pipe_poll_end(void);
+
+// Return how many bytes are buffered for reading (for FIONREAD).
+size_t pipe_nread(struct pipe_end* end);
+
+// Shut down one or both directions.  Same semantics as shutdown().
+int pipe_shutdown(struct pipe_end* end, int how);
+
+// Update the pipe table after the runtime has duplicated |oldfd| to |newfd|.
+// Any pipe end previously at |newfd| is released.
+void pipe_dup(int oldfd, int newfd);
+
+// Release |fd| from the pipe table (if it is a pipe).  The caller still has to
+// close the fd itself.
+void pipe_close(int fd);
+
+__END_DECLS
+
+#endif
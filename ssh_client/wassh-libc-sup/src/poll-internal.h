@@ -0,0 +1,33 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Internal APIs shared by the poll() family.
+
+#ifndef _WASSH_POLL_INTERNAL_H
+#define _WASSH_POLL_INTERNAL_H
+
+#include <poll.h>
+#include <stdint.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+// The userdata of the clock subscription when pipes are being polled too.  It
+// must match kPipePollUserdata in wasi-js-bindings.  Other subscriptions use
+// pollfd pointers, which are only 32 bits.
+#define POLL_PIPES_USERDATA UINT64_MAX
+
+// Turn a relative |timeout| in nanoseconds (or -1 to block forever) into an
+// absolute deadline on the monotonic clock (or -1).
+int64_t poll_deadline(int64_t timeout);
+
+// How many nanoseconds are left until |deadline| (or -1 to block forever).
+int64_t poll_remaining(int64_t deadline);
+
+// Same as poll(), but |timeout| is in nanoseconds (or -1 to block forever).
+int poll_ns(struct pollfd* fds, nfds_t nfds, int64_t timeout);
+
+__END_DECLS
+
+#endif
@@ -0,0 +1,212 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Implementation for poll().
+//
+// This is the same as wasi-libc except pipe fds are checked directly against
+// their ring buffers, and only the remaining fds are passed to the runtime.
+// Timeouts are tracked in nanoseconds against the monotonic clock so that
+// ppoll() doesn't lose precision, and wall clock jumps don't affect us.
+//
+// Pipe writes don't go through the runtime, so while we wait there, the pipe
+// code tells the runtime about ring changes (see pipe_poll_begin), and that
+// ends the wait early so we can recheck the rings.
+//
+// NB: Don't use the debug helpers here as stderr might be a pipe.
+
+#include <errno.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <wasi/api.h>
+
+#include "pipe.h"
+#include "poll-internal.h"
+#include "signal-internal.h"
+
+// Update revents for all the pipe fds, and return how many are ready.
+// |npipes| & |nothers| are set to how many pipe & non-pipe fds were passed in.
+static int poll_pipes(struct pollfd* fds,
+                      nfds_t nfds,
+                      nfds_t* npipes,
+                      nfds_t* nothers) {
+  int ret = 0;
+  *npipes = *nothers = 0;
+  for (nfds_t i = 0; i < nfds; ++i) {
+    struct pipe_end* end = pipe_lookup(fds[i].fd);
+    if (end) {
+      ++*npipes;
+      fds[i].revents = pipe_poll(end, fds[i].events);
+      if (fds[i].revents) {
+        ++ret;
+      }
+    } else {
+      fds[i].revents = 0;
+      if (fds[i].fd >= 0) {
+        ++*nothers;
+      }
+    }
+  }
+  return ret;
+}
+
+static int64_t monotonic_now(void) {
+  __wasi_timestamp_t now;
+  if (__wasi_clock_time_get(__WASI_CLOCKID_MONOTONIC, 1, &now) != 0) {
+    return 0;
+  }
+  return (int64_t)now;
+}
+
+int64_t poll_deadline(int64_t timeout) {
+  return timeout > 0 ? monotonic_now() + timeout : timeout;
+}
+
+int64_t poll_remaining(int64_t deadline) {
+  if (deadline <= 0) {
+    return deadline;
+  }
+  int64_t now = monotonic_now();
+  return deadline > now ? deadline - now : 0;
+}
+
+// Poll all the non-pipe fds via the runtime.  If |pipes| are being watched
+// too, the runtime might return early without any events when they change.
+static int poll_wasi(struct pollfd* fds,
+                     nfds_t nfds,
+                     int64_t timeout,
+                     bool pipes) {
+  __wasi_subscription_t subscriptions[2 * nfds + 1];
+  size_t nsubscriptions = 0;
+
+  for (nfds_t i = 0; i < nfds; ++i) {
+    struct pollfd* pollfd = &fds[i];
+    if (pollfd->fd < 0 || pipe_lookup(pollfd->fd)) {
+      continue;
+    }
+
+    bool created_events = false;
+    if (pollfd->events & POLLRDNORM) {
+      subscriptions[nsubscriptions++] = (__wasi_subscription_t){
+          .userdata = (uintptr_t)pollfd,
+          .u.tag = __WASI_EVENTTYPE_FD_READ,
+          .u.u.fd_read.file_descriptor = pollfd->fd,
+      };
+      created_events = true;
+    }
+    if (pollfd->events & POLLWRNORM) {
+      subscriptions[nsubscriptions++] = (__wasi_subscription_t){
+          .userdata = (uintptr_t)pollfd,
+          .u.tag = __WASI_EVENTTYPE_FD_WRITE,
+          .u.u.fd_write.file_descriptor = pollfd->fd,
+      };
+      created_events = true;
+    }
+
+    // The runtime can't wait on just errors/hangups.
+    if (!created_events) {
+      errno = ENOSYS;
+      return -1;
+    }
+  }
+
+  // The marker tells the runtime to end the wait early when a pipe changes.
+  // If there's no timeout, it waits "forever" for that.
+  if (timeout >= 0 || pipes) {
+    subscriptions[nsubscriptions++] = (__wasi_subscription_t){
+        .userdata = pipes ? POLL_PIPES_USERDATA : 0,
+        .u.tag = __WASI_EVENTTYPE_CLOCK,
+        .u.u.clock.id = __WASI_CLOCKID_MONOTONIC,
+        .u.u.clock.timeout =
+            (__wasi_timestamp_t)(timeout >= 0 ? timeout : INT64_MAX),
+    };
+  }
+
+  // Nothing could ever wake us up.
+  if (nsubscriptions == 0) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  __wasi_event_t events[nsubscriptions];
+  size_t nevents;
+  __wasi_errno_t error =
+      signal_poll_oneoff(subscriptions, events, nsubscriptions, &nevents);
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+
+  for (size_t i = 0; i < nevents; ++i) {
+    const __wasi_event_t* event = &events[i];
+    if (event->type != __WASI_EVENTTYPE_FD_READ &&
+        event->type != __WASI_EVENTTYPE_FD_WRITE) {
+      continue;
+    }
+
+    struct pollfd* pollfd = (struct pollfd*)(uintptr_t)event->userdata;
+    if (event->error == __WASI_ERRNO_BADF) {
+      pollfd->revents |= POLLNVAL;
+    } else if (event->error == __WASI_ERRNO_PIPE) {
+      pollfd->revents |= POLLHUP;
+    } else if (event->error != 0) {
+      pollfd->revents |= POLLERR;
+    } else if (event->type == __WASI_EVENTTYPE_FD_READ) {
+      pollfd->revents |= POLLRDNORM;
+      if (event->fd_readwrite.flags &
+          __WASI_EVENTRWFLAGS_FD_READWRITE_HANGUP) {
+        pollfd->revents |= POLLHUP;
+      }
+    } else {
+      pollfd->revents |= POLLWRNORM;
+      if (event->fd_readwrite.flags &
+          __WASI_EVENTRWFLAGS_FD_READWRITE_HANGUP) {
+        pollfd->revents |= POLLHUP;
+      }
+    }
+  }
+
+  int ret = 0;
+  for (nfds_t i = 0; i < nfds; ++i) {
+    if (fds[i].fd >= 0 && !pipe_lookup(fds[i].fd) && fds[i].revents) {
+      ++ret;
+    }
+  }
+  return ret;
+}
+
+int poll_ns(struct pollfd* fds, nfds_t nfds, int64_t timeout) {
+  signal_dispatch_pending();
+
+  int64_t deadline = poll_deadline(timeout);
+  while (1) {
+    // Register before checking the rings so no change is missed.
+    pipe_poll_begin();
+    nfds_t npipes, nothers;
+    int ready = poll_pipes(fds, nfds, &npipes, &nothers);
+
+    // If a pipe is already ready, only check the other fds without blocking.
+    int64_t wait = ready ? 0 : poll_remaining(deadline);
+
+    int ret = 0;
+    if (wait != 0 || nothers) {
+      ret = poll_wasi(fds, nfds, wait, npipes != 0);
+    }
+    pipe_poll_end();
+    if (ret < 0) {
+      return ret;
+    }
+
+    ret += ready;
+    if (ret || wait == 0) {
+      return ret;
+    }
+    // A pipe changed (or the timeout is up), so check everything again.
+  }
+}
+
+int poll(struct pollfd* fds, nfds_t nfds, int timeout) {
+  return poll_ns(fds, nfds, timeout < 0 ? -1 : (int64_t)timeout * 1000000);
+}
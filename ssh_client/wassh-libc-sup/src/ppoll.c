@@ -4,20 +4,29 @@
 
 // Implementation for ppoll().
 
+#include <errno.h>
 #include <poll.h>
+#include <stdint.h>
 
 #include "debug.h"
+#include "poll-internal.h"
 
 int ppoll(struct pollfd* fds,
           nfds_t nfds,
           const struct timespec* timeout,
           const sigset_t* sigmask) {
   (void)sigmask;
-  int ptimeout = timeout == NULL
-                     ? -1
-                     : (timeout->tv_sec * 1000 + timeout->tv_nsec / 1000000);
+  if (timeout && (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+                  timeout->tv_nsec >= 1000000000)) {
+    errno = EINVAL;
+    return -1;
+  }
+  // Keep the full nanosecond resolution rather than rounding down to ms.
+  int64_t ptimeout = timeout == NULL ? -1
+                                     : ((int64_t)timeout->tv_sec * 1000000000 +
+                                        timeout->tv_nsec);
   _ENTER("fds=%p nfds=%zu timeout=%p sigmask=%p", fds, nfds, timeout, sigmask);
-  int ret = poll(fds, nfds, ptimeout);
+  int ret = poll_ns(fds, nfds, ptimeout);
   if (ret < 0)
     _EXIT("ret = %i [%i:%s]", ret, errno, strerror(errno));
   else
@@ -10,6 +10,7 @@
 
 #include "bh-syscalls.h"
 #include "debug.h"
+#include "pipe.h"
 
 ssize_t sendto(int sockfd,
                const void* buf,
@@ -20,6 +21,11 @@ ssize_t sendto(int sockfd,
   _ENTER("sockfd=%i buf=%p len=%zu flags=%x addr=%p addrlen=%u", sockfd, buf,
          len, flags, addr, addrlen);
 
+  // Socketpairs are already connected, so ignore the address.
+  if (pipe_lookup(sockfd)) {
+    return send(sockfd, buf, len, flags);
+  }
+
   // Only support IPv4 & IPv6.
   int ret = -1;
   size_t written = 0;
@@ -77,6 +83,15 @@ done:
 
 ssize_t send(int sockfd, const void* buf, size_t len, int flags) {
   _ENTER("sockfd=%i buf=%p len=%zu flags=%x", sockfd, buf, len, flags);
+
+  struct pipe_end* end = pipe_lookup(sockfd);
+  if (end) {
+    struct iovec iov = {.iov_base = (void*)buf, .iov_len = len};
+    ssize_t ret = pipe_writev(sockfd, end, &iov, 1, flags);
+    _EXIT("ret = %zi", ret);
+    return ret;
+  }
+
   size_t written;
   int ret = sock_sendto(sockfd, buf, len, &written, flags, 0, NULL, 0);
   _EXIT_ERRNO(ret, " written=%zu", written);
@@ -0,0 +1,51 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Implementation for shutdown().
+
+#include <errno.h>
+#include <sys/socket.h>
+
+#include <wasi/api.h>
+
+#include "debug.h"
+#include "pipe.h"
+
+int shutdown(int sockfd, int how) {
+  _ENTER("sockfd=%i how=%i", sockfd, how);
+  int ret = -1;
+
+  struct pipe_end* end = pipe_lookup(sockfd);
+  if (end) {
+    ret = pipe_shutdown(end, how);
+    goto done;
+  }
+
+  __wasi_sdflags_t flags;
+  switch (how) {
+    case SHUT_RD:
+      flags = __WASI_SDFLAGS_RD;
+      break;
+    case SHUT_WR:
+      flags = __WASI_SDFLAGS_WR;
+      break;
+    case SHUT_RDWR:
+      flags = __WASI_SDFLAGS_RD | __WASI_SDFLAGS_WR;
+      break;
+    default:
+      errno = EINVAL;
+      goto done;
+  }
+
+  __wasi_errno_t error = __wasi_sock_shutdown(sockfd, flags);
+  if (error != 0) {
+    errno = error;
+    goto done;
+  }
+  ret = 0;
+
+done:
+  _EXIT_ERRNO(ret, "");
+  return ret;
+}
@@ -0,0 +1,31 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Internal APIs for signal delivery.
+
+#ifndef _WASSH_SIGNAL_INTERNAL_H
+#define _WASSH_SIGNAL_INTERNAL_H
+
+#include <stddef.h>
+#include <sys/cdefs.h>
+
+#include <wasi/api.h>
+
+__BEGIN_DECLS
+
+// Run the handlers for any signals the runtime has queued.  Call this at
+// syscall boundaries where the runtime might have queued new signals.
+void signal_dispatch_pending(void);
+
+// Same as __wasi_poll_oneoff, but runs the handlers for any signals that came
+// in while waiting before returning (e.g. with EINTR).  Use this instead of
+// calling __wasi_poll_oneoff directly.
+__wasi_errno_t signal_poll_oneoff(const __wasi_subscription_t* in,
+                                  __wasi_event_t* out,
+                                  size_t nsubscriptions,
+                                  size_t* nevents);
+
+__END_DECLS
+
+#endif
@@ -7,23 +7,51 @@
 #include <err.h>
 #include <errno.h>
 #include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "bh-syscalls.h"
 #include "debug.h"
+#include "signal-internal.h"
 
-// This is exported so the JS side can call us directly to deliver a signal.
-//
-// NB: The signal number uses musl ABI, not WASI ABI, and many signal numbers
-// are different between the two!
-void __wassh_signal_deliver(int signum) {
-  if (signum < 0 || signum >= NSIG)
-    return;
+// The bit for |sig| in the 64-bit signal bitmaps below.
+#define sigbit(sig) (UINT64_C(1) << ((sig) - 1))
+
+// Signals queued by the runtime.  The JS side atomically sets bit (signum - 1)
+// in here, and we atomically clear it before dispatching.  This way delivery
+// doesn't require the runtime to call back into WASM.
+static _Alignas(8) uint64_t pending_signals;
+static bool pending_registered;
+
+// Handlers installed via signal() & sigaction().  This lets us dispatch without
+// swapping handlers via signal() just to read the current one.  Only entries
+// with their bit set in |cached_handlers| are valid.
+static sighandler_t handler_cache[NSIG];
+static uint64_t cached_handlers;
+
+// Signals whose handlers are currently running.  We defer delivering these
+// until the handler returns (i.e. no SA_NODEFER).
+static uint64_t running_signals;
+
+// Look up the current handler for |signum|.
+static sighandler_t get_handler(int signum) {
+  if (cached_handlers & sigbit(signum))
+    return handler_cache[signum];
 
   // There is no API to just read the current signal handler.  So we have to set
-  // it to get the old value, use it, then restore it.
+  // it to get the old value, then restore it.
   int old_errno = errno;
-  sighandler_t handler = signal(signum, SIG_IGN);
+  sighandler_t handler = (signal)(signum, SIG_IGN);
+  if (handler != SIG_ERR)
+    (signal)(signum, handler);
   errno = old_errno;
+  return handler;
+}
+
+// Run the handler (or default disposition) for |signum|.
+static void run_handler(int signum) {
+  sighandler_t handler = get_handler(signum);
   if (handler == SIG_IGN)
     return;
 
@@ -31,7 +59,7 @@ void __wassh_signal_deliver(int signum) {
   // such initially.  So we have to handle it ourselves.
   if (handler == SIG_DFL &&
       (signum == SIGCHLD || signum == SIGURG || signum == SIGWINCH)) {
-    goto done;
+    return;
   }
 
   // SIG_ERR only happens with signals we can't catch.
@@ -41,11 +69,70 @@ void __wassh_signal_deliver(int signum) {
   }
 
   // Call the custom handler.
+  running_signals |= sigbit(signum);
   handler(signum);
+  running_signals &= ~sigbit(signum);
+}
+
+void signal_dispatch_pending(void) {
+  // Tell the runtime where to queue signals the first time through.  If it
+  // fails, the runtime will fall back to calling __wassh_signal_deliver.
+  if (!pending_registered) {
+    int old_errno = errno;
+    signal_register(&pending_signals);
+    pending_registered = true;
+    errno = old_errno;
+  }
+
+  uint64_t bits = __atomic_exchange_n(&pending_signals, 0, __ATOMIC_ACQ_REL);
+  if (!bits)
+    return;
+
+  // Requeue any signals whose handlers are already running.
+  uint64_t deferred = bits & running_signals;
+  if (deferred) {
+    __atomic_fetch_or(&pending_signals, deferred, __ATOMIC_RELEASE);
+    bits &= ~deferred;
+  }
+
+  int old_errno = errno;
+  while (bits) {
+    int signum = __builtin_ctzll(bits) + 1;
+    bits &= bits - 1;
+    run_handler(signum);
+  }
+  errno = old_errno;
+}
+
+__wasi_errno_t signal_poll_oneoff(const __wasi_subscription_t* in,
+                                  __wasi_event_t* out,
+                                  size_t nsubscriptions,
+                                  size_t* nevents) {
+  // Make sure the bitmap is registered before we block.
+  signal_dispatch_pending();
+  __wasi_errno_t error = __wasi_poll_oneoff(in, out, nsubscriptions, nevents);
+  // The runtime queues signals while we're waiting.
+  signal_dispatch_pending();
+  return error;
+}
 
-done:
-  // Restore the handler.
-  signal(signum, handler);
+// This is exported so the JS side can call us directly to deliver a signal.
+// It's only used by runtimes that don't support signal_register.
+//
+// NB: The signal number uses musl ABI, not WASI ABI, and many signal numbers
+// are different between the two!
+void __wassh_signal_deliver(int signum) {
+  if (signum <= 0 || signum >= NSIG)
+    return;
+
+  if (running_signals & sigbit(signum)) {
+    __atomic_fetch_or(&pending_signals, sigbit(signum), __ATOMIC_RELEASE);
+    return;
+  }
+
+  int old_errno = errno;
+  run_handler(signum);
+  errno = old_errno;
 }
 
 #define sigmask(sig) (1 << ((sig) - 1))
@@ -99,14 +186,42 @@ int sigismember(const sigset_t* set, int signum) {
   return *set | sigmask(signum);
 }
 
+sighandler_t wassh_signal(int signum, sighandler_t handler) {
+  sighandler_t old = (signal)(signum, handler);
+  if (old == SIG_ERR)
+    return old;
+
+  // Keep our cache in sync so signal delivery can skip signal().
+  handler_cache[signum] = handler;
+  cached_handlers |= sigbit(signum);
+  return old;
+}
+
 int sigaction(int signum,
               const struct sigaction* act,
               struct sigaction* oldact) {
+  if (signum <= 0 || signum >= NSIG) {
+    errno = EINVAL;
+    return -1;
+  }
+
   if (oldact)
     memset(oldact, 0, sizeof(*oldact));
 
+  if (act == NULL) {
+    if (oldact)
+      oldact->sa_handler = get_handler(signum);
+    return 0;
+  }
+
   if (act->sa_flags & SA_SIGINFO)
     errx(1, "sigaction(%i): SA_SIGINFO not supported", signum);
 
-  return signal(signum, act->sa_handler) == SIG_ERR ? -1 : 0;
+  sighandler_t old = wassh_signal(signum, act->sa_handler);
+  if (old == SIG_ERR)
+    return -1;
+
+  if (oldact)
+    oldact->sa_handler = old;
+  return 0;
 }
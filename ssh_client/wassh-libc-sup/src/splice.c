@@ -0,0 +1,145 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Implementation for splice().
+//
+// Moving data out of a socket happens entirely in the runtime, so the data
+// never has to be copied into & out of WASM memory.  Everything else (e.g.
+// pipes, which live in WASM memory already) is emulated with peek+write+read.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "bh-syscalls.h"
+#include "debug.h"
+#include "pipe.h"
+
+// Max bytes to move in one go when emulating.
+#define SPLICE_COPY_SIZE (16 * 1024)
+
+// Read from an fd we can't peek at (e.g. a file or tty).
+static ssize_t splice_read(int fd_in, void* buf, size_t len, int flags) {
+  if (flags & SPLICE_F_NONBLOCK) {
+    struct pollfd pollfd = {.fd = fd_in, .events = POLLIN};
+    int ret = poll(&pollfd, 1, 0);
+    if (ret <= 0) {
+      if (ret == 0) {
+        errno = EAGAIN;
+      }
+      return -1;
+    }
+  }
+  return read(fd_in, buf, len);
+}
+
+// Write to |fd_out|.  Only pipes can skip blocking.
+static ssize_t splice_write(int fd_out,
+                            const void* buf,
+                            size_t len,
+                            int msg_flags) {
+  if (pipe_lookup(fd_out)) {
+    return send(fd_out, buf, len, msg_flags);
+  }
+  return write(fd_out, buf, len);
+}
+
+// Move data by bouncing it through a buffer.
+static ssize_t splice_copy(int fd_in, int fd_out, size_t len, int flags) {
+  char buf[SPLICE_COPY_SIZE];
+  if (len > sizeof(buf)) {
+    len = sizeof(buf);
+  }
+  int msg_flags = flags & SPLICE_F_NONBLOCK ? MSG_DONTWAIT : 0;
+
+  // Peek at the data first, and only consume what we manage to write, so
+  // nothing is lost if the write fails.  Pipes & sockets support this.
+  ssize_t ret = recv(fd_in, buf, len, msg_flags | MSG_PEEK);
+  if (ret < 0 && errno == ENOTSOCK) {
+    // Once we've read from anything else, we have to write all of it.
+    ret = splice_read(fd_in, buf, len, flags);
+    if (ret <= 0) {
+      return ret;
+    }
+
+    size_t nread = ret;
+    size_t nwritten = 0;
+    while (nwritten < nread) {
+      ret = splice_write(fd_out, buf + nwritten, nread - nwritten, 0);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        // Report what we did manage to move.
+        return nwritten ? (ssize_t)nwritten : ret;
+      }
+      nwritten += ret;
+    }
+    return nwritten;
+  }
+  if (ret <= 0) {
+    return ret;
+  }
+
+  size_t npeeked = ret;
+  size_t nwritten = 0;
+  while (nwritten < npeeked) {
+    ret = splice_write(fd_out, buf + nwritten, npeeked - nwritten, msg_flags);
+    if (ret < 0) {
+      if (nwritten == 0) {
+        return ret;
+      }
+      break;
+    }
+    nwritten += ret;
+  }
+
+  // Now drop what we wrote.  It's already queued, so this won't block.
+  recv(fd_in, buf, nwritten, MSG_DONTWAIT);
+  return nwritten;
+}
+
+ssize_t splice(int fd_in,
+               off_t* off_in,
+               int fd_out,
+               off_t* off_out,
+               size_t len,
+               unsigned int flags) {
+  _ENTER("fd_in=%i off_in=%p fd_out=%i off_out=%p len=%zu flags=%#x", fd_in,
+         off_in, fd_out, off_out, len, flags);
+  ssize_t ret;
+
+  if (off_in || off_out) {
+    errno = ESPIPE;
+    ret = -1;
+    goto done;
+  }
+
+  if (len == 0) {
+    ret = 0;
+    goto done;
+  }
+
+  if (!pipe_lookup(fd_in) && !pipe_lookup(fd_out)) {
+    size_t nspliced;
+    ret = fd_splice(fd_in, fd_out, len, flags, &nspliced);
+    if (ret == 0) {
+      ret = nspliced;
+      goto done;
+    }
+    // The runtime only splices from sockets.
+    if (errno != EINVAL) {
+      goto done;
+    }
+  }
+
+  ret = splice_copy(fd_in, fd_out, len, flags);
+
+done:
+  _EXIT("ret = %zi", ret);
+  return ret;
+}
@@ -40,11 +40,6 @@ ssize_t sendmsg(int sockfd, const struct msghdr* msg, int flags) {
   STUB_ENOSYS(-1, "sockfd=%i msg=%p flags=%#x", sockfd, msg, flags);
 }
 
-int socketpair(int domain, int type, int protocol, int sv[2]) {
-  STUB_ENOSYS(-1, "domain=%i type=%i protocol=%i sv=%p", domain, type, protocol,
-              sv);
-}
-
 struct servent* getservbyname(const char* name, const char* proto) {
   STUB_ENOSYS(NULL, "name={%s} proto={%s}", name, proto);
 }
@@ -76,10 +71,6 @@ void syslog(int priority, const char* format, ...) {
 }
 void closelog(void) {}
 
-int pipe(int pipefd[2]) {
-  STUB_ENOSYS(-1, "");
-}
-
 char* ptsname(int fd) {
   static char path[10];
   strncpy(path, "/dev/tty", sizeof(path));
@@ -0,0 +1,44 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Implementation for write() & writev().
+//
+// These are the same as wasi-libc except for diverting pipe fds.
+//
+// NB: Don't use the debug helpers here as they write to stderr themselves.
+
+#include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <wasi/api.h>
+
+#include "pipe.h"
+
+ssize_t writev(int fd, const struct iovec* iov, int iovcnt) {
+  if (iovcnt < 0 || iovcnt > IOV_MAX) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  struct pipe_end* end = pipe_lookup(fd);
+  if (end) {
+    return pipe_writev(fd, end, iov, iovcnt, 0);
+  }
+
+  size_t nwritten;
+  __wasi_errno_t error =
+      __wasi_fd_write(fd, (const __wasi_ciovec_t*)iov, iovcnt, &nwritten);
+  if (error != 0) {
+    errno = error == ENOTCAPABLE ? EBADF : error;
+    return -1;
+  }
+  return nwritten;
+}
+
+ssize_t write(int fd, const void* buf, size_t count) {
+  struct iovec iov = {.iov_base = (void*)buf, .iov_len = count};
+  return writev(fd, &iov, 1);
+}
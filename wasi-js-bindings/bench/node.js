@@ -0,0 +1,77 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Run background processes under node.
+ *
+ * Node's worker_threads have a different API from web workers, so wrap them
+ * to look like the web workers Process.Background expects.
+ */
+
+import * as threads from 'node:worker_threads';
+
+import {WorkerPool} from '../js/worker_pool.js';
+
+/**
+ * A worker_threads worker that looks like a web worker.
+ */
+export class NodeWorker extends EventTarget {
+  /**
+   * @param {string|!URL} workerUri The script the worker runs.
+   */
+  constructor(workerUri) {
+    super();
+    this.worker_ = new threads.Worker(new URL(workerUri));
+    this.worker_.on('message', (data) => {
+      this.dispatchEvent(new MessageEvent('message', {data}));
+    });
+    this.worker_.on('messageerror', (error) => {
+      this.dispatchEvent(new MessageEvent('messageerror', {data: error}));
+    });
+    this.worker_.on('error', (error) => {
+      const e = new Event('error');
+      e.error = error;
+      e.toString = () => `${error.stack ?? error}`;
+      this.dispatchEvent(e);
+    });
+  }
+
+  /**
+   * @param {*} message
+   */
+  postMessage(message) {
+    this.worker_.postMessage(message);
+  }
+
+  terminate() {
+    this.worker_.terminate();
+  }
+}
+
+/**
+ * Pool of worker_threads workers.
+ */
+export class NodeWorkerPool extends WorkerPool {
+  /**
+   * @return {!NodeWorker}
+   * @override
+   */
+  spawn_() {
+    return new NodeWorker(this.workerUri);
+  }
+}
+
+/**
+ * Set up the worker side of a NodeWorker.
+ *
+ * BackgroundWorker.Base talks to its worker's message port, and reports some
+ * errors via the global postMessage like web workers have.
+ *
+ * @return {!MessagePort} The port to bind BackgroundWorker.Base to.
+ */
+export function getParentPort() {
+  const port = threads.parentPort;
+  globalThis.postMessage = (message) => port.postMessage(message);
+  return port;
+}
@@ -0,0 +1,441 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Benchmark WASI syscall throughput under node.
+ *
+ * The programs run in worker_threads with the same handler stack as wassh
+ * (see worker.js), so syscalls go through the SharedArrayBuffer proxy to the
+ * main thread just like they do in the browser.  Timings come from the
+ * syscall profiler in the worker.
+ *
+ * Build the programs first (see bin/bench), then run:
+ *   node bench/run.js [--output results.json] [--baseline old.json]
+ *       [workload...]
+ */
+
+import {readFile, writeFile} from 'node:fs/promises';
+import * as os from 'node:os';
+import {parseArgs} from 'node:util';
+
+import {ModuleCache} from '../js/module_cache.js';
+import * as Process from '../js/process.js';
+import {Scheduler} from '../js/scheduler.js';
+import * as SyscallHandler from '../js/syscall_handler.js';
+import * as WASI from '../js/wasi.js';
+import {NodeWorkerPool} from './node.js';
+import {run as runStructs} from './structs.js';
+
+/**
+ * Bump this when the results format changes incompatibly.
+ */
+const kResultsVersion = 1;
+
+/**
+ * The fds the benchmark programs use (see syscalls.c).
+ */
+const kSinkFd = 3;
+const kSourceFd = 4;
+
+/**
+ * The programs to run.
+ *
+ * The argv callback gets how many iterations to run for programs that loop.
+ *
+ * @type {!Array<{
+ *   name: string,
+ *   program: string,
+ *   argv: function(string): !Array<string>,
+ * }>}
+ */
+const kWorkloads = [
+  // Test programs that exercise process startup.
+  {name: 'argv', program: 'test/argv.wasm', argv: () => ['a', 'b']},
+  {name: 'envp', program: 'test/envp.wasm', argv: () => []},
+  {name: 'random', program: 'test/random.wasm', argv: () => ['getentropy']},
+  {
+    name: 'read-write',
+    program: 'test/read-write.wasm',
+    argv: () => [
+      'write', `${kSinkFd}`, 'abcde', 'ret', '5',
+      'read', `${kSourceFd}`, '5', 'ret', '5',
+    ],
+  },
+
+  // Benchmark programs that make the same syscall in a loop.
+  ...[
+    ['yield'],
+    ['clock'],
+    ['fdstat'],
+    ['random', '256'],
+    ['read', '1'],
+    ['read', '4096'],
+    ['read', '65536'],
+    ['write', '1'],
+    ['write', '4096'],
+    ['write', '65536'],
+    ['writev', '1024'],
+  ].map(([mode, size]) => ({
+    name: `syscalls-${mode}${size ? `-${size}` : ''}`,
+    program: 'bench/syscalls.wasm',
+    argv: (iters) => [mode, iters, ...(size ? [size] : [])],
+  })),
+];
+
+/**
+ * Handle the benchmark syscalls in the main thread.
+ *
+ * These are as cheap as possible so the results measure the bindings.
+ */
+class BenchSyscallHandler extends SyscallHandler.DirectWasiPreview1 {
+  constructor() {
+    super();
+    this.output = '';
+    this.td_ = new TextDecoder();
+    this.zeros_ = new Uint8Array(0);
+  }
+
+  /**
+   * @param {!WASI_t.fd} fd
+   * @return {!WASI_t.errno|!WASI_t.fdstat}
+   * @override
+   */
+  handle_fd_fdstat_get(fd) {
+    if (fd < 0 || fd > kSourceFd) {
+      return WASI.errno.EBADF;
+    }
+    return {
+      fs_filetype: WASI.filetype.CHARACTER_DEVICE,
+      fs_flags: 0,
+      fs_rights_base: 0xffffffffffffffffn,
+      fs_rights_inheriting: 0xffffffffffffffffn,
+    };
+  }
+
+  /**
+   * @param {!WASI_t.fd} fd
+   * @param {!TypedArray} buf
+   * @return {!WASI_t.errno|{nwritten: !WASI_t.size}}
+   * @override
+   */
+  handle_fd_write(fd, buf) {
+    switch (fd) {
+      case 1:
+      case 2:
+        this.output += this.td_.decode(buf, {stream: true});
+        return WASI.errno.ESUCCESS;
+      case kSinkFd:
+        return WASI.errno.ESUCCESS;
+      default:
+        return WASI.errno.EBADF;
+    }
+  }
+
+  /**
+   * @param {!WASI_t.fd} fd
+   * @param {!WASI_t.size} length
+   * @return {!WASI_t.errno|{buf: !Uint8Array, nread: !WASI_t.size}}
+   * @override
+   */
+  handle_fd_read(fd, length) {
+    if (fd !== kSourceFd) {
+      return WASI.errno.EBADF;
+    }
+    if (this.zeros_.length < length) {
+      this.zeros_ = new Uint8Array(length);
+    }
+    return {buf: this.zeros_.subarray(0, length), nread: length};
+  }
+}
+
+/**
+ * A background process that keeps its profile quiet.
+ */
+class BenchProcess extends Process.Background {
+  /** @override */
+  onMessage_profile(summary, trace) {
+    this.profile = {summary, trace};
+  }
+}
+
+/**
+ * Convert the worker's profile into the results for one run.
+ *
+ * @param {!Array<!Object>} summary The profiler summary.
+ * @return {!Object<string, !Object>} The stats by syscall name.
+ */
+function getSyscallResults(summary) {
+  const ret = {};
+  summary.forEach((row) => {
+    ret[row.name] = {
+      count: row.count,
+      ns_per_op: row.total * 1e6 / row.count,
+      wait_ns_per_op: row.wait * 1e6 / row.count,
+      p50_ns: row.p50 * 1e6,
+      p99_ns: row.p99 * 1e6,
+      bytes: row.bytes,
+      bytes_per_sec: row.total ? row.bytes * 1000 / row.total : 0,
+    };
+  });
+  return ret;
+}
+
+/**
+ * Run a program once.
+ *
+ * @param {!WebAssembly.Module} executable The compiled program.
+ * @param {!Array<string>} argv The program arguments.
+ * @param {!NodeWorkerPool} workerPool Where to get the worker from.
+ * @param {?Scheduler} scheduler How to service the syscalls, if not messages.
+ * @return {!Promise<{wall_ms: number, syscalls: !Object<string, !Object>}>}
+ */
+async function runOnce(executable, argv, workerPool, scheduler) {
+  const handler = new BenchSyscallHandler();
+  const proc = new BenchProcess(workerPool.workerUri, {
+    executable,
+    argv,
+    environ: {},
+    handler,
+    workerPool,
+    scheduler,
+  });
+
+  const start = performance.now();
+  const ret = await proc.run();
+  const wall_ms = performance.now() - start;
+
+  if (ret.status !== 0) {
+    throw new Error(`${argv.join(' ')}: ${ret}\n${handler.output}`);
+  }
+  return {
+    wall_ms,
+    syscalls: getSyscallResults(proc.profile?.summary ?? []),
+  };
+}
+
+/**
+ * Run the workloads.
+ *
+ * @param {!Array<!Object>} workloads The workloads to run (from kWorkloads).
+ * @param {{iterations: number, repeat: number, scheduler: boolean}} options
+ *     How many times each benchmark program loops, and how many times to run
+ *     each workload (the fastest run is kept).  With scheduler, syscalls are
+ *     queued via a Scheduler rather than posted as messages.
+ * @return {!Promise<!Object<string, !Object>>} The results by workload name.
+ */
+async function runWorkloads(workloads, {iterations, repeat, scheduler}) {
+  const root = new URL('../', import.meta.url);
+  const moduleCache = new ModuleCache({persist: false});
+  const workerPool = new NodeWorkerPool(
+      new URL('./worker.js', import.meta.url).href);
+  workerPool.fill();
+  const sched = scheduler ? new Scheduler() : null;
+
+  const results = {};
+  try {
+    for (const {name, program, argv} of workloads) {
+      let bytes;
+      try {
+        bytes = await readFile(new URL(program, root));
+      } catch (e) {
+        throw new Error(`${program}: ${e.message} (run bin/bench to build it)`);
+      }
+      const executable = await moduleCache.get(bytes.buffer.slice(
+          bytes.byteOffset, bytes.byteOffset + bytes.byteLength));
+
+      let best = null;
+      for (let i = 0; i < repeat; ++i) {
+        const result = await runOnce(
+            executable, [program, ...argv(`${iterations}`)], workerPool,
+            sched);
+        if (best === null || result.wall_ms < best.wall_ms) {
+          best = result;
+        }
+      }
+      results[name] = best;
+    }
+  } finally {
+    workerPool.terminate();
+  }
+  return results;
+}
+
+/**
+ * Format the results as a table.
+ *
+ * @param {!Object} results The results from main.
+ * @return {string}
+ */
+export function formatResults(results) {
+  const lines = [
+    'workload'.padEnd(24) + 'syscall'.padEnd(24) + 'count'.padStart(9) +
+    'ns/op'.padStart(12) + 'wait ns/op'.padStart(12) + 'MB/s'.padStart(10),
+  ];
+  Object.entries(results.workloads).forEach(([name, {wall_ms, syscalls}]) => {
+    lines.push(`${name.padEnd(24)}${'(wall ms)'.padEnd(24)}` +
+               wall_ms.toFixed(1).padStart(21));
+    Object.entries(syscalls).forEach(([syscall, stats]) => {
+      lines.push(
+          ''.padEnd(24) + syscall.padEnd(24) + `${stats.count}`.padStart(9) +
+          stats.ns_per_op.toFixed(0).padStart(12) +
+          stats.wait_ns_per_op.toFixed(0).padStart(12) +
+          (stats.bytes ? (stats.bytes_per_sec / 1e6).toFixed(1) : '')
+              .padStart(10));
+    });
+  });
+
+  if (results.structs) {
+    lines.push('', 'structs'.padEnd(32) + 'generic ns'.padStart(12) +
+               'generated ns'.padStart(14));
+    Object.entries(results.structs).forEach(([name, stats]) => {
+      lines.push(name.padEnd(32) + stats.generic_ns.toFixed(1).padStart(12) +
+                 stats.generated_ns.toFixed(1).padStart(14));
+    });
+  }
+  return lines.join('\n');
+}
+
+/**
+ * Compare results against an earlier run.
+ *
+ * Only the syscall & struct timings are compared: the wall times include
+ * process startup which is too noisy.
+ *
+ * @param {!Object} baseline The earlier results.
+ * @param {!Object} results The new results.
+ * @param {number} threshold How much slower (in percent) is a regression.
+ * @return {{report: string, regressions: number}}
+ */
+export function compareResults(baseline, results, threshold) {
+  const rows = [];
+  Object.entries(results.workloads).forEach(([name, {syscalls}]) => {
+    const old = baseline.workloads?.[name]?.syscalls ?? {};
+    Object.entries(syscalls).forEach(([syscall, stats]) => {
+      if (old[syscall]) {
+        rows.push([`${name}/${syscall}`, old[syscall].ns_per_op,
+                   stats.ns_per_op]);
+      }
+    });
+  });
+  Object.entries(results.structs ?? {}).forEach(([name, stats]) => {
+    const old = baseline.structs?.[name];
+    if (old) {
+      rows.push([`structs/${name}`, old.generated_ns, stats.generated_ns]);
+    }
+  });
+
+  let regressions = 0;
+  const lines = [
+    'benchmark'.padEnd(48) + 'old ns'.padStart(12) + 'new ns'.padStart(12) +
+    'change'.padStart(10),
+  ];
+  rows.forEach(([name, before, after]) => {
+    const change = (after - before) * 100 / before;
+    let mark = '';
+    if (change > threshold) {
+      mark = '  REGRESSION';
+      ++regressions;
+    }
+    lines.push(name.padEnd(48) + before.toFixed(1).padStart(12) +
+               after.toFixed(1).padStart(12) +
+               `${change.toFixed(1)}%`.padStart(10) + mark);
+  });
+  return {report: lines.join('\n'), regressions};
+}
+
+/**
+ * The main func!
+ *
+ * @param {!Array<string>} argv The command line arguments.
+ * @return {!Promise<number>} The exit status.
+ */
+export async function main(argv) {
+  const {values: opts, positionals: names} = parseArgs({
+    args: argv,
+    allowPositionals: true,
+    options: {
+      'baseline': {type: 'string', short: 'b'},
+      'help': {type: 'boolean', short: 'h'},
+      'iterations': {type: 'string', short: 'n', default: '10000'},
+      'output': {type: 'string', short: 'o'},
+      'repeat': {type: 'string', short: 'r', default: '3'},
+      'scheduler': {type: 'boolean'},
+      'threshold': {type: 'string', default: '10'},
+    },
+  });
+
+  if (opts.help) {
+    console.log(
+        'Usage: run.js [options] [workload...]\n\n' +
+        'Options:\n' +
+        '  -b, --baseline FILE  Compare against earlier --output results\n' +
+        '  -n, --iterations N   How many syscalls each program makes\n' +
+        '  -o, --output FILE    Save the results as JSON\n' +
+        '  -r, --repeat N       Run each workload N times & keep the best\n' +
+        '  --scheduler          Queue syscalls via a Scheduler\n' +
+        '  --threshold PCT      How much slower is a regression\n\n' +
+        'Workloads:\n' +
+        ['structs', ...kWorkloads.map(({name}) => name)]
+            .map((name) => `  ${name}`).join('\n'));
+    return 0;
+  }
+
+  const unknown = names.filter(
+      (name) => name !== 'structs' && !kWorkloads.some((w) => w.name === name));
+  if (unknown.length) {
+    console.error(`Unknown workloads: ${unknown.join(' ')}`);
+    return 1;
+  }
+  const iterations = parseInt(opts.iterations, 10);
+
+  const results = {
+    version: kResultsVersion,
+    date: new Date().toISOString(),
+    node: process.version,
+    platform: `${os.platform()} ${os.arch()}`,
+    cpu: os.cpus()[0]?.model ?? 'unknown',
+    iterations,
+    scheduler: opts.scheduler ?? false,
+    workloads: await runWorkloads(
+        kWorkloads.filter(({name}) => !names.length || names.includes(name)),
+        {
+          iterations,
+          repeat: parseInt(opts.repeat, 10),
+          scheduler: opts.scheduler ?? false,
+        }),
+  };
+  if (names.length === 0 || names.includes('structs')) {
+    results.structs = {};
+    runStructs().forEach(({name, before, after}) => {
+      results.structs[name] = {generic_ns: before, generated_ns: after};
+    });
+  }
+
+  console.log(formatResults(results));
+
+  if (opts.output) {
+    await writeFile(opts.output, JSON.stringify(results, null, 2) + '\n');
+  }
+
+  if (opts.baseline) {
+    const baseline = JSON.parse(await readFile(opts.baseline, 'utf-8'));
+    if (baseline.version !== kResultsVersion) {
+      console.error(`${opts.baseline}: unsupported version`);
+      return 1;
+    }
+    const {report, regressions} = compareResults(
+        baseline, results, parseFloat(opts.threshold));
+    console.log(`\n${report}`);
+    if (regressions) {
+      console.error(`\n${regressions} benchmark(s) regressed`);
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+if (globalThis.process?.argv?.[1]?.endsWith('run.js')) {
+  process.exitCode = await main(process.argv.slice(2));
+}
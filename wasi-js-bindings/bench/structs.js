@@ -0,0 +1,130 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Benchmark WASI structure decoding & encoding.
+ *
+ * Compares the generic field spec walking that WasiView used to do for every
+ * structure against the generated codecs (see bin/gen_structs).  Each case
+ * matches the decoding/encoding one syscall does.
+ *
+ * Run it with node:
+ *   node bench/structs.js
+ */
+
+import {WasiView} from '../js/dataview.js';
+import * as structs from '../js/structs.js';
+
+/**
+ * How many iovecs the fd_read/fd_write cases use.
+ */
+const kIovecs = 4;
+
+/**
+ * How long to run each case for in milliseconds.
+ */
+const kDuration = 500;
+
+/**
+ * Time a function.
+ *
+ * @param {function()} func The function to run repeatedly.
+ * @return {number} The average time per call in nanoseconds.
+ */
+function timeit(func) {
+  // Warm up the JIT before timing.
+  for (let i = 0; i < 10000; ++i) {
+    func();
+  }
+
+  let iters = 0;
+  const start = performance.now();
+  let now = start;
+  while (now - start < kDuration) {
+    for (let i = 0; i < 1000; ++i) {
+      func();
+    }
+    iters += 1000;
+    now = performance.now();
+  }
+  return (now - start) * 1e6 / iters;
+}
+
+/**
+ * The benchmark cases.
+ *
+ * @param {!WasiView} dv The memory to decode/encode.
+ * @return {!Object<string, {before: function(), after: function()}>}
+ */
+function getCases(dv) {
+  const filestat = {
+    dev: 1n, ino: 2n, filetype: 4, nlink: 1n, size: 1024n, atim: 5n, mtim: 6n,
+    ctim: 7n,
+  };
+  const fdstat = {
+    fs_filetype: 2, fs_flags: 0, fs_rights_base: 0xffn,
+    fs_rights_inheriting: 0xffn,
+  };
+  const iovPtrs = new Uint32Array(kIovecs);
+  const iovLens = new Uint32Array(kIovecs);
+  let sink = 0;
+
+  return {
+    'fd_read/fd_write iovecs': {
+      before: () => {
+        for (let i = 0; i < kIovecs; ++i) {
+          sink += dv.get_(WasiView.iovec_t, i * 8, true).buf_len;
+        }
+      },
+      after: () => {
+        sink += structs.readIovecs(dv, 0, kIovecs, iovPtrs, iovLens);
+      },
+    },
+    'fd_fdstat_get': {
+      before: () => dv.set_(WasiView.fdstat_t, 64, fdstat, true),
+      after: () => structs.writeFdstat(dv, 64, fdstat),
+    },
+    'fd_filestat_get': {
+      before: () => dv.set_(WasiView.filestat_t, 128, filestat, true),
+      after: () => structs.writeFilestat(dv, 128, filestat),
+    },
+    'poll_oneoff subscription clock': {
+      before: () => {
+        sink += dv.get_(WasiView.subscription_clock_t, 256, true).id;
+      },
+      after: () => {
+        sink += structs.readSubscriptionClock(dv, 256).id;
+      },
+    },
+  };
+}
+
+/**
+ * Run all the benchmarks.
+ *
+ * @return {!Array<{name: string, before: number, after: number}>} The time
+ *     per syscall in nanoseconds.
+ */
+export function run() {
+  const dv = new WasiView(new ArrayBuffer(1024));
+  for (let i = 0; i < kIovecs; ++i) {
+    structs.writeIovec(dv, i * 8, {buf: 512 + i * 16, buf_len: 16});
+  }
+
+  return Object.entries(getCases(dv)).map(([name, {before, after}]) => ({
+    name,
+    before: timeit(before),
+    after: timeit(after),
+  }));
+}
+
+if (globalThis.process?.argv?.[1]?.endsWith('structs.js')) {
+  console.log('syscall'.padEnd(32) + 'before ns'.padStart(12) +
+              'after ns'.padStart(12) + 'speedup'.padStart(10));
+  run().forEach(({name, before, after}) => {
+    console.log(name.padEnd(32) + before.toFixed(1).padStart(12) +
+                after.toFixed(1).padStart(12) +
+                `${(before / after).toFixed(1)}x`.padStart(10));
+  });
+}
@@ -0,0 +1,94 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Utility to make the same syscall over & over for benchmarking.
+//
+// The benchmark runner provides fd 3 as a sink (like /dev/null) and fd 4 as a
+// source (like /dev/zero).
+
+#include <assert.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/random.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "test-utils.h"
+
+#define SINK_FD 3
+#define SOURCE_FD 4
+
+// How many buffers to use with writev.
+#define NUM_IOVECS 4
+
+static uint8_t buf[NUM_IOVECS * 64 * 1024];
+
+int main(int argc, char* argv[]) {
+  if (argc < 3 || argc > 4) {
+    fprintf(stderr, "Usage: syscalls <mode> <iterations> [size]\n");
+    return 1;
+  }
+
+  const char* mode = argv[1];
+  const long iters = atol(argv[2]);
+  const size_t size = argc == 4 ? (size_t)atol(argv[3]) : 1;
+  if (size * NUM_IOVECS > sizeof(buf)) {
+    fprintf(stderr, "size %zu is too large\n", size);
+    return 1;
+  }
+
+  if (streq(mode, "clock")) {
+    struct timespec ts;
+    for (long i = 0; i < iters; ++i) {
+      int ret = clock_gettime(CLOCK_MONOTONIC, &ts);
+      assert(ret == 0);
+    }
+  } else if (streq(mode, "fdstat")) {
+    for (long i = 0; i < iters; ++i) {
+      int ret = fcntl(SINK_FD, F_GETFL);
+      assert(ret != -1);
+    }
+  } else if (streq(mode, "random")) {
+    // There is a max length of 256 with the API.
+    assert(size <= 256);
+    for (long i = 0; i < iters; ++i) {
+      int ret = getentropy(buf, size);
+      assert(ret == 0);
+    }
+  } else if (streq(mode, "read")) {
+    for (long i = 0; i < iters; ++i) {
+      ssize_t ret = read(SOURCE_FD, buf, size);
+      assert(ret == (ssize_t)size);
+    }
+  } else if (streq(mode, "write")) {
+    for (long i = 0; i < iters; ++i) {
+      ssize_t ret = write(SINK_FD, buf, size);
+      assert(ret == (ssize_t)size);
+    }
+  } else if (streq(mode, "writev")) {
+    struct iovec iov[NUM_IOVECS];
+    for (size_t i = 0; i < ARRAY_SIZE(iov); ++i) {
+      iov[i].iov_base = &buf[i * size];
+      iov[i].iov_len = size;
+    }
+    for (long i = 0; i < iters; ++i) {
+      ssize_t ret = writev(SINK_FD, iov, ARRAY_SIZE(iov));
+      assert(ret == (ssize_t)(size * NUM_IOVECS));
+    }
+  } else if (streq(mode, "yield")) {
+    for (long i = 0; i < iters; ++i) {
+      int ret = sched_yield();
+      assert(ret == 0);
+    }
+  } else {
+    fprintf(stderr, "unknown mode '%s'\n", mode);
+    return 1;
+  }
+
+  return 0;
+}
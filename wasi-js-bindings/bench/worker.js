@@ -0,0 +1,39 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview The benchmark program worker (see run.js).
+ *
+ * This mirrors the handler stack wassh uses: answer what we can from the
+ * syscall cache, then proxy everything else to the main thread.
+ */
+
+import * as BackgroundWorker from '../js/worker.js';
+import * as Process from '../js/process.js';
+import * as SyscallEntry from '../js/syscall_entry.js';
+import * as SyscallHandler from '../js/syscall_handler.js';
+import {getParentPort} from './node.js';
+
+class BenchWorker extends BackgroundWorker.Base {
+  /** @override */
+  newProcess(executable, argv, environ, sab, handler_ids, cache_sab,
+             slot) {
+    const proxy = new SyscallHandler.ProxyWasiPreview1(
+        this, sab, handler_ids, slot);
+    const sys_handlers = [
+      new SyscallHandler.CachedWasiPreview1(cache_sab, proxy),
+      proxy,
+      new SyscallHandler.DirectWasiPreview1(),
+    ];
+    const sys_entries = [
+      new SyscallEntry.WasiPreview1({sys_handlers}),
+    ];
+    return new Process.Foreground({
+      executable, argv, environ, sys_handlers, sys_entries, profile: true,
+    });
+  }
+}
+
+const worker = new BenchWorker(/** @type {?} */ (getParentPort()));
+worker.bind();
@@ -12,13 +12,17 @@
 class Process {
   /**
    * @param {{
-   *   executable: (string|!Promise<!Response>|!Response|!ArrayBuffer),
+   *   executable: (string|!Promise<!Response>|!Response|!ArrayBuffer|
+   *       !WebAssembly.Module),
    *   argv: (!Array<string>|undefined),
    *   environ: (!Object<string, string>|undefined),
    * }} param1
    */
   constructor({executable, argv, environ}) {
-    /** @type {(string|!Promise<!Response>|!Response|!ArrayBuffer)} */
+    /**
+     * @type {(string|!Promise<!Response>|!Response|!ArrayBuffer|
+     *     !WebAssembly.Module)}
+     */
     this.executable = '';
     /** @type {!Array<string>} */
     this.argv = [];
@@ -26,6 +30,8 @@ class Process {
     this.environ = {};
     /** @type {?WebAssembly.Instance} */
     this.instance_ = null;
+    /** @type {?Object} Syscall profiler, if enabled. */
+    this.profiler = null;
   }
 
   /** @param {...*} args */
@@ -53,6 +59,16 @@ class Process {
    */
   getView(base, length = undefined) {}
 
+  /**
+   * Get a view of all of WASM memory.
+   *
+   * This is cached until the memory grows, so use absolute offsets with it
+   * instead of creating views with getView.
+   *
+   * @return {!WasiView}
+   */
+  getMemView() {}
+
   /**
    * Mark the program as exited.
    *
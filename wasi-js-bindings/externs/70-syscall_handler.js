@@ -114,12 +114,26 @@ class SyscallHandler {
    * @param {!WASI_t.fd} fd
    * @param {!WASI_t.size} length
    * @param {!WASI_t.filesize} offset
+   * @param {!Uint8Array=} dest Shared memory to read into, if possible (see
+   *     SyscallEntry getDests_).
    * @return {!WASI_t.errno|
    *          {buf: !Uint8Array, nread: !WASI_t.size}|
    *          {buf: !Uint8Array}|
    *          {nread: !WASI_t.size}}
    */
-  handle_fd_pread(fd, length, offset) {}
+  handle_fd_pread(fd, length, offset, dest = undefined) {}
+
+  /**
+   * Optional vectored version of handle_fd_pread.
+   *
+   * @param {!WASI_t.fd} fd
+   * @param {!Array<!WASI_t.size>} lengths The size of each iovec.
+   * @param {!WASI_t.filesize} offset
+   * @param {!Array<!Uint8Array>=} dests Shared memory to read into, if
+   *     possible (see SyscallEntry getDests_).
+   * @return {!WASI_t.errno|{buf: !Uint8Array}|{nread: !WASI_t.size}}
+   */
+  handle_fd_preadv(fd, lengths, offset, dests = undefined) {}
 
   /**
    * @param {!WASI_t.fd} fd
@@ -141,15 +155,38 @@ class SyscallHandler {
    */
   handle_fd_pwrite(fd, buf, offset) {}
 
+  /**
+   * Optional vectored version of handle_fd_pwrite.
+   *
+   * @param {!WASI_t.fd} fd
+   * @param {!Array<!Uint8Array>} bufs
+   * @param {!WASI_t.filesize} offset
+   * @return {!WASI_t.errno|{nwritten: !WASI_t.size}}
+   */
+  handle_fd_pwritev(fd, bufs, offset) {}
+
   /**
    * @param {!WASI_t.fd} fd
    * @param {!WASI_t.size} length
+   * @param {!Uint8Array=} dest Shared memory to read into, if possible (see
+   *     SyscallEntry getDests_).
    * @return {!WASI_t.errno|
    *          {buf: !Uint8Array, nread: !WASI_t.size}|
    *          {buf: !Uint8Array}|
    *          {nread: !WASI_t.size}}
    */
-  handle_fd_read(fd, length) {}
+  handle_fd_read(fd, length, dest = undefined) {}
+
+  /**
+   * Optional vectored version of handle_fd_read.
+   *
+   * @param {!WASI_t.fd} fd
+   * @param {!Array<!WASI_t.size>} lengths The size of each iovec.
+   * @param {!Array<!Uint8Array>=} dests Shared memory to read into, if
+   *     possible (see SyscallEntry getDests_).
+   * @return {!WASI_t.errno|{buf: !Uint8Array}|{nread: !WASI_t.size}}
+   */
+  handle_fd_readv(fd, lengths, dests = undefined) {}
 
   /**
    * @param {!WASI_t.fd} fd
@@ -193,6 +230,15 @@ class SyscallHandler {
    */
   handle_fd_write(fd, buf) {}
 
+  /**
+   * Optional vectored version of handle_fd_write.
+   *
+   * @param {!WASI_t.fd} fd
+   * @param {!Array<!Uint8Array>} bufs
+   * @return {!WASI_t.errno|{nwritten: !WASI_t.size}}
+   */
+  handle_fd_writev(fd, bufs) {}
+
   /**
    * @param {!WASI_t.fd} fd
    * @param {?string} path
@@ -8,11 +8,17 @@
 
 // TODO(vapier): Switch to 'export * as' once closure support it.
 import {WasiView} from './js/dataview.js';
+import {ModuleCache} from './js/module_cache.js';
 import * as Process from './js/process.js';
+import * as Profiler from './js/profiler.js';
+import {Scheduler} from './js/scheduler.js';
 import * as SyscallEntry from './js/syscall_entry.js';
 import * as SyscallHandler from './js/syscall_handler.js';
+import * as SyscallTrace from './js/syscall_trace.js';
 import * as util from './js/util.js';
 import * as WASI from './js/wasi.js';
 import * as BackgroundWorker from './js/worker.js';
-export {BackgroundWorker, Process, SyscallEntry, SyscallHandler, util, WASI,
-        WasiView};
+import {WorkerPool} from './js/worker_pool.js';
+export {BackgroundWorker, ModuleCache, Process, Profiler, Scheduler,
+        SyscallEntry, SyscallHandler, SyscallTrace, util, WASI, WasiView,
+        WorkerPool};
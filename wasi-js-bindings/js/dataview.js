@@ -6,6 +6,7 @@
  * @fileoverview DataView supporting WASI structures.
  */
 
+import * as structs from './structs.js';
 import * as WASI from './wasi.js';
 
 /**
@@ -55,6 +56,9 @@ export class WasiView extends DataView {
    * @override
    */
   getDirent(byteOffset, littleEndian = false) {
+    if (littleEndian) {
+      return structs.readDirent(this, byteOffset);
+    }
     return /** @type {!WASI_t.dirent} */ (
         this.get_(WasiView.dirent_t, byteOffset, littleEndian));
   }
@@ -66,6 +70,10 @@ export class WasiView extends DataView {
    * @override
    */
   setDirent(byteOffset, value, littleEndian = false) {
+    if (littleEndian) {
+      structs.writeDirent(this, byteOffset, value);
+      return;
+    }
     this.set_(WasiView.dirent_t, byteOffset, value, littleEndian);
   }
 
@@ -76,6 +84,9 @@ export class WasiView extends DataView {
    * @override
    */
   getEvent(byteOffset, littleEndian = false) {
+    if (littleEndian) {
+      return structs.readEvent(this, byteOffset);
+    }
     return /** @type {!WASI_t.event} */ (
         this.get_(WasiView.event_t, byteOffset, littleEndian));
   }
@@ -87,6 +98,10 @@ export class WasiView extends DataView {
    * @override
    */
   setEvent(byteOffset, value, littleEndian = false) {
+    if (littleEndian) {
+      structs.writeEvent(this, byteOffset, value);
+      return;
+    }
     this.set_(WasiView.event_t, byteOffset, value, littleEndian);
   }
 
@@ -97,6 +112,9 @@ export class WasiView extends DataView {
    * @override
    */
   getEventFdReadWrite(byteOffset, littleEndian = false) {
+    if (littleEndian) {
+      return structs.readEventFdReadWrite(this, byteOffset);
+    }
     return /** @type {!WASI_t.event_fd_readwrite} */ (
         this.get_(WasiView.event_fd_readwrite_t, byteOffset, littleEndian));
   }
@@ -108,6 +126,10 @@ export class WasiView extends DataView {
    * @override
    */
   setEventFdReadWrite(byteOffset, value, littleEndian = false) {
+    if (littleEndian) {
+      structs.writeEventFdReadWrite(this, byteOffset, value);
+      return;
+    }
     this.set_(WasiView.event_fd_readwrite_t, byteOffset, value, littleEndian);
   }
 
@@ -118,6 +140,9 @@ export class WasiView extends DataView {
    * @override
    */
   getFdstat(byteOffset, littleEndian = false) {
+    if (littleEndian) {
+      return structs.readFdstat(this, byteOffset);
+    }
     return /** @type {!WASI_t.fdstat} */ (
         this.get_(WasiView.fdstat_t, byteOffset, littleEndian));
   }
@@ -129,6 +154,10 @@ export class WasiView extends DataView {
    * @override
    */
   setFdstat(byteOffset, value, littleEndian = false) {
+    if (littleEndian) {
+      structs.writeFdstat(this, byteOffset, value);
+      return;
+    }
     this.set_(WasiView.fdstat_t, byteOffset, value, littleEndian);
   }
 
@@ -139,6 +168,9 @@ export class WasiView extends DataView {
    * @override
    */
   getFilestat(byteOffset, littleEndian = false) {
+    if (littleEndian) {
+      return structs.readFilestat(this, byteOffset);
+    }
     return /** @type {!WASI_t.filestat} */ (
         this.get_(WasiView.filestat_t, byteOffset, littleEndian));
   }
@@ -150,6 +182,10 @@ export class WasiView extends DataView {
    * @override
    */
   setFilestat(byteOffset, value, littleEndian = false) {
+    if (littleEndian) {
+      structs.writeFilestat(this, byteOffset, value);
+      return;
+    }
     this.set_(WasiView.filestat_t, byteOffset, value, littleEndian);
   }
 
@@ -160,6 +196,9 @@ export class WasiView extends DataView {
    * @override
    */
   getIovec(byteOffset, littleEndian = false) {
+    if (littleEndian) {
+      return structs.readIovec(this, byteOffset);
+    }
     return /** @type {!WASI_t.iovec} */ (
         this.get_(WasiView.iovec_t, byteOffset, littleEndian));
   }
@@ -171,6 +210,10 @@ export class WasiView extends DataView {
    * @override
    */
   setIovec(byteOffset, value, littleEndian = false) {
+    if (littleEndian) {
+      structs.writeIovec(this, byteOffset, value);
+      return;
+    }
     this.set_(WasiView.iovec_t, byteOffset, value, littleEndian);
   }
 
@@ -181,6 +224,9 @@ export class WasiView extends DataView {
    * @override
    */
   getSubscriptionClock(byteOffset, littleEndian = false) {
+    if (littleEndian) {
+      return structs.readSubscriptionClock(this, byteOffset);
+    }
     return /** @type {!WASI_t.subscription_clock} */ (
         this.get_(WasiView.subscription_clock_t, byteOffset, littleEndian));
   }
@@ -192,6 +238,10 @@ export class WasiView extends DataView {
    * @override
    */
   setSubscriptionClock(byteOffset, value, littleEndian = false) {
+    if (littleEndian) {
+      structs.writeSubscriptionClock(this, byteOffset, value);
+      return;
+    }
     this.set_(WasiView.subscription_clock_t, byteOffset, value, littleEndian);
   }
 
@@ -202,6 +252,9 @@ export class WasiView extends DataView {
    * @override
    */
   getSubscriptionFdReadWrite(byteOffset, littleEndian = false) {
+    if (littleEndian) {
+      return structs.readSubscriptionFdReadWrite(this, byteOffset);
+    }
     return /** @type {!WASI_t.subscription_fd_readwrite} */ (
         this.get_(WasiView.subscription_fd_readwrite_t, byteOffset,
                   littleEndian));
@@ -214,6 +267,10 @@ export class WasiView extends DataView {
    * @override
    */
   setSubscriptionFdReadWrite(byteOffset, value, littleEndian = false) {
+    if (littleEndian) {
+      structs.writeSubscriptionFdReadWrite(this, byteOffset, value);
+      return;
+    }
     this.set_(WasiView.subscription_fd_readwrite_t, byteOffset, value,
               littleEndian);
   }
@@ -354,140 +411,16 @@ Object.entries(WasiView.typedefs).forEach(([type, wasiTypes]) => {
 });
 
 /*
- * typedef struct __wasi_dirent_t {
- *   __wasi_dircookie_t d_next;
- *   __wasi_inode_t d_ino;
- *   __wasi_dirnamlen_t d_namlen;
- *   __wasi_filetype_t d_type;
- * } __wasi_dirent_t;
- */
-WasiView.dirent_t = {
-  fields: {
-    d_next: {offset: 0, type: 'Dircookie'},
-    d_ino: {offset: 8, type: 'Inode'},
-    d_namlen: {offset: 16, type: 'Dirnamlen'},
-    d_type: {offset: 20, type: 'Filetype'},
-  },
-  struct_size: 24,
-};
-
-/*
- * typedef struct __wasi_event_t {
- *   __wasi_userdata_t userdata;
- *   __wasi_errno_t error;
- *   __wasi_eventtype_t type;
- *   __wasi_event_fd_readwrite_t fd_readwrite;
- * } __wasi_event_t;
- */
-WasiView.event_t = {
-  fields: {
-    userdata: {offset: 0, type: 'Userdata'},
-    error: {offset: 8, type: 'Errno'},
-    type: {offset: 10, type: 'Eventtype'},
-    fd_readwrite: {offset: 16, type: 'EventFdReadWrite'},
-  },
-  struct_size: 32,
-};
-
-/*
- * typedef struct __wasi_event_fd_readwrite_t {
- *   __wasi_filesize_t nbytes;
- *   __wasi_eventrwflags_t flags;
- * } __wasi_event_fd_readwrite_t;
- */
-WasiView.event_fd_readwrite_t = {
-  fields: {
-    nbytes: {offset: 0, type: 'Filesize'},
-    flags: {offset: 8, type: 'Eventrwflags'},
-  },
-  struct_size: 16,
-};
-
-/*
- * typedef struct __wasi_fdstat_t {
- *   __wasi_filetype_t fs_filetype;
- *   __wasi_fdflags_t fs_flags;
- *   __wasi_rights_t fs_rights_base;
- *   __wasi_rights_t fs_rights_inheriting;
- * } __wasi_fdstat_t;
- */
-WasiView.fdstat_t = {
-  fields: {
-    fs_filetype: {offset: 0, type: 'Filetype'},
-    fs_flags: {offset: 2, type: 'Fdflags'},
-    fs_rights_base: {offset: 8, type: 'Rights'},
-    fs_rights_inheriting: {offset: 16, type: 'Rights'},
-  },
-  struct_size: 24,
-};
-
-/*
- * typedef struct __wasi_filestat_t {
- *   __wasi_device_t dev;
- *   __wasi_inode_t ino;
- *   __wasi_filetype_t filetype;
- *   __wasi_linkcount_t nlink;
- *   __wasi_filesize_t size;
- *   __wasi_timestamp_t atim;
- *   __wasi_timestamp_t mtim;
- *   __wasi_timestamp_t ctim;
- * } __wasi_filestat_t;
- */
-WasiView.filestat_t = {
-  fields: {
-    dev: {offset: 0, type: 'Device'},
-    ino: {offset: 8, type: 'Inode'},
-    filetype: {offset: 16, type: 'Filetype'},
-    nlink: {offset: 24, type: 'Linkcount'},
-    size: {offset: 32, type: 'Filesize'},
-    atim: {offset: 40, type: 'Timestamp'},
-    mtim: {offset: 48, type: 'Timestamp'},
-    ctim: {offset: 56, type: 'Timestamp'},
-  },
-  struct_size: 64,
-};
-
-/*
- * typedef struct __wasi_iovec_t {
- *   void *buf;
- *   size_t buf_len;
- * } __wasi_iovec_t;
+ * The structure layouts (see bin/gen_structs).  WASI is little endian, so the
+ * accessors above use the generated codecs for that, and only fall back to
+ * walking these specs for big endian.
  */
+WasiView.dirent_t = structs.dirent_t;
+WasiView.event_t = structs.event_t;
+WasiView.event_fd_readwrite_t = structs.event_fd_readwrite_t;
+WasiView.fdstat_t = structs.fdstat_t;
+WasiView.filestat_t = structs.filestat_t;
 WasiView.ciovec_t =
-WasiView.iovec_t = {
-  fields: {
-    buf: {offset: 0, type: 'Pointer'},
-    buf_len: {offset: 4, type: 'Size'},
-  },
-  struct_size: 8,
-};
-
-/*
- * typedef struct __wasi_subscription_clock_t {
- *   __wasi_clockid_t id;
- *   __wasi_timestamp_t timeout;
- *   __wasi_timestamp_t precision;
- *   __wasi_subclockflags_t flags;
- * } __wasi_subscription_clock_t;
- */
-WasiView.subscription_clock_t = {
-  fields: {
-    id: {offset: 0, type: 'Clockid'},
-    timeout: {offset: 8, type: 'Timestamp'},
-    precision: {offset: 16, type: 'Timestamp'},
-    flags: {offset: 24, type: 'Subclockflags'},
-  },
-  struct_size: 32,
-};
-
-/*
- * typedef struct __wasi_subscription_fd_readwrite_t {
- *   __wasi_fd_t file_descriptor;
- * } __wasi_subscription_fd_readwrite_t;
- */
-WasiView.subscription_fd_readwrite_t = {
-  fields: {
-    file_descriptor: {offset: 0, type: 'Fd'},
-  },
-  struct_size: 4,
-};
+WasiView.iovec_t = structs.iovec_t;
+WasiView.subscription_clock_t = structs.subscription_clock_t;
+WasiView.subscription_fd_readwrite_t = structs.subscription_fd_readwrite_t;
@@ -0,0 +1,215 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Cache of compiled WASM modules.
+ *
+ * Compiling a multi-MB program is the most expensive part of starting a
+ * process, so we only want to do it once.  Modules are kept in memory (so
+ * later processes in the same page reuse them), and in IndexedDB when the
+ * platform allows it (so later pages reuse them too).  Entries are keyed by a
+ * hash of the content, so rebuilt programs never pick up stale modules.
+ *
+ * WebAssembly.Module objects can be posted to workers, so a single cache in
+ * the main thread is enough for all processes (see Process.Background).
+ */
+
+/**
+ * The IndexedDB object store for modules.
+ */
+const kStore = 'modules';
+
+/**
+ * Hash program content.
+ *
+ * @param {!ArrayBuffer} buffer The program content.
+ * @return {!Promise<?string>} The hash (in hex), or null if not available.
+ */
+export async function hashBytes(buffer) {
+  if (globalThis.crypto?.subtle === undefined) {
+    return null;
+  }
+
+  const hash = new Uint8Array(
+      await globalThis.crypto.subtle.digest('SHA-256', buffer));
+  return Array.from(hash, (b) => b.toString(16).padStart(2, '0')).join('');
+}
+
+/**
+ * Wait for an IndexedDB request to finish.
+ *
+ * @param {!IDBRequest} request The pending request.
+ * @return {!Promise<*>} The request result.
+ */
+function idbResult(request) {
+  return new Promise((resolve, reject) => {
+    request.onsuccess = () => resolve(request.result);
+    request.onerror = () => reject(request.error);
+  });
+}
+
+/**
+ * Cache of compiled WASM modules.
+ */
+export class ModuleCache {
+  /**
+   * @param {{
+   *   dbName: (string|undefined),
+   *   persist: (boolean|undefined),
+   * }=} options The IndexedDB database to use, and whether to use it at all.
+   */
+  constructor({dbName = 'wasi-js-bindings-modules', persist = true} = {}) {
+    this.dbName_ = dbName;
+    this.persist_ = persist && globalThis.indexedDB !== undefined;
+    /** @type {?Promise<?IDBDatabase>} */
+    this.db_ = null;
+    /**
+     * Modules by URL (for string sources) & by content hash.
+     *
+     * @type {!Map<string, !Promise<!WebAssembly.Module>>}
+     */
+    this.modules_ = new Map();
+  }
+
+  /**
+   * Get the compiled module for a program.
+   *
+   * @param {string|!Promise<!Response>|!Response|!ArrayBuffer} source The WASM
+   *     program.  Strings will automatically be fetched, responses will be
+   *     processed, and ArrayBuffers used directly.
+   * @return {!Promise<!WebAssembly.Module>}
+   */
+  async get(source) {
+    if (typeof source !== 'string') {
+      return this.getBytes_(await this.fetch_(source));
+    }
+
+    // Don't refetch programs we've already seen in this page.
+    let ret = this.modules_.get(source);
+    if (ret === undefined) {
+      ret = this.fetch_(source).then((buffer) => this.getBytes_(buffer));
+      this.modules_.set(source, ret);
+      // Don't remember failures (e.g. network errors).
+      ret.catch(() => this.modules_.delete(source));
+    }
+    return ret;
+  }
+
+  /**
+   * Get the program content.
+   *
+   * @param {string|!Promise<!Response>|!Response|!ArrayBuffer} source
+   * @return {!Promise<!ArrayBuffer>}
+   */
+  async fetch_(source) {
+    if (source instanceof ArrayBuffer) {
+      return source;
+    }
+    if (typeof source === 'string') {
+      source = fetch(source);
+    }
+    const response = await source;
+    return response.arrayBuffer();
+  }
+
+  /**
+   * Get the compiled module for program content.
+   *
+   * @param {!ArrayBuffer} buffer The program content.
+   * @return {!Promise<!WebAssembly.Module>}
+   */
+  async getBytes_(buffer) {
+    const hash = await hashBytes(buffer);
+    if (hash === null) {
+      return WebAssembly.compile(buffer);
+    }
+
+    let ret = this.modules_.get(hash);
+    if (ret === undefined) {
+      ret = this.load_(hash, buffer);
+      this.modules_.set(hash, ret);
+      ret.catch(() => this.modules_.delete(hash));
+    }
+    return ret;
+  }
+
+  /**
+   * Load the module from IndexedDB, or compile & save it.
+   *
+   * @param {string} hash The program content hash.
+   * @param {!ArrayBuffer} buffer The program content.
+   * @return {!Promise<!WebAssembly.Module>}
+   */
+  async load_(hash, buffer) {
+    const db = await this.openDb_();
+    if (db) {
+      try {
+        const module = await idbResult(
+            db.transaction(kStore).objectStore(kStore).get(hash));
+        if (module instanceof WebAssembly.Module) {
+          return module;
+        }
+      } catch (e) {
+        console.warn('Unable to load cached WASM module', e);
+      }
+    }
+
+    const module = await WebAssembly.compile(buffer);
+
+    if (db) {
+      try {
+        await idbResult(
+            db.transaction(kStore, 'readwrite').objectStore(kStore)
+                .put(module, hash));
+      } catch (e) {
+        // Most browsers refuse to serialize modules (DataCloneError), so stop
+        // trying if that's the case.
+        if (e.name === 'DataCloneError') {
+          this.persist_ = false;
+          this.db_ = Promise.resolve(null);
+          db.close();
+        } else {
+          console.warn('Unable to save cached WASM module', e);
+        }
+      }
+    }
+
+    return module;
+  }
+
+  /**
+   * Open the IndexedDB database, if persistence is enabled.
+   *
+   * @return {!Promise<?IDBDatabase>}
+   */
+  openDb_() {
+    if (this.db_ === null) {
+      if (!this.persist_) {
+        this.db_ = Promise.resolve(null);
+      } else {
+        const request = globalThis.indexedDB.open(this.dbName_, 1);
+        request.onupgradeneeded = () => {
+          request.result.createObjectStore(kStore);
+        };
+        this.db_ = idbResult(request).catch((e) => {
+          console.warn('Unable to open WASM module cache', e);
+          return null;
+        });
+      }
+    }
+    return this.db_;
+  }
+
+  /**
+   * Throw away all cached modules (including saved ones).
+   */
+  async clear() {
+    this.modules_.clear();
+    const db = await this.openDb_();
+    if (db) {
+      await idbResult(
+          db.transaction(kStore, 'readwrite').objectStore(kStore).clear());
+    }
+  }
+}
@@ -6,11 +6,16 @@
  * @fileoverview Processes for managing program runtimes.
  */
 
+import {ModuleCache} from './module_cache.js';
 import {Program} from './program.js';
+import {Profiler, formatSummary} from './profiler.js';
+import {Scheduler, Slot} from './scheduler.js';
+import {SyscallCache} from './syscall_cache.js';
 import {SyscallLock} from './syscall_lock.js';
 import {WasiView} from './dataview.js';
 import * as util from './util.js';
 import * as WASI from './wasi.js';
+import {WorkerPool} from './worker_pool.js';
 
 /**
  * Shared logic between different process types.
@@ -20,7 +25,8 @@ import * as WASI from './wasi.js';
 class Base {
   /**
    * @param {{
-   *   executable: (string|!Promise<!Response>|!Response|!ArrayBuffer),
+   *   executable: (string|!Promise<!Response>|!Response|!ArrayBuffer|
+   *       !WebAssembly.Module),
    *   argv: (!Array<string>|undefined),
    *   environ: (!Object<string, string>|undefined),
    *   debug: (boolean|undefined)
@@ -121,20 +127,35 @@ class Base {
 export class Foreground extends Base {
   /**
    * @param {{
-   *   executable: (string|!Promise<!Response>|!Response|!ArrayBuffer),
+   *   executable: (string|!Promise<!Response>|!Response|!ArrayBuffer|
+   *       !WebAssembly.Module),
    *   argv: (!Array<string>|undefined),
    *   environ: (!Object<string, string>|undefined),
    *   debug: (boolean|undefined),
    *   sys_handlers: !Array<!SyscallHandler>,
    *   sys_entries: !Array<!SyscallEntry>,
+   *   profile: (boolean|undefined),
    * }} param1
    */
-  constructor({executable, argv, environ, debug, sys_handlers, sys_entries}) {
+  constructor({executable, argv, environ, debug, sys_handlers, sys_entries,
+               profile}) {
     super({executable, argv, environ, debug});
     this.sys_handlers = sys_handlers;
     this.sys_entries = sys_entries;
+    /** @type {?Profiler} Syscall timings, if enabled. */
+    this.profiler = profile ? new Profiler() : null;
     /** @type {?WebAssembly.Instance} */
     this.instance_ = null;
+    /**
+     * Views of program memory (see updateMemViews_).
+     *
+     * @type {?ArrayBuffer|?SharedArrayBuffer}
+     */
+    this.memBuffer_ = null;
+    /** @type {?Uint8Array} */
+    this.memU8_ = null;
+    /** @type {?WasiView} */
+    this.memView_ = null;
     /** @type {?function(number)} Callback when the process finishes. */
     this.process_finish_ = null;
 
@@ -201,6 +222,23 @@ export class Foreground extends Base {
     }, {});
   }
 
+  /**
+   * Make sure the cached views of program memory are up-to-date.
+   *
+   * Syscalls access memory all the time, so we don't want to create new views
+   * every time.  The buffer only changes when the memory grows (the old one is
+   * detached, or for shared memory, a larger one is created), so views stay
+   * valid as long as the buffer is the same.
+   */
+  updateMemViews_() {
+    const buffer = this.instance_.exports.memory.buffer;
+    if (buffer !== this.memBuffer_) {
+      this.memBuffer_ = buffer;
+      this.memU8_ = new Uint8Array(buffer);
+      this.memView_ = new WasiView(buffer);
+    }
+  }
+
   /**
    * @param {number} base
    * @param {number=} end
@@ -208,8 +246,18 @@ export class Foreground extends Base {
    * @override
    */
   getMem(base, end = undefined) {
-    return new Uint8Array(this.instance_.exports.memory.buffer)
-        .subarray(base, end);
+    this.updateMemViews_();
+    return this.memU8_.subarray(base, end);
+  }
+
+  /**
+   * @return {!WasiView}
+   * @override
+   * @suppress {checkTypes} WasiView$$module$js$dataview naming confusion.
+   */
+  getMemView() {
+    this.updateMemViews_();
+    return /** @type {!WasiView} */ (this.memView_);
   }
 
   /**
@@ -242,20 +290,40 @@ export class Background extends Base {
    *   environ: !Object<string, string>,
    *   handler: !SyscallHandler,
    *   sabSize: number,
-   * }} param1
+   *   moduleCache: (?ModuleCache|undefined),
+   *   workerPool: (?WorkerPool|undefined),
+   *   scheduler: (?Scheduler|undefined),
+   * }} param1 The moduleCache compiles the program in this thread & reuses
+   *     the result across processes.  The workerPool provides pre-spawned
+   *     workers (it must be for the same workerUri).  The scheduler services
+   *     syscalls fairly across all the processes sharing it.
    */
   constructor(workerUri, {
     executable, argv, environ, handler,
     sabSize = 64 * 1024,
+    moduleCache = null,
+    workerPool = null,
+    scheduler = null,
   }) {
     super({executable, argv, environ});
 
     this.resolve_ = null;
     this.workerUri = workerUri;
     this.worker = null;
+    this.moduleCache_ = moduleCache;
+    this.workerPool_ = workerPool;
+    this.scheduler_ = scheduler;
+    /** @type {?Slot} Where the worker queues syscalls, if scheduled. */
+    this.slot = null;
     this.handler = handler;
     this.sab = new SharedArrayBuffer(sabSize);
     this.lock = new SyscallLock(this.sab);
+    /** @const {!SyscallCache} For CachedWasiPreview1 in the worker. */
+    this.cache = new SyscallCache();
+    /** @type {?{summary: !Array<!Object>, trace: !Object}} */
+    this.profile = null;
+    /** @type {?Uint8Array} The worker's recorded syscalls, if any. */
+    this.syscallTrace = null;
 
     handler.setProcess(this);
   }
@@ -318,8 +386,9 @@ export class Background extends Base {
     let ret = WASI.errno.ENOSYS;
     if (method in this.handler) {
       ret = await this.handler[method].apply(this.handler, args);
+      this.updateCache_(syscall, args, ret);
       if (typeof ret !== 'number') {
-        this.lock.setData(ret);
+        this.lock.setData(ret, syscall);
         ret = -1;
       }
     }
@@ -327,6 +396,101 @@ export class Background extends Base {
     this.lock.unlock();
   }
 
+  /**
+   * Run a syscall the worker queued via the scheduler.
+   *
+   * @param {!Array<*>} request The syscall name & arguments.
+   */
+  async onRequest(request) {
+    const [syscall, ...args] = request;
+    try {
+      await this.onMessage_syscall(/** @type {string} */ (syscall), ...args);
+    } catch (e) {
+      this.onError(`Error while handling ${syscall}: ${e}\n${e.stack}`);
+    }
+  }
+
+  /**
+   * Keep the syscall cache in sync with syscall results.
+   *
+   * Handlers with their own syscalls that change fds (e.g. dup2) need to
+   * invalidate the cache themselves.
+   *
+   * @param {string} syscall The syscall name.
+   * @param {!Array<*>} args The syscall arguments.
+   * @param {*} ret The syscall result.
+   */
+  updateCache_(syscall, args, ret) {
+    const fd = /** @type {number} */ (args[0]);
+    switch (syscall) {
+      case 'fd_fdstat_get':
+        if (typeof ret !== 'number') {
+          this.cache.setFdstat(fd, {
+            fs_filetype: ret.fs_filetype ?? WASI.filetype.UNKNOWN,
+            fs_flags: ret.fs_flags ?? 0,
+            fs_rights_base: ret.fs_rights_base ?? 0n,
+            fs_rights_inheriting: ret.fs_rights_inheriting ?? 0n,
+          });
+        }
+        break;
+      case 'tty_get_window_size':
+        if (typeof ret !== 'number') {
+          this.cache.setWindowSize(ret);
+        }
+        break;
+      case 'fd_close':
+      case 'fd_fdstat_set_flags':
+      case 'fd_fdstat_set_rights':
+        this.cache.invalidateFd(fd);
+        break;
+      case 'fd_renumber':
+        this.cache.invalidateFd(fd);
+        this.cache.invalidateFd(/** @type {number} */ (args[1]));
+        break;
+    }
+  }
+
+  /**
+   * The worker's syscall profile (see Foreground's profile option).
+   *
+   * @param {!Array<!Object>} summary
+   * @param {!Object} trace The Chrome trace events.
+   */
+  onMessage_profile(summary, trace) {
+    this.profile = {summary, trace};
+    console.log(`syscall profile:\n${formatSummary(summary)}`);
+    this.onProfile(this.profile);
+  }
+
+  /**
+   * Callback event for when the worker sends its syscall profile.
+   *
+   * @param {{summary: !Array<!Object>, trace: !Object}} profile
+   */
+  onProfile(profile) {}
+
+  /**
+   * The worker's syscall trace (see RecordWasiPreview1).
+   *
+   * @param {!Uint8Array} trace
+   */
+  onMessage_trace(trace) {
+    this.syscallTrace = trace;
+    let url = '';
+    if (globalThis.URL?.createObjectURL !== undefined) {
+      url = `: ${URL.createObjectURL(new Blob([trace]))}`;
+    }
+    console.log(`syscall trace (${trace.length} bytes)${url}`);
+    this.onTrace(trace);
+  }
+
+  /**
+   * Callback event for when the worker sends its syscall trace.
+   *
+   * @param {!Uint8Array} trace
+   */
+  onTrace(trace) {}
+
   /**
    * @param {number} status
    */
@@ -351,18 +515,45 @@ export class Background extends Base {
       this.resolve_(reason);
       this.resolve_ = null;
     }
+    if (this.slot) {
+      this.scheduler_.remove(this);
+      this.slot = null;
+    }
     this.worker.terminate();
   }
 
   async run() {
-    const w = new Worker(this.workerUri, {type: 'module'});
+    let w;
+    if (this.workerPool_) {
+      // NB: The URIs might be TrustedScriptURL objects.
+      if (`${this.workerPool_.workerUri}` !== `${this.workerUri}`) {
+        throw new util.ApiViolation(
+            `workerPool is for ${this.workerPool_.workerUri}, not ` +
+            `${this.workerUri}`);
+      }
+      w = this.workerPool_.claim();
+    } else {
+      w = new Worker(this.workerUri, {type: 'module'});
+    }
     this.worker = w;
     w.addEventListener(
         'message', /** @type {!EventListener} */ (this.onMessage.bind(this)));
     w.addEventListener('messageerror', this.onMessageError.bind(this));
     w.addEventListener('error', this.onError.bind(this));
-    this.postMessage('run', this.executable, this.argv, this.environ, this.sab,
-                     this.handler.getHandlers_());
+
+    // Compile while the worker starts up.
+    let executable = this.executable;
+    if (this.moduleCache_) {
+      try {
+        executable = await this.moduleCache_.get(executable);
+      } catch (e) {
+        w.terminate();
+        throw e;
+      }
+    }
+    this.slot = this.scheduler_?.add(this) ?? null;
+    this.postMessage('run', executable, this.argv, this.environ, this.sab,
+                     this.handler.getHandlers_(), this.cache.sab, this.slot);
 
     // Return a promise that resolves when we terminate.
     return new Promise((resolve) => {
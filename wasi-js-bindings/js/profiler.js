@@ -0,0 +1,324 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Syscall profiling.
+ *
+ * The profiler lives with the syscall entries (i.e. in the program's thread).
+ * Each entry call is timed from start to finish, and any time spent blocked
+ * on the main thread (see ProxyWasiPreview1) is split out as "wait" time.
+ */
+
+import * as WASI from './wasi.js';
+
+/**
+ * How many latency histogram buckets per power of two.
+ *
+ * Percentiles are reported as bucket upper bounds, so this is their precision:
+ * with 4, they're within 2^(1/4) (~19%) of the real value.
+ */
+const kSubBuckets = 4;
+
+/**
+ * Total number of latency histogram buckets.
+ *
+ * Latencies are in microseconds, so this covers up to 2^32us (~71 minutes).
+ */
+const kBuckets = 32 * kSubBuckets;
+
+/**
+ * Convert a latency into its histogram bucket.
+ *
+ * @param {number} ms The latency in milliseconds.
+ * @return {number} The bucket.
+ */
+function bucketOf(ms) {
+  const us = ms * 1000;
+  if (us <= 1) {
+    return 0;
+  }
+  return Math.min(Math.ceil(Math.log2(us) * kSubBuckets), kBuckets - 1);
+}
+
+/**
+ * Convert a histogram bucket into the upper bound of its latency.
+ *
+ * @param {number} bucket The bucket.
+ * @return {number} The latency in milliseconds.
+ */
+function bucketLimit(bucket) {
+  return Math.pow(2, bucket / kSubBuckets) / 1000;
+}
+
+/**
+ * Guess how many bytes a syscall handler moved.
+ *
+ * Reads & writes report it in their result.  Handlers that simply return
+ * ESUCCESS moved whatever buffers they were passed.
+ *
+ * @param {!Array<*>} args The handler arguments.
+ * @param {*} ret The handler result.
+ * @return {number}
+ */
+export function countBytes(args, ret) {
+  if (typeof ret === 'object' && ret !== null) {
+    if (typeof ret.nwritten === 'number') {
+      return ret.nwritten;
+    }
+    if (typeof ret.nread === 'number') {
+      return ret.nread;
+    }
+    if (ret.buf?.length !== undefined) {
+      return ret.buf.length;
+    }
+    return 0;
+  }
+
+  if (ret !== WASI.errno.ESUCCESS) {
+    return 0;
+  }
+
+  let bytes = 0;
+  args.flat().forEach((arg) => {
+    if (ArrayBuffer.isView(arg)) {
+      bytes += arg.byteLength;
+    }
+  });
+  return bytes;
+}
+
+/**
+ * The stats for a single syscall.
+ */
+class SyscallStats {
+  /**
+   * @param {string} name The syscall name.
+   */
+  constructor(name) {
+    this.name = name;
+    this.count = 0;
+    /** @type {number} Total time in milliseconds. */
+    this.total = 0;
+    /** @type {number} Time blocked on the main thread in milliseconds. */
+    this.wait = 0;
+    this.bytes = 0;
+    this.max = 0;
+    this.histogram = new Uint32Array(kBuckets);
+  }
+
+  /**
+   * @param {number} duration Total time in milliseconds.
+   * @param {number} wait Time blocked on the main thread in milliseconds.
+   * @param {number} bytes How many bytes were moved.
+   */
+  add(duration, wait, bytes) {
+    ++this.count;
+    this.total += duration;
+    this.wait += wait;
+    this.bytes += bytes;
+    this.max = Math.max(this.max, duration);
+    ++this.histogram[bucketOf(duration)];
+  }
+
+  /**
+   * @param {number} p The percentile to look up (e.g. 0.5 for the median).
+   * @return {number} The latency in milliseconds.
+   */
+  percentile(p) {
+    const target = Math.ceil(this.count * p);
+    let seen = 0;
+    for (let i = 0; i < kBuckets; ++i) {
+      seen += this.histogram[i];
+      if (seen >= target) {
+        return Math.min(bucketLimit(i), this.max);
+      }
+    }
+    return this.max;
+  }
+}
+
+/**
+ * Summary of a syscall's performance.
+ *
+ * All times are in milliseconds.
+ *
+ * @typedef {{
+ *   name: string,
+ *   count: number,
+ *   total: number,
+ *   worker: number,
+ *   wait: number,
+ *   bytes: number,
+ *   p50: number,
+ *   p90: number,
+ *   p99: number,
+ *   max: number,
+ * }}
+ */
+export let Summary;
+
+/**
+ * Collects syscall timings.
+ */
+export class Profiler {
+  /**
+   * @param {{
+   *   maxEvents: (number|undefined),
+   * }=} options How many trace events to keep.  The stats always cover every
+   *     call, but the trace stops growing once it has this many.
+   */
+  constructor({maxEvents = 100000} = {}) {
+    this.maxEvents_ = maxEvents;
+    /** @type {!Map<string, !SyscallStats>} */
+    this.stats_ = new Map();
+    /** @type {!Array<!Object>} */
+    this.events_ = [];
+    this.droppedEvents_ = 0;
+
+    // The call in progress.
+    this.depth_ = 0;
+    this.start_ = 0;
+    this.wait_ = 0;
+    this.bytes_ = 0;
+  }
+
+  /**
+   * Start timing a syscall.
+   */
+  begin() {
+    if (this.depth_++ === 0) {
+      this.start_ = performance.now();
+      this.wait_ = 0;
+      this.bytes_ = 0;
+    }
+  }
+
+  /**
+   * Account time the current syscall spent blocked on the main thread.
+   *
+   * @param {number} ms How long in milliseconds.
+   */
+  addWait(ms) {
+    this.wait_ += ms;
+  }
+
+  /**
+   * Account data the current syscall moved.
+   *
+   * @param {number} bytes How many bytes.
+   */
+  addBytes(bytes) {
+    this.bytes_ += bytes;
+  }
+
+  /**
+   * Finish timing a syscall.
+   *
+   * @param {string} name The syscall name.
+   */
+  end(name) {
+    if (--this.depth_ !== 0) {
+      return;
+    }
+
+    const duration = performance.now() - this.start_;
+    let stats = this.stats_.get(name);
+    if (stats === undefined) {
+      stats = new SyscallStats(name);
+      this.stats_.set(name, stats);
+    }
+    stats.add(duration, this.wait_, this.bytes_);
+
+    if (this.events_.length < this.maxEvents_) {
+      this.events_.push({
+        name,
+        cat: 'syscall',
+        ph: 'X',
+        ts: this.start_ * 1000,
+        dur: duration * 1000,
+        pid: 1,
+        tid: 1,
+        args: {wait_us: this.wait_ * 1000, bytes: this.bytes_},
+      });
+    } else {
+      ++this.droppedEvents_;
+    }
+  }
+
+  /**
+   * Throw away everything collected so far.
+   */
+  reset() {
+    this.stats_.clear();
+    this.events_ = [];
+    this.droppedEvents_ = 0;
+  }
+
+  /**
+   * @return {!Array<!Summary>} The stats, most expensive syscalls first.
+   */
+  getSummary() {
+    return Array.from(this.stats_.values(), (stats) => ({
+      name: stats.name,
+      count: stats.count,
+      total: stats.total,
+      worker: stats.total - stats.wait,
+      wait: stats.wait,
+      bytes: stats.bytes,
+      p50: stats.percentile(0.5),
+      p90: stats.percentile(0.9),
+      p99: stats.percentile(0.99),
+      max: stats.max,
+    })).sort((a, b) => b.total - a.total);
+  }
+
+  /**
+   * Export the calls in the Chrome trace event format.
+   *
+   * Load the JSON in chrome://tracing or https://ui.perfetto.dev/.
+   *
+   * @return {!Object}
+   */
+  toChromeTrace() {
+    return {
+      traceEvents: [
+        {
+          name: 'process_name', ph: 'M', pid: 1, tid: 1,
+          args: {name: 'wasm program'},
+        },
+        {
+          name: 'thread_name', ph: 'M', pid: 1, tid: 1,
+          args: {name: 'syscalls'},
+        },
+        ...this.events_,
+      ],
+      displayTimeUnit: 'ms',
+      otherData: {droppedEvents: this.droppedEvents_},
+    };
+  }
+}
+
+/**
+ * Format the summary as a table.
+ *
+ * @param {!Array<!Summary>} summary The stats from getSummary.
+ * @return {string}
+ */
+export function formatSummary(summary) {
+  const ms = (value) => value.toFixed(3).padStart(10);
+  const lines = [
+    'syscall'.padEnd(24) + 'count'.padStart(9) +
+    ['total', 'worker', 'wait', 'p50', 'p90', 'p99', 'max']
+        .map((col) => `${col} ms`.padStart(10)).join('') +
+    'bytes'.padStart(12),
+  ];
+  summary.forEach((row) => {
+    lines.push(
+        row.name.padEnd(24) + `${row.count}`.padStart(9) +
+        [row.total, row.worker, row.wait, row.p50, row.p90, row.p99, row.max]
+            .map(ms).join('') +
+        `${row.bytes}`.padStart(12));
+  });
+  return lines.join('\n');
+}
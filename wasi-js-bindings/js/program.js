@@ -13,9 +13,10 @@ import * as util from './util.js';
  */
 export class Program {
   /**
-   * @param {string|!Promise<!Response>|!Response|!ArrayBuffer} source The WASM
-   *     program to run.  Strings will automatically be fetched, responses will
-   *     be processed, and ArrayBuffers used directly.
+   * @param {string|!Promise<!Response>|!Response|!ArrayBuffer|
+   *     !WebAssembly.Module} source The WASM program to run.  Strings will
+   *     automatically be fetched, responses will be processed, and ArrayBuffers
+   *     & precompiled modules (see ModuleCache) used directly.
    * @param {boolean=} stream Whether to use WebAssembly.instantiateStreaming.
    */
   constructor(source, stream = false) {
@@ -35,6 +36,12 @@ export class Program {
    * @return {!Promise<!WebAssembly.Instance>} The WASM instance.
    */
   async instantiate(imports) {
+    if (this.source instanceof WebAssembly.Module) {
+      this.instance = /** @type {!WebAssembly.Instance} */ (
+          await WebAssembly.instantiate(this.source, imports));
+      return this.instance;
+    }
+
     let result;
 
     let stream = this.stream_;
@@ -0,0 +1,242 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Scheduling of syscalls from many background processes.
+ *
+ * Normally every worker posts a message per syscall, and each one runs as soon
+ * as the main thread gets to it.  A process that makes a lot of syscalls ends
+ * up with most of the main thread's turns, and every call pays for a message.
+ *
+ * With a Scheduler, workers instead queue the request in their SyscallLock
+ * memory, set their slot's request word, and ring a shared doorbell word.
+ * The main thread wakes up once per ring, and services every waiting slot in
+ * a turn, starting after the slot it started with last time.  Each process
+ * only has one syscall in flight, so no process gets more than one call per
+ * turn, no matter how busy it is.  Turns end early when synchronous handlers
+ * use up the time budget, and the rest of the slots go first next turn.
+ *
+ * Requests that can't be copied into the SyscallLock memory (e.g. views of
+ * shared program memory that handlers write into) still use messages.
+ */
+
+import {SyscallLock} from './syscall_lock.js';
+
+// Layout of the Int32Array words.
+const kDoorbell = 0;
+const kRequests = 4;
+
+/**
+ * Where a process's requests go (see Scheduler.add).
+ *
+ * This is passed to the worker.
+ *
+ * @typedef {{
+ *   sab: !SharedArrayBuffer,
+ *   index: number,
+ * }}
+ */
+export let Slot;
+
+/**
+ * Something the scheduler runs requests for (e.g. Process.Background).
+ *
+ * @typedef {{
+ *   lock: !SyscallLock,
+ *   onRequest: function(!Array<*>),
+ * }}
+ */
+let Client;
+
+/**
+ * Yield to the event loop.
+ *
+ * Unlike setTimeout, this isn't clamped or throttled.
+ *
+ * @return {!Promise<void>}
+ */
+function yieldTurn() {
+  return new Promise((resolve) => {
+    const channel = new MessageChannel();
+    channel.port1.onmessage = () => {
+      channel.port1.close();
+      resolve();
+    };
+    channel.port2.postMessage(null);
+  });
+}
+
+/**
+ * Wake up the scheduler.
+ *
+ * @param {!Int32Array} words The scheduler memory.
+ */
+function ring(words) {
+  Atomics.add(words, kDoorbell, 1);
+  Atomics.notify(words, kDoorbell);
+}
+
+/**
+ * Main thread scheduler of syscalls from many processes.
+ */
+export class Scheduler {
+  /**
+   * @param {{
+   *   slots: (number|undefined),
+   *   budget: (number|undefined),
+   * }=} options How many processes can use the scheduler at once, and how
+   *     long (in milliseconds) a turn may run synchronous handlers for.
+   */
+  constructor({slots = 64, budget = 4} = {}) {
+    this.sab = new SharedArrayBuffer((kRequests + slots) * 4);
+    this.words_ = new Int32Array(this.sab);
+    /** @type {!Array<?Client>} */
+    this.clients_ = new Array(slots).fill(null);
+    // How many slots (from the start) are in use, so turns don't have to
+    // check the rest.
+    this.used_ = 0;
+    this.budget_ = budget;
+    // The slot the next turn starts with.
+    this.next_ = 0;
+    this.running_ = false;
+    /** @const */
+    this.stats = {
+      // Turns that serviced at least one request.
+      turns: 0,
+      requests: 0,
+      // Turns that ran out of time before servicing every request.
+      deferred: 0,
+    };
+  }
+
+  /**
+   * Start servicing requests for a process.
+   *
+   * @param {!Client} client
+   * @return {?Slot} Where the process's worker queues requests, or null if
+   *     there are no free slots (the process should use messages).
+   */
+  add(client) {
+    const index = this.clients_.indexOf(null);
+    if (index === -1) {
+      return null;
+    }
+
+    this.clients_[index] = client;
+    this.used_ = Math.max(this.used_, index + 1);
+    Atomics.store(this.words_, kRequests + index, 0);
+    if (!this.running_) {
+      this.run_();
+    }
+    return {sab: this.sab, index};
+  }
+
+  /**
+   * Stop servicing requests for a process.
+   *
+   * @param {!Client} client
+   */
+  remove(client) {
+    const index = this.clients_.indexOf(client);
+    if (index !== -1) {
+      this.clients_[index] = null;
+      while (this.used_ && this.clients_[this.used_ - 1] === null) {
+        --this.used_;
+      }
+      // Let the loop exit if this was the last one.
+      ring(this.words_);
+    }
+  }
+
+  /**
+   * Service requests until there are no processes left.
+   */
+  async run_() {
+    this.running_ = true;
+    while (this.used_) {
+      // Read the doorbell before looking for requests so none are missed.
+      const doorbell = Atomics.load(this.words_, kDoorbell);
+      if (this.runTurn_()) {
+        await yieldTurn();
+      } else {
+        const waiter = Atomics.waitAsync(this.words_, kDoorbell, doorbell);
+        if (waiter.async) {
+          await waiter.value;
+        }
+      }
+    }
+    this.running_ = false;
+  }
+
+  /**
+   * Service the waiting requests.
+   *
+   * @return {boolean} Whether the turn ran out of time with requests left.
+   */
+  runTurn_() {
+    const start = performance.now();
+    const slots = this.used_;
+    let serviced = 0;
+    for (let i = 0; i < slots; ++i) {
+      const index = (this.next_ + i) % slots;
+      if (Atomics.exchange(this.words_, kRequests + index, 0) === 0) {
+        continue;
+      }
+
+      const client = this.clients_[index];
+      if (client !== null) {
+        ++serviced;
+        client.onRequest(client.lock.getRequest());
+      }
+
+      if (performance.now() - start >= this.budget_ && i + 1 < slots) {
+        // Pick up where we left off next turn.
+        this.next_ = (index + 1) % slots;
+        ++this.stats.turns;
+        ++this.stats.deferred;
+        this.stats.requests += serviced;
+        return true;
+      }
+    }
+
+    // Rotate who goes first so low slots don't always win.
+    this.next_ = (this.next_ + 1) % slots;
+    if (serviced) {
+      ++this.stats.turns;
+      this.stats.requests += serviced;
+    }
+    return false;
+  }
+}
+
+/**
+ * Worker side of a scheduler slot.
+ */
+export class SlotClient {
+  /**
+   * @param {!Slot} slot From Scheduler.add.
+   */
+  constructor({sab, index}) {
+    this.words_ = new Int32Array(sab);
+    this.index_ = index;
+  }
+
+  /**
+   * Queue a syscall for the main thread.
+   *
+   * The caller must hold the lock, and wait on it for the result.
+   *
+   * @param {!SyscallLock} lock The process's lock.
+   * @param {!Array<*>} request The syscall name & arguments.
+   * @return {boolean} Whether it was queued.  If not, use a message.
+   */
+  submit(lock, request) {
+    if (!lock.setRequest(request)) {
+      return false;
+    }
+    Atomics.store(this.words_, kRequests + this.index_, 1);
+    ring(this.words_);
+    return true;
+  }
+}
@@ -0,0 +1,412 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview WASI structure codecs from wasi/api.h.
+ *
+ * Generated by bin/gen_structs; do not edit.
+ *
+ * WASI is always little endian.  Readers fill in the object they're passed
+ * (if any), so callers can reuse objects to avoid allocations.
+ */
+
+/*
+ * typedef struct __wasi_dirent_t {
+ *   __wasi_dircookie_t d_next;
+ *   __wasi_inode_t d_ino;
+ *   __wasi_dirnamlen_t d_namlen;
+ *   __wasi_filetype_t d_type;
+ * } __wasi_dirent_t;
+ */
+export const dirent_t = {
+  fields: {
+    d_next: {offset: 0, type: 'Dircookie'},
+    d_ino: {offset: 8, type: 'Inode'},
+    d_namlen: {offset: 16, type: 'Dirnamlen'},
+    d_type: {offset: 20, type: 'Filetype'},
+  },
+  struct_size: 24,
+};
+
+/**
+ * Read a __wasi_dirent_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!Object=} out The object to fill in.
+ * @return {!WASI_t.dirent}
+ */
+export function readDirent(dv, ptr, out = {}) {
+  out.d_next = dv.getBigUint64(ptr, true);
+  out.d_ino = dv.getBigUint64(ptr + 8, true);
+  out.d_namlen = dv.getUint32(ptr + 16, true);
+  out.d_type = dv.getUint8(ptr + 20);
+  out.struct_size = 24;
+  return /** @type {!WASI_t.dirent} */ (out);
+}
+
+/**
+ * Write a __wasi_dirent_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!WASI_t.dirent} value
+ */
+export function writeDirent(dv, ptr, value) {
+  dv.setBigUint64(ptr, value.d_next, true);
+  dv.setBigUint64(ptr + 8, value.d_ino, true);
+  dv.setUint32(ptr + 16, value.d_namlen, true);
+  dv.setUint8(ptr + 20, value.d_type);
+}
+
+/*
+ * typedef struct __wasi_event_fd_readwrite_t {
+ *   __wasi_filesize_t nbytes;
+ *   __wasi_eventrwflags_t flags;
+ * } __wasi_event_fd_readwrite_t;
+ */
+export const event_fd_readwrite_t = {
+  fields: {
+    nbytes: {offset: 0, type: 'Filesize'},
+    flags: {offset: 8, type: 'Eventrwflags'},
+  },
+  struct_size: 16,
+};
+
+/**
+ * Read a __wasi_event_fd_readwrite_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!Object=} out The object to fill in.
+ * @return {!WASI_t.event_fd_readwrite}
+ */
+export function readEventFdReadWrite(dv, ptr, out = {}) {
+  out.nbytes = dv.getBigUint64(ptr, true);
+  out.flags = dv.getUint16(ptr + 8, true);
+  out.struct_size = 16;
+  return /** @type {!WASI_t.event_fd_readwrite} */ (out);
+}
+
+/**
+ * Write a __wasi_event_fd_readwrite_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!WASI_t.event_fd_readwrite} value
+ */
+export function writeEventFdReadWrite(dv, ptr, value) {
+  dv.setBigUint64(ptr, value.nbytes, true);
+  dv.setUint16(ptr + 8, value.flags, true);
+}
+
+/*
+ * typedef struct __wasi_event_t {
+ *   __wasi_userdata_t userdata;
+ *   __wasi_errno_t error;
+ *   __wasi_eventtype_t type;
+ *   __wasi_event_fd_readwrite_t fd_readwrite;
+ * } __wasi_event_t;
+ */
+export const event_t = {
+  fields: {
+    userdata: {offset: 0, type: 'Userdata'},
+    error: {offset: 8, type: 'Errno'},
+    type: {offset: 10, type: 'Eventtype'},
+    fd_readwrite: {offset: 16, type: 'EventFdReadWrite'},
+  },
+  struct_size: 32,
+};
+
+/**
+ * Read a __wasi_event_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!Object=} out The object to fill in.
+ * @return {!WASI_t.event}
+ */
+export function readEvent(dv, ptr, out = {}) {
+  out.userdata = dv.getBigUint64(ptr, true);
+  out.error = dv.getUint16(ptr + 8, true);
+  out.type = dv.getUint8(ptr + 10);
+  out.fd_readwrite = readEventFdReadWrite(dv, ptr + 16, out.fd_readwrite);
+  out.struct_size = 32;
+  return /** @type {!WASI_t.event} */ (out);
+}
+
+/**
+ * Write a __wasi_event_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!WASI_t.event} value
+ */
+export function writeEvent(dv, ptr, value) {
+  dv.setBigUint64(ptr, value.userdata, true);
+  dv.setUint16(ptr + 8, value.error, true);
+  dv.setUint8(ptr + 10, value.type);
+  dv.setBigUint64(ptr + 16, value.fd_readwrite.nbytes, true);
+  dv.setUint16(ptr + 24, value.fd_readwrite.flags, true);
+}
+
+/*
+ * typedef struct __wasi_fdstat_t {
+ *   __wasi_filetype_t fs_filetype;
+ *   __wasi_fdflags_t fs_flags;
+ *   __wasi_rights_t fs_rights_base;
+ *   __wasi_rights_t fs_rights_inheriting;
+ * } __wasi_fdstat_t;
+ */
+export const fdstat_t = {
+  fields: {
+    fs_filetype: {offset: 0, type: 'Filetype'},
+    fs_flags: {offset: 2, type: 'Fdflags'},
+    fs_rights_base: {offset: 8, type: 'Rights'},
+    fs_rights_inheriting: {offset: 16, type: 'Rights'},
+  },
+  struct_size: 24,
+};
+
+/**
+ * Read a __wasi_fdstat_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!Object=} out The object to fill in.
+ * @return {!WASI_t.fdstat}
+ */
+export function readFdstat(dv, ptr, out = {}) {
+  out.fs_filetype = dv.getUint8(ptr);
+  out.fs_flags = dv.getUint16(ptr + 2, true);
+  out.fs_rights_base = dv.getBigUint64(ptr + 8, true);
+  out.fs_rights_inheriting = dv.getBigUint64(ptr + 16, true);
+  out.struct_size = 24;
+  return /** @type {!WASI_t.fdstat} */ (out);
+}
+
+/**
+ * Write a __wasi_fdstat_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!WASI_t.fdstat} value
+ */
+export function writeFdstat(dv, ptr, value) {
+  dv.setUint8(ptr, value.fs_filetype);
+  dv.setUint16(ptr + 2, value.fs_flags, true);
+  dv.setBigUint64(ptr + 8, value.fs_rights_base, true);
+  dv.setBigUint64(ptr + 16, value.fs_rights_inheriting, true);
+}
+
+/*
+ * typedef struct __wasi_filestat_t {
+ *   __wasi_device_t dev;
+ *   __wasi_inode_t ino;
+ *   __wasi_filetype_t filetype;
+ *   __wasi_linkcount_t nlink;
+ *   __wasi_filesize_t size;
+ *   __wasi_timestamp_t atim;
+ *   __wasi_timestamp_t mtim;
+ *   __wasi_timestamp_t ctim;
+ * } __wasi_filestat_t;
+ */
+export const filestat_t = {
+  fields: {
+    dev: {offset: 0, type: 'Device'},
+    ino: {offset: 8, type: 'Inode'},
+    filetype: {offset: 16, type: 'Filetype'},
+    nlink: {offset: 24, type: 'Linkcount'},
+    size: {offset: 32, type: 'Filesize'},
+    atim: {offset: 40, type: 'Timestamp'},
+    mtim: {offset: 48, type: 'Timestamp'},
+    ctim: {offset: 56, type: 'Timestamp'},
+  },
+  struct_size: 64,
+};
+
+/**
+ * Read a __wasi_filestat_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!Object=} out The object to fill in.
+ * @return {!WASI_t.filestat}
+ */
+export function readFilestat(dv, ptr, out = {}) {
+  out.dev = dv.getBigUint64(ptr, true);
+  out.ino = dv.getBigUint64(ptr + 8, true);
+  out.filetype = dv.getUint8(ptr + 16);
+  out.nlink = dv.getBigUint64(ptr + 24, true);
+  out.size = dv.getBigUint64(ptr + 32, true);
+  out.atim = dv.getBigUint64(ptr + 40, true);
+  out.mtim = dv.getBigUint64(ptr + 48, true);
+  out.ctim = dv.getBigUint64(ptr + 56, true);
+  out.struct_size = 64;
+  return /** @type {!WASI_t.filestat} */ (out);
+}
+
+/**
+ * Write a __wasi_filestat_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!WASI_t.filestat} value
+ */
+export function writeFilestat(dv, ptr, value) {
+  dv.setBigUint64(ptr, value.dev, true);
+  dv.setBigUint64(ptr + 8, value.ino, true);
+  dv.setUint8(ptr + 16, value.filetype);
+  dv.setBigUint64(ptr + 24, value.nlink, true);
+  dv.setBigUint64(ptr + 32, value.size, true);
+  dv.setBigUint64(ptr + 40, value.atim, true);
+  dv.setBigUint64(ptr + 48, value.mtim, true);
+  dv.setBigUint64(ptr + 56, value.ctim, true);
+}
+
+/*
+ * typedef struct __wasi_iovec_t {
+ *   __wasi_pointer_t buf;
+ *   __wasi_size_t buf_len;
+ * } __wasi_iovec_t;
+ */
+export const iovec_t = {
+  fields: {
+    buf: {offset: 0, type: 'Pointer'},
+    buf_len: {offset: 4, type: 'Size'},
+  },
+  struct_size: 8,
+};
+
+/**
+ * Read a __wasi_iovec_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!Object=} out The object to fill in.
+ * @return {!WASI_t.iovec}
+ */
+export function readIovec(dv, ptr, out = {}) {
+  out.buf = dv.getUint32(ptr, true);
+  out.buf_len = dv.getUint32(ptr + 4, true);
+  out.struct_size = 8;
+  return /** @type {!WASI_t.iovec} */ (out);
+}
+
+/**
+ * Write a __wasi_iovec_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!WASI_t.iovec} value
+ */
+export function writeIovec(dv, ptr, value) {
+  dv.setUint32(ptr, value.buf, true);
+  dv.setUint32(ptr + 4, value.buf_len, true);
+}
+
+/*
+ * typedef struct __wasi_subscription_clock_t {
+ *   __wasi_clockid_t id;
+ *   __wasi_timestamp_t timeout;
+ *   __wasi_timestamp_t precision;
+ *   __wasi_subclockflags_t flags;
+ * } __wasi_subscription_clock_t;
+ */
+export const subscription_clock_t = {
+  fields: {
+    id: {offset: 0, type: 'Clockid'},
+    timeout: {offset: 8, type: 'Timestamp'},
+    precision: {offset: 16, type: 'Timestamp'},
+    flags: {offset: 24, type: 'Subclockflags'},
+  },
+  struct_size: 32,
+};
+
+/**
+ * Read a __wasi_subscription_clock_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!Object=} out The object to fill in.
+ * @return {!WASI_t.subscription_clock}
+ */
+export function readSubscriptionClock(dv, ptr, out = {}) {
+  out.id = dv.getUint32(ptr, true);
+  out.timeout = dv.getBigUint64(ptr + 8, true);
+  out.precision = dv.getBigUint64(ptr + 16, true);
+  out.flags = dv.getUint16(ptr + 24, true);
+  out.struct_size = 32;
+  return /** @type {!WASI_t.subscription_clock} */ (out);
+}
+
+/**
+ * Write a __wasi_subscription_clock_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!WASI_t.subscription_clock} value
+ */
+export function writeSubscriptionClock(dv, ptr, value) {
+  dv.setUint32(ptr, value.id, true);
+  dv.setBigUint64(ptr + 8, value.timeout, true);
+  dv.setBigUint64(ptr + 16, value.precision, true);
+  dv.setUint16(ptr + 24, value.flags, true);
+}
+
+/*
+ * typedef struct __wasi_subscription_fd_readwrite_t {
+ *   __wasi_fd_t file_descriptor;
+ * } __wasi_subscription_fd_readwrite_t;
+ */
+export const subscription_fd_readwrite_t = {
+  fields: {
+    file_descriptor: {offset: 0, type: 'Fd'},
+  },
+  struct_size: 4,
+};
+
+/**
+ * Read a __wasi_subscription_fd_readwrite_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!Object=} out The object to fill in.
+ * @return {!WASI_t.subscription_fd_readwrite}
+ */
+export function readSubscriptionFdReadWrite(dv, ptr, out = {}) {
+  out.file_descriptor = dv.getUint32(ptr, true);
+  out.struct_size = 4;
+  return /** @type {!WASI_t.subscription_fd_readwrite} */ (out);
+}
+
+/**
+ * Write a __wasi_subscription_fd_readwrite_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {!WASI_t.subscription_fd_readwrite} value
+ */
+export function writeSubscriptionFdReadWrite(dv, ptr, value) {
+  dv.setUint32(ptr, value.file_descriptor, true);
+}
+
+/**
+ * Read an array of __wasi_iovec_t.
+ *
+ * @param {!DataView} dv
+ * @param {number} ptr
+ * @param {number} count How many iovecs to read.
+ * @param {!Uint32Array|!Array<number>} bufs Where to store the buffer pointers.
+ * @param {!Uint32Array|!Array<number>} lens Where to store the buffer lengths.
+ * @return {number} The total length of all the buffers.
+ */
+export function readIovecs(dv, ptr, count, bufs, lens) {
+  let total = 0;
+  for (let i = 0; i < count; ++i, ptr += 8) {
+    bufs[i] = dv.getUint32(ptr, true);
+    total += lens[i] = dv.getUint32(ptr + 4, true);
+  }
+  return total;
+}
@@ -0,0 +1,322 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Shared cache of syscall results.
+ *
+ * The main thread keeps this updated with results that rarely change (like fd
+ * metadata & the terminal size) so the worker can answer those syscalls itself
+ * instead of crossing threads (see CachedWasiPreview1).
+ *
+ * There is a single writer (the main thread), and readers use a sequence lock:
+ * the sequence number is odd while an update is in progress, so readers retry
+ * if it was odd or changed while they were reading.
+ *
+ * It also holds the readiness word: a counter the main thread bumps (and
+ * notifies) whenever an fd's state changes or a signal is queued.  Pollers
+ * read it before checking their fds, then wait for it to change, so wakeups
+ * can't be missed and don't depend on timers.
+ *
+ * Pipes live in program memory, so the program flags their changes itself (see
+ * setPipesPending), and pollers return early to let it recheck them.
+ */
+
+/**
+ * How many fds (starting at 0) we cache metadata for.
+ */
+export const kMaxFds = 32;
+
+// Layout of the Int32Array words.
+const kSeq = 0;
+const kWinsizeValid = 1;
+const kWinsizeRow = 2;
+const kWinsizeCol = 3;
+const kWinsizeXpixel = 4;
+const kWinsizeYpixel = 5;
+const kReady = 6;
+const kSignalsPending = 7;
+const kPipesPending = 8;
+const kFdBase = 9;
+
+// Layout of each fd entry.
+const kFdValid = 0;
+const kFdFiletype = 1;
+const kFdFlags = 2;
+const kFdRightsBase = 4;
+const kFdRightsInheriting = 6;
+const kFdEntryWords = 8;
+
+const kWords = kFdBase + kMaxFds * kFdEntryWords;
+
+/**
+ * How many times readers retry before giving up & treating it as a miss.
+ */
+const kMaxRetries = 16;
+
+/**
+ * Cache of syscall results shared between threads.
+ */
+export class SyscallCache {
+  /**
+   * @param {!SharedArrayBuffer=} sab The shared memory from another instance,
+   *     otherwise a new one is allocated.
+   */
+  constructor(sab = new SharedArrayBuffer(kWords * 4)) {
+    this.sab = sab;
+    this.words_ = new Int32Array(sab);
+  }
+
+  /**
+   * Start an update.
+   */
+  beginWrite_() {
+    Atomics.add(this.words_, kSeq, 1);
+  }
+
+  /**
+   * Finish an update.
+   */
+  endWrite_() {
+    Atomics.add(this.words_, kSeq, 1);
+  }
+
+  /**
+   * Run a reader under the sequence lock.
+   *
+   * @param {function(): T} read Loads the fields.
+   * @return {T|undefined} The result, or undefined if we kept racing updates.
+   * @template T
+   */
+  read_(read) {
+    for (let i = 0; i < kMaxRetries; ++i) {
+      const seq = Atomics.load(this.words_, kSeq);
+      if (seq & 1) {
+        continue;
+      }
+      const ret = read();
+      if (Atomics.load(this.words_, kSeq) === seq) {
+        return ret;
+      }
+    }
+    return undefined;
+  }
+
+  /**
+   * @param {number} word
+   * @param {number} value
+   */
+  store_(word, value) {
+    Atomics.store(this.words_, word, value);
+  }
+
+  /**
+   * @param {number} word
+   * @return {number}
+   */
+  load_(word) {
+    return Atomics.load(this.words_, word);
+  }
+
+  /**
+   * @param {number} word
+   * @param {bigint} value
+   */
+  store64_(word, value) {
+    this.store_(word, Number(BigInt.asIntN(32, value)));
+    this.store_(word + 1, Number(BigInt.asIntN(32, value >> 32n)));
+  }
+
+  /**
+   * @param {number} word
+   * @return {bigint}
+   */
+  load64_(word) {
+    return BigInt.asUintN(32, BigInt(this.load_(word))) |
+        (BigInt.asUintN(32, BigInt(this.load_(word + 1))) << 32n);
+  }
+
+  /**
+   * @param {!WASI_t.fd} fd
+   * @return {number} The first word of the fd's entry, or -1 if not cached.
+   */
+  fdBase_(fd) {
+    return fd >= 0 && fd < kMaxFds ? kFdBase + fd * kFdEntryWords : -1;
+  }
+
+  /**
+   * @param {!WASI_t.fd} fd
+   * @return {!WASI_t.fdstat|undefined} The metadata, if cached.
+   */
+  getFdstat(fd) {
+    const base = this.fdBase_(fd);
+    if (base === -1) {
+      return undefined;
+    }
+
+    return this.read_(() => {
+      if (!this.load_(base + kFdValid)) {
+        return undefined;
+      }
+      return /** @type {!WASI_t.fdstat} */ ({
+        fs_filetype: this.load_(base + kFdFiletype),
+        fs_flags: this.load_(base + kFdFlags),
+        fs_rights_base: this.load64_(base + kFdRightsBase),
+        fs_rights_inheriting: this.load64_(base + kFdRightsInheriting),
+      });
+    });
+  }
+
+  /**
+   * @param {!WASI_t.fd} fd
+   * @param {!WASI_t.fdstat} stat
+   */
+  setFdstat(fd, stat) {
+    const base = this.fdBase_(fd);
+    if (base === -1) {
+      return;
+    }
+
+    this.beginWrite_();
+    this.store_(base + kFdFiletype, stat.fs_filetype);
+    this.store_(base + kFdFlags, stat.fs_flags);
+    this.store64_(base + kFdRightsBase, BigInt(stat.fs_rights_base));
+    this.store64_(base + kFdRightsInheriting,
+                  BigInt(stat.fs_rights_inheriting));
+    this.store_(base + kFdValid, 1);
+    this.endWrite_();
+  }
+
+  /**
+   * Forget an fd's metadata, e.g. when it's closed or changed.
+   *
+   * @param {!WASI_t.fd} fd
+   */
+  invalidateFd(fd) {
+    const base = this.fdBase_(fd);
+    if (base === -1) {
+      return;
+    }
+
+    this.beginWrite_();
+    this.store_(base + kFdValid, 0);
+    this.endWrite_();
+  }
+
+  /**
+   * @return {{row: number, col: number, xpixel: number, ypixel: number}|
+   *          undefined} The terminal size, if cached.
+   */
+  getWindowSize() {
+    return this.read_(() => {
+      if (!this.load_(kWinsizeValid)) {
+        return undefined;
+      }
+      return {
+        row: this.load_(kWinsizeRow),
+        col: this.load_(kWinsizeCol),
+        xpixel: this.load_(kWinsizeXpixel),
+        ypixel: this.load_(kWinsizeYpixel),
+      };
+    });
+  }
+
+  /**
+   * @param {{row: number, col: number, xpixel: number, ypixel: number}} size
+   */
+  setWindowSize({row, col, xpixel, ypixel}) {
+    this.beginWrite_();
+    this.store_(kWinsizeRow, row);
+    this.store_(kWinsizeCol, col);
+    this.store_(kWinsizeXpixel, xpixel);
+    this.store_(kWinsizeYpixel, ypixel);
+    this.store_(kWinsizeValid, 1);
+    this.endWrite_();
+  }
+
+  /**
+   * Forget the terminal size, e.g. when it's resized.
+   */
+  invalidateWindowSize() {
+    this.beginWrite_();
+    this.store_(kWinsizeValid, 0);
+    this.endWrite_();
+  }
+
+  /**
+   * @return {number} The current readiness word.
+   */
+  getReady() {
+    return Atomics.load(this.words_, kReady);
+  }
+
+  /**
+   * Wake up everyone waiting for the readiness word to change.
+   */
+  notifyReady() {
+    Atomics.add(this.words_, kReady, 1);
+    Atomics.notify(this.words_, kReady);
+  }
+
+  /**
+   * Wait (without blocking) for the readiness word to change.
+   *
+   * @param {number} ready The value from getReady before checking for events.
+   * @param {number=} msec How long to wait (may be fractional).
+   * @return {!Promise<void>} Resolves on a change or the timeout.
+   */
+  async waitReady(ready, msec = Infinity) {
+    const waiter = Atomics.waitAsync(this.words_, kReady, ready, msec);
+    if (waiter.async) {
+      await waiter.value;
+    }
+  }
+
+  /**
+   * Block the current thread until the readiness word changes.
+   *
+   * Main threads can't block, so this is only for workers.
+   *
+   * @param {number} ready The value from getReady before checking for events.
+   * @param {number=} msec How long to wait (may be fractional).
+   * @return {boolean} Whether it changed (rather than timed out).
+   */
+  waitReadySync(ready, msec = Infinity) {
+    return Atomics.wait(this.words_, kReady, ready, msec) !== 'timed-out';
+  }
+
+  /**
+   * @return {boolean} Whether the main thread has signals for the program.
+   */
+  getSignalsPending() {
+    return Atomics.load(this.words_, kSignalsPending) !== 0;
+  }
+
+  /**
+   * @param {boolean} pending Whether signals are queued for the program.
+   */
+  setSignalsPending(pending) {
+    Atomics.store(this.words_, kSignalsPending, pending ? 1 : 0);
+    if (pending) {
+      this.notifyReady();
+    }
+  }
+
+  /**
+   * Note that a pipe changed while the program might be polling.
+   *
+   * This stays set until a poller takes it, so a change that lands before the
+   * poll starts waiting still ends it.
+   */
+  setPipesPending() {
+    Atomics.store(this.words_, kPipesPending, 1);
+    this.notifyReady();
+  }
+
+  /**
+   * @return {boolean} Whether a pipe changed since the last call.
+   */
+  takePipesPending() {
+    return Atomics.exchange(this.words_, kPipesPending, 0) !== 0;
+  }
+}
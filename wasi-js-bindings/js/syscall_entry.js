@@ -8,6 +8,8 @@
  */
 
 import {WasiView} from './dataview.js';
+import {Profiler, countBytes} from './profiler.js';
+import * as structs from './structs.js';
 import * as util from './util.js';
 import * as WASI from './wasi.js';
 
@@ -16,6 +18,13 @@ import * as WASI from './wasi.js';
  */
 const AsyncFunction = (async () => {}).constructor;
 
+/**
+ * Reads at least this big use the staging buffer when program memory isn't
+ * shared (see getDests_).  Smaller ones are cheaper to pass back through the
+ * SyscallLock with the rest of the result.
+ */
+const kMinStagedRead = 16 * 1024;
+
 /**
  * Base class for creating syscall entries.
  *
@@ -39,6 +48,12 @@ export class Base {
     this.bindHandlers_(sys_handlers);
     /** @type {string} */
     this.namespace = '';
+    /**
+     * Shared memory for read handlers to write into (see getDests_).
+     *
+     * @type {?Uint8Array}
+     */
+    this.staging_ = null;
   }
 
   /**
@@ -58,6 +73,84 @@ export class Base {
     return this.process_.getMem(base, end);
   }
 
+  /**
+   * Get views that read handlers may write into directly.
+   *
+   * Handlers often run in another thread (see ProxyWasiPreview1).  When the
+   * program's memory is a SharedArrayBuffer, they write straight into it.
+   * Otherwise (e.g. the wasip1 ssh build), large reads get views of a shared
+   * staging buffer instead, and finishDests_ copies the data into program
+   * memory.  That's a single copy rather than going through the SyscallLock,
+   * and it isn't limited to the lock's 64KiB.
+   *
+   * @param {!Array<!Uint8Array>} bufs Views from getMem_.
+   * @return {!Array<!Uint8Array>|undefined} Where to write the data for each
+   *     of |bufs|, if the handler may write it directly.
+   */
+  getDests_(bufs) {
+    if (typeof SharedArrayBuffer === 'undefined' || bufs.length === 0) {
+      return undefined;
+    }
+    if (bufs[0].buffer instanceof SharedArrayBuffer) {
+      return bufs;
+    }
+
+    const total = bufs.reduce((sum, buf) => sum + buf.length, 0);
+    if (total < kMinStagedRead) {
+      return undefined;
+    }
+    if (this.staging_ === null || this.staging_.length < total) {
+      this.staging_ = new Uint8Array(new SharedArrayBuffer(total));
+    }
+    let offset = 0;
+    return bufs.map((buf) => {
+      const dest = this.staging_.subarray(offset, offset + buf.length);
+      offset += buf.length;
+      return dest;
+    });
+  }
+
+  /**
+   * Single buffer version of getDests_.
+   *
+   * @param {!Uint8Array} buf A view from getMem_.
+   * @return {!Uint8Array|undefined}
+   */
+  getDest_(buf) {
+    return this.getDests_([buf])?.[0];
+  }
+
+  /**
+   * Copy data a handler wrote into staging views into program memory.
+   *
+   * @param {!Array<!Uint8Array>} bufs Views from getMem_.
+   * @param {!Array<!Uint8Array>|undefined} dests The views from getDests_.
+   * @param {number} nread How many bytes the handler wrote.
+   */
+  finishDests_(bufs, dests, nread) {
+    if (dests === undefined || dests === bufs) {
+      return;
+    }
+    for (let i = 0; i < bufs.length && nread > 0; ++i) {
+      const length = Math.min(nread, bufs[i].length);
+      bufs[i].set(dests[i].subarray(0, length));
+      nread -= length;
+    }
+  }
+
+  /**
+   * Single buffer version of finishDests_.
+   *
+   * @param {!Uint8Array} buf A view from getMem_.
+   * @param {!Uint8Array|undefined} dest The view from getDest_.
+   * @param {number} nread How many bytes the handler wrote.
+   */
+  finishDest_(buf, dest, nread) {
+    if (dest !== undefined && dest !== buf) {
+      buf.set(dest.subarray(0, nread));
+    }
+  }
+
   /**
    * @param {!WASI_t.pointer} base
    * @param {!WASI_t.u32=} offset
@@ -68,6 +161,50 @@ export class Base {
     return this.process_.getView(base, offset);
   }
 
+  /**
+   * Get a view of all of program memory.
+   *
+   * Use absolute addresses with this rather than creating a new view for every
+   * pointer (see getView_).  It's cached by the process, so it's cheap to call
+   * for every syscall.
+   *
+   * @return {!WasiView}
+   * @suppress {checkTypes} WasiView$$module$js$dataview naming confusion.
+   */
+  getMemView_() {
+    return this.process_.getMemView();
+  }
+
+  /**
+   * Pass along any signals a waiting handler returned.
+   *
+   * @param {{events: !Array, signals: (undefined|!Array<number>)}} ret The
+   *     handler's result.
+   * @return {boolean} Whether the syscall should fail with EINTR, i.e. signals
+   *     were delivered and there are no other events.
+   */
+  deliverSignals_(ret) {
+    if (ret.signals === undefined) {
+      return false;
+    }
+
+    const exports = this.process_.instance_.exports;
+    if (this.process_.queue_signals?.(ret.signals)) {
+      // The program checks its pending bitmap once this returns, so we don't
+      // have to call back into WASM for every signal.
+    } else if (exports.__wassh_signal_deliver !== undefined) {
+      ret.signals.forEach(
+          /** @type {{__wassh_signal_deliver: function(number)}} */ (
+              exports).__wassh_signal_deliver);
+    } else {
+      return false;
+    }
+
+    // If there are no other events, return EINTR so the caller knows that a
+    // signal came in.  It should retry the call automatically.
+    return ret.events.length === 0;
+  }
+
   /**
    * Log a debug message.
    *
@@ -142,6 +279,60 @@ export class Base {
     }
   }
 
+  /**
+   * @param {function(...*)} func
+   * @param {string} name The syscall name to record.
+   * @param {!Profiler} profiler
+   * @return {function(...*)}
+   */
+  createProfiler_(func, name, profiler) {
+    const end = () => profiler.end(name);
+    return (...args) => {
+      profiler.begin();
+      let ret;
+      try {
+        ret = func(...args);
+        return ret;
+      } finally {
+        if (ret instanceof Promise) {
+          ret.then(end, end);
+        } else {
+          end();
+        }
+      }
+    };
+  }
+
+  /**
+   * Count the bytes moved by all our bound handlers.
+   *
+   * @param {!Profiler} profiler
+   */
+  profileHandlers_(profiler) {
+    const methods = [
+      ...this.getSyscalls_().map((key) => `handle_${key.slice(4)}`),
+      ...Object.keys(this.getOptionalHandlers_()),
+    ];
+    methods.forEach((method) => {
+      const handler = this[method];
+      if (handler === undefined) {
+        return;
+      }
+
+      this[method] = (...args) => {
+        const ret = handler(...args);
+        if (ret instanceof Promise) {
+          return ret.then((ret) => {
+            profiler.addBytes(countBytes(args, ret));
+            return ret;
+          });
+        }
+        profiler.addBytes(countBytes(args, ret));
+        return ret;
+      };
+    });
+  }
+
   /**
    * A stub func that always returns ENOSYS.
    *
@@ -184,25 +375,54 @@ export class Base {
 
     this.getSyscalls_().forEach((key) => {
       const method = `handle_${key.slice(4)}`;
-      let i;
-      for (i = 0; i < handlers.length; ++i) {
-        const handler = handlers[i];
-        if (method in handler) {
-          if (handler[method] instanceof AsyncFunction &&
-              !(this[key] instanceof AsyncFunction)) {
-            throw new util.ApiViolation(
-                `async ${method} requires async ${key}`);
-          }
-          this[method] = this.createTracer_(
-              handler[method].bind(handler), `handler: ${method}`);
-          break;
-        }
-      }
-      if (i == handlers.length) {
+      if (!this.bindHandler_(handlers, method, key)) {
         this[method] = this.createTracer_(
             this.enosysStub_, `handler: enosysStub_: ${method}`);
       }
     });
+
+    // Optional handlers are left unset so entries can check for them.
+    Object.entries(this.getOptionalHandlers_()).forEach(([method, key]) => {
+      this.bindHandler_(handlers, method, key);
+    });
+  }
+
+  /**
+   * Bind the first implementation of a handler.
+   *
+   * @param {!Array<!Object>} handlers Array of SyscallHandler objects.
+   * @param {string} method The "handle_xxx" method to bind.
+   * @param {string} key The "sys_xxx" entry that calls it.
+   * @return {boolean} Whether a handler was found.
+   */
+  bindHandler_(handlers, method, key) {
+    for (let i = 0; i < handlers.length; ++i) {
+      const handler = handlers[i];
+      if (method in handler) {
+        if (handler[method] instanceof AsyncFunction &&
+            !(this[key] instanceof AsyncFunction)) {
+          throw new util.ApiViolation(
+              `async ${method} requires async ${key}`);
+        }
+        this[method] = this.createTracer_(
+            handler[method].bind(handler), `handler: ${method}`);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Get the optional handlers that entries use when available.
+   *
+   * These don't have a syscall entry of their own, so they don't get ENOSYS
+   * stubs when no handler implements them.
+   *
+   * @return {!Object<string, string>} Map of "handle_xxx" methods to the
+   *     "sys_xxx" entry that calls it.
+   */
+  getOptionalHandlers_() {
+    return {};
   }
 
   /**
@@ -220,11 +440,19 @@ export class Base {
    * @override
    */
   getImports() {
+    const profiler = this.process_?.profiler;
+    if (profiler) {
+      this.profileHandlers_(profiler);
+    }
+
     const entries = {};
     this.getSyscalls_().forEach((key) => {
       let func = this.createTracer_(
           this.unhandledExceptionWrapper_.bind(this, this[key].bind(this)),
           `entry: ${key}`);
+      if (profiler) {
+        func = this.createProfiler_(func, key.slice(4), profiler);
+      }
       if (this[key] instanceof AsyncFunction) {
         func = new WebAssembly.Suspending(func);
       }
@@ -238,9 +466,123 @@ export class Base {
  * WASI syscall entries.
  */
 export class WasiPreview1 extends Base {
+  /**
+   * @return {!Object<string, string>}
+   * @override
+   */
+  getOptionalHandlers_() {
+    return {
+      'handle_fd_preadv': 'sys_fd_pread',
+      'handle_fd_pwritev': 'sys_fd_pwrite',
+      'handle_fd_readv': 'sys_fd_read',
+      'handle_fd_writev': 'sys_fd_write',
+    };
+  }
+
+  /**
+   * Get views of all the buffers in an iovec array.
+   *
+   * @param {!WASI_t.pointer} iovs_ptr
+   * @param {!WASI_t.size} iovs_len
+   * @return {!Array<!Uint8Array>}
+   */
+  getIovecs_(iovs_ptr, iovs_len) {
+    if (this.iovPtrs_.length < iovs_len) {
+      this.iovPtrs_ = new Uint32Array(iovs_len);
+      this.iovLens_ = new Uint32Array(iovs_len);
+    }
+    structs.readIovecs(this.getMemView_(), iovs_ptr, iovs_len, this.iovPtrs_,
+                       this.iovLens_);
+    const bufs = new Array(iovs_len);
+    for (let i = 0; i < iovs_len; ++i) {
+      const ptr = this.iovPtrs_[i];
+      bufs[i] = this.getMem_(ptr, ptr + this.iovLens_[i]);
+    }
+    return bufs;
+  }
+
+  /**
+   * Call a vectored read handler.
+   *
+   * The handler either writes into the buffers directly (see getDest_), or
+   * returns all the data in one buffer for us to scatter across them.
+   *
+   * @param {function(!Array<number>, (!Array<!Uint8Array>|undefined)):
+   *     (!WASI_t.errno|{buf: (!Uint8Array|undefined),
+   *                     nread: (!WASI_t.size|undefined)})} handler
+   * @param {!WASI_t.pointer} iovs_ptr
+   * @param {!WASI_t.size} iovs_len
+   * @param {!WASI_t.pointer} nread_ptr
+   * @return {!WASI_t.errno}
+   */
+  readv_(handler, iovs_ptr, iovs_len, nread_ptr) {
+    const bufs = this.getIovecs_(iovs_ptr, iovs_len);
+    const dests = this.getDests_(bufs);
+    const ret = handler(bufs.map((buf) => buf.length), dests);
+    if (typeof ret === 'number') {
+      return ret;
+    }
+
+    let nread = ret.nread;
+    if (ret.buf === undefined) {
+      this.finishDests_(bufs, dests, nread);
+    } else {
+      const u8 = new Uint8Array(ret.buf);
+      let off = 0;
+      for (let i = 0; i < bufs.length && off < u8.length; ++i) {
+        const chunk = u8.subarray(off, off + bufs[i].length);
+        bufs[i].set(chunk);
+        off += chunk.length;
+      }
+      if (off < u8.length) {
+        this.logError('vectored read returned too many bytes: ' +
+                      `${u8.length} > ${off}`);
+      }
+      if (nread === undefined) {
+        nread = off;
+      }
+    }
+
+    const dv = this.getMemView_();
+    dv.setUint32(nread_ptr, nread, true);
+    return WASI.errno.ESUCCESS;
+  }
+
+  /**
+   * Call a vectored write handler.
+   *
+   * @param {function(!Array<!Uint8Array>):
+   *     (!WASI_t.errno|{nwritten: !WASI_t.size})} handler
+   * @param {!WASI_t.pointer} iovs_ptr
+   * @param {!WASI_t.size} iovs_len
+   * @param {!WASI_t.pointer} nwritten_ptr
+   * @return {!WASI_t.errno}
+   */
+  writev_(handler, iovs_ptr, iovs_len, nwritten_ptr) {
+    const bufs = this.getIovecs_(iovs_ptr, iovs_len)
+        .map((buf) => Uint8Array.from(buf));
+    const ret = handler(bufs);
+    let nwritten;
+    if (typeof ret === 'number') {
+      if (ret !== WASI.errno.ESUCCESS) {
+        return ret;
+      }
+      nwritten = bufs.reduce((sum, buf) => sum + buf.length, 0);
+    } else {
+      nwritten = ret.nwritten;
+    }
+
+    const dv = this.getMemView_();
+    dv.setUint32(nwritten_ptr, nwritten, true);
+    return WASI.errno.ESUCCESS;
+  }
+
   constructor(...args) {
     super(...args);
     this.namespace = 'wasi_snapshot_preview1';
+    // Scratch space for decoding iovec arrays (see getIovecs_).
+    this.iovPtrs_ = new Uint32Array(16);
+    this.iovLens_ = new Uint32Array(16);
   }
 
   /**
@@ -275,11 +617,11 @@ export class WasiPreview1 extends Base {
     }
 
     const te = new TextEncoder();
-    const dvArgv = this.getView_(argv, 4 * ret.argv.length);
+    const dv = this.getMemView_();
     let ptr = argv_buf;
     for (let i = 0; i < ret.argv.length; ++i) {
       const buf = this.getMem_(ptr);
-      dvArgv.setUint32(i * 4, ptr, true);
+      dv.setUint32(argv + i * 4, ptr, true);
       let length;
       const arg = ret.argv[i];
       if (typeof arg === 'string') {
@@ -306,10 +648,9 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dvSize = this.getView_(argc, 4);
-    const dvBuf = this.getView_(argv_size, 4);
-    dvSize.setUint32(0, ret.argc, true);
-    dvBuf.setUint32(0, ret.argv_size, true);
+    const dv = this.getMemView_();
+    dv.setUint32(argc, ret.argc, true);
+    dv.setUint32(argv_size, ret.argv_size, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -325,8 +666,8 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dv = this.getView_(resolution_ptr, 8);
-    dv.setBigUint64(0, ret.res, true);
+    const dv = this.getMemView_();
+    dv.setBigUint64(resolution_ptr, ret.res, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -344,8 +685,8 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dv = this.getView_(time_ptr, 8);
-    dv.setBigUint64(0, ret.now, true);
+    const dv = this.getMemView_();
+    dv.setBigUint64(time_ptr, ret.now, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -363,11 +704,11 @@ export class WasiPreview1 extends Base {
 
     const te = new TextEncoder();
     const env = ret.env;
-    const dvEnvp = this.getView_(envp, 4 * (env.length + 1));
+    const dv = this.getMemView_();
     let ptr = env_buf;
     for (let i = 0; i < env.length; ++i) {
       const buf = this.getMem_(ptr);
-      dvEnvp.setUint32(i * 4, ptr, true);
+      dv.setUint32(envp + i * 4, ptr, true);
       let length;
       const arg = env[i];
       if (typeof arg === 'string') {
@@ -380,7 +721,7 @@ export class WasiPreview1 extends Base {
       ptr += length + 1;
     }
     // The NULL terminator.
-    dvEnvp.setUint32(4 * env.length, 0, true);
+    dv.setUint32(envp + 4 * env.length, 0, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -396,12 +737,11 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dvSize = this.getView_(env_size, 4);
-    const dvBuf = this.getView_(env_buf, 4);
+    const dv = this.getMemView_();
     // Include one extra for NULL terminator.
     // TODO(vapier): Is this necessary ?
-    dvSize.setUint32(0, ret.length + 1, true);
-    dvBuf.setUint32(0, ret.size, true);
+    dv.setUint32(env_size, ret.length + 1, true);
+    dv.setUint32(env_buf, ret.size, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -458,8 +798,8 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dv = this.getView_(buf);
-    dv.setFdstat(0, ret, true);
+    const dv = this.getMemView_();
+    dv.setFdstat(buf, ret, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -497,8 +837,8 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dv = this.getView_(filestat_ptr);
-    dv.setFilestat(0, ret, true);
+    const dv = this.getMemView_();
+    dv.setFilestat(filestat_ptr, ret, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -534,16 +874,19 @@ export class WasiPreview1 extends Base {
    * @override
    */
   sys_fd_pread(fd, iovs_ptr, iovs_len, offset, nread_ptr) {
-    const dvIovs = this.getView_(iovs_ptr);
+    if (this.handle_fd_preadv !== undefined) {
+      return this.readv_(
+          (lengths, dests) => this.handle_fd_preadv(fd, lengths, offset, dests),
+          iovs_ptr, iovs_len, nread_ptr);
+    }
+
     let nread = 0;
-    let iovs_off = 0;
-    for (let i = 0; i < iovs_len; ++i) {
-      const iovec = dvIovs.getIovec(iovs_off, true);
-      const buf = this.getMem_(iovec.buf, iovec.buf + iovec.buf_len);
-      const ret = this.handle_fd_pread(fd, iovec.buf_len, offset);
+    for (const buf of this.getIovecs_(iovs_ptr, iovs_len)) {
+      const dest = this.getDest_(buf);
+      const ret = this.handle_fd_pread(fd, buf.length, offset, dest);
       if (typeof ret === 'number') {
         if (ret === WASI.errno.ESUCCESS) {
-          nread += iovec.buf_len;
+          nread += buf.length;
         } else {
           return ret;
         }
@@ -554,15 +897,15 @@ export class WasiPreview1 extends Base {
           if (ret.nread === undefined) {
             ret.nread = u8.length;
           }
+        } else {
+          this.finishDest_(buf, dest, ret.nread);
         }
         nread += ret.nread;
       }
       offset += BigInt(nread);
-      iovs_off += iovec.struct_size;
     }
 
-    const dvNread = this.getView_(nread_ptr, 4);
-    dvNread.setUint32(0, nread, true);
+    this.getMemView_().setUint32(nread_ptr, nread, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -597,11 +940,11 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dv = this.getView_(buf, 8);
-    dv.setUint8(0, 0 /* __WASI_PREOPENTYPE_DIR */);
+    const dv = this.getMemView_();
+    dv.setUint8(buf, 0 /* __WASI_PREOPENTYPE_DIR */);
 
     const te = new TextEncoder();
-    dv.setUint32(4, te.encode(ret.path).length, true);
+    dv.setUint32(buf + 4, te.encode(ret.path).length, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -615,16 +958,18 @@ export class WasiPreview1 extends Base {
    * @override
    */
   sys_fd_pwrite(fd, iovs_ptr, iovs_len, offset, nwritten_ptr) {
-    const dvIovs = this.getView_(iovs_ptr);
+    if (this.handle_fd_pwritev !== undefined) {
+      return this.writev_(
+          (bufs) => this.handle_fd_pwritev(fd, bufs, offset),
+          iovs_ptr, iovs_len, nwritten_ptr);
+    }
+
     let nwritten = 0;
-    let iovs_off = 0;
-    for (let i = 0; i < iovs_len; ++i) {
-      const iovec = dvIovs.getIovec(iovs_off, true);
-      const buf = this.getMem_(iovec.buf, iovec.buf + iovec.buf_len);
+    for (const buf of this.getIovecs_(iovs_ptr, iovs_len)) {
       const ret = this.handle_fd_pwrite(fd, Uint8Array.from(buf), offset);
       if (typeof ret === 'number') {
         if (ret === WASI.errno.ESUCCESS) {
-          nwritten += iovec.buf_len;
+          nwritten += buf.length;
         } else {
           return ret;
         }
@@ -632,11 +977,9 @@ export class WasiPreview1 extends Base {
         nwritten += ret.nwritten;
       }
       offset += BigInt(nwritten);
-      iovs_off += iovec.struct_size;
     }
 
-    const dvWritten = this.getView_(nwritten_ptr, 4);
-    dvWritten.setUint32(0, nwritten, true);
+    this.getMemView_().setUint32(nwritten_ptr, nwritten, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -649,38 +992,41 @@ export class WasiPreview1 extends Base {
    * @override
    */
   sys_fd_read(fd, iovs_ptr, iovs_len, nread_ptr) {
-    const dvIovs = this.getView_(iovs_ptr);
+    if (this.handle_fd_readv !== undefined) {
+      return this.readv_(
+          (lengths, dests) => this.handle_fd_readv(fd, lengths, dests),
+          iovs_ptr, iovs_len, nread_ptr);
+    }
+
     let nread = 0;
-    let iovs_off = 0;
-    for (let i = 0; i < iovs_len; ++i) {
-      const iovec = dvIovs.getIovec(iovs_off, true);
-      const buf = this.getMem_(iovec.buf, iovec.buf + iovec.buf_len);
-      const ret = this.handle_fd_read(fd, iovec.buf_len);
+    for (const buf of this.getIovecs_(iovs_ptr, iovs_len)) {
+      const dest = this.getDest_(buf);
+      const ret = this.handle_fd_read(fd, buf.length, dest);
       if (typeof ret === 'number') {
         if (ret === WASI.errno.ESUCCESS) {
-          nread += iovec.buf_len;
+          nread += buf.length;
         } else {
           return ret;
         }
       } else {
         if (ret.buf !== undefined) {
           const u8 = new Uint8Array(ret.buf);
-          if (u8.length > iovec.buf_len) {
+          if (u8.length > buf.length) {
             this.logError('handle_fd_read returned too many bytes: ' +
-                          `${u8.length} > ${iovec.buf_len}`);
+                          `${u8.length} > ${buf.length}`);
           }
           buf.set(u8);
           if (ret.nread === undefined) {
             ret.nread = u8.length;
           }
+        } else {
+          this.finishDest_(buf, dest, ret.nread);
         }
         nread += ret.nread;
       }
-      iovs_off += iovec.struct_size;
     }
 
-    const dvNread = this.getView_(nread_ptr, 4);
-    dvNread.setUint32(0, nread, true);
+    this.getMemView_().setUint32(nread_ptr, nread, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -700,8 +1046,8 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dv = this.getView_(size_ptr);
-    dv.setUint32(0, ret.length, true);
+    const dv = this.getMemView_();
+    dv.setUint32(size_ptr, ret.length, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -733,8 +1079,8 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dv = this.getView_(newoffset_ptr, 8);
-    dv.setBigUint64(0, ret.newoffset, true);
+    const dv = this.getMemView_();
+    dv.setBigUint64(newoffset_ptr, ret.newoffset, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -759,8 +1105,8 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dv = this.getView_(offset_ptr, 8);
-    dv.setBigUint64(0, ret.offset, true);
+    const dv = this.getMemView_();
+    dv.setBigUint64(offset_ptr, ret.offset, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -773,27 +1119,27 @@ export class WasiPreview1 extends Base {
    * @override
    */
   sys_fd_write(fd, iovs_ptr, iovs_len, nwritten_ptr) {
-    const dvIovs = this.getView_(iovs_ptr);
+    if (this.handle_fd_writev !== undefined) {
+      return this.writev_(
+          (bufs) => this.handle_fd_writev(fd, bufs),
+          iovs_ptr, iovs_len, nwritten_ptr);
+    }
+
     let nwritten = 0;
-    let iovs_off = 0;
-    for (let i = 0; i < iovs_len; ++i) {
-      const iovec = dvIovs.getIovec(iovs_off, true);
-      const buf = this.getMem_(iovec.buf, iovec.buf + iovec.buf_len);
+    for (const buf of this.getIovecs_(iovs_ptr, iovs_len)) {
       const ret = this.handle_fd_write(fd, Uint8Array.from(buf));
       if (typeof ret === 'number') {
         if (ret === WASI.errno.ESUCCESS) {
-          nwritten += iovec.buf_len;
+          nwritten += buf.length;
         } else {
           return ret;
         }
       } else {
         nwritten += ret.nwritten;
       }
-      iovs_off += iovec.struct_size;
     }
 
-    const dvWritten = this.getView_(nwritten_ptr, 4);
-    dvWritten.setUint32(0, nwritten, true);
+    this.getMemView_().setUint32(nwritten_ptr, nwritten, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -833,8 +1179,8 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dv = this.getView_(filestat_ptr);
-    dv.setFilestat(0, ret, true);
+    const dv = this.getMemView_();
+    dv.setFilestat(filestat_ptr, ret, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -914,8 +1260,8 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dv = this.getView_(fd_ptr, 4);
-    dv.setUint32(0, ret.fd, true);
+    const dv = this.getMemView_();
+    dv.setUint32(fd_ptr, ret.fd, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -941,8 +1287,8 @@ export class WasiPreview1 extends Base {
       return ret;
     }
 
-    const dv = this.getView_(bufused_ptr);
-    dv.setUint32(0, ret.length, true);
+    const dv = this.getMemView_();
+    dv.setUint32(bufused_ptr, ret.length, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -1035,17 +1381,16 @@ export class WasiPreview1 extends Base {
    * @override
    */
   sys_poll_oneoff(subscriptions_ptr, events_ptr, nsubscriptions, nevents_ptr) {
-    const dvNevents = this.getView_(nevents_ptr);
+    const dv = this.getMemView_();
     if (nsubscriptions <= 0) {
-      dvNevents.setUint32(0, 0, true);
+      dv.setUint32(nevents_ptr, 0, true);
       return WASI.errno.ESUCCESS;
     }
 
     const subscriptions = Array(nsubscriptions);
-    const dvSubscriptions = this.getView_(subscriptions_ptr);
     let offset = 0;
     for (let i = 0; i < nsubscriptions; ++i) {
-      const subscription = dvSubscriptions.getSubscription(offset, true);
+      const subscription = dv.getSubscription(subscriptions_ptr + offset, true);
       if (subscription.tag > WASI.eventtype.ENUM_END) {
         return WASI.errno.EINVAL;
       }
@@ -1060,25 +1405,16 @@ export class WasiPreview1 extends Base {
 
     // TODO(vapier): This call does not belong here.  This should be in wassh.
     // But the current sys_poll_oneoff logic is not factored well for hooking.
-    if (ret.signals !== undefined &&
-        this.process_.instance_.exports.__wassh_signal_deliver !== undefined) {
-      ret.signals.forEach(
-          /** @type {{__wassh_signal_deliver: function(number)}} */ (
-              this.process_.instance_.exports).__wassh_signal_deliver);
-      if (ret.events.length === 0) {
-        // If there are no other events, return EINTR so the caller knows that a
-        // signal came in.  It should retry the call automatically.
-        return WASI.errno.EINTR;
-      }
+    if (this.deliverSignals_(ret)) {
+      return WASI.errno.EINTR;
     }
 
-    const dvEvents = this.getView_(events_ptr);
     offset = 0;
     ret.events.forEach((event) => {
-      dvEvents.setEvent(offset, event, true);
+      dv.setEvent(events_ptr + offset, event, true);
       offset += WasiView.event_t.struct_size;
     });
-    dvNevents.setUint32(0, ret.events.length, true);
+    dv.setUint32(nevents_ptr, ret.events.length, true);
     return WASI.errno.ESUCCESS;
   }
 
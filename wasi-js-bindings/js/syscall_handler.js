@@ -6,10 +6,22 @@
  * @fileoverview Syscall handler APIs.  These actually implement syscalls.
  */
 
+import {Slot, SlotClient} from './scheduler.js';
+import {SyscallCache} from './syscall_cache.js';
 import {SyscallLock} from './syscall_lock.js';
+import {TraceReader, TraceWriter, captureOutput, kNoReturn, kOutputArgs,
+        restoreOutput, sameArg, traceArg} from './syscall_trace.js';
 import * as util from './util.js';
 import * as WASI from './wasi.js';
 
+/**
+ * The userdata the program gives the clock subscription of a poll_oneoff that
+ * also watches pipes in its own memory.  Those polls end early (without any
+ * events) when the program flags a pipe change (see fd_pipe_notify), so it can
+ * recheck the pipes.
+ */
+export const kPipePollUserdata = 0xffffffffffffffffn;
+
 /**
  * Base class for creating syscall handlers.
  *
@@ -58,11 +70,18 @@ export class Base {
  * @unrestricted https://github.com/google/closure-compiler/issues/1737
  */
 export class ProxyWasiPreview1 extends Base {
-  constructor(worker, sab, handlers) {
+  /**
+   * @param {!Object} worker The BackgroundWorker.
+   * @param {!SharedArrayBuffer} sab The SyscallLock memory.
+   * @param {!Set<string>} handlers The handlers the main thread implements.
+   * @param {?Slot=} slot Queue syscalls via this Scheduler slot when possible.
+   */
+  constructor(worker, sab, handlers, slot = null) {
     super();
 
     this.worker = worker;
     this.syscallLock = new SyscallLock(sab);
+    this.slot_ = slot ? new SlotClient(slot) : null;
 
     handlers.forEach((handler) => {
       if (handler.startsWith('handle_') && !(handler in this)) {
@@ -75,8 +94,15 @@ export class ProxyWasiPreview1 extends Base {
     if (!this.syscallLock.lock()) {
       throw new Error('Overlapped syscall');
     }
-    this.worker.postMessage('syscall', ...args);
+    const profiler = this.process_?.profiler;
+    const start = profiler ? performance.now() : 0;
+    if (!this.slot_?.submit(this.syscallLock, args)) {
+      this.worker.postMessage('syscall', ...args);
+    }
     this.syscallLock.wait();
+    if (profiler) {
+      profiler.addWait(performance.now() - start);
+    }
     const ret = this.syscallLock.getRetcode();
     if (ret == -1) {
       return this.syscallLock.getData();
@@ -91,6 +117,8 @@ export class ProxyWasiPreview1 extends Base {
    * @override
    */
   handle_proc_exit(status) {
+    this.worker.postProfile(this.process_);
+    this.worker.postTrace(this.process_);
     this.worker.postMessage('exit', status);
     return WASI.errno.ESUCCESS;
   }
@@ -101,11 +129,138 @@ export class ProxyWasiPreview1 extends Base {
    * @override
    */
   handle_proc_raise(signal) {
+    this.worker.postProfile(this.process_);
+    this.worker.postTrace(this.process_);
     this.worker.postMessage('signal', signal);
     return WASI.errno.ESUCCESS;
   }
 }
 
+/**
+ * This handler answers syscalls from the cache the main thread maintains.
+ *
+ * Put it in front of ProxyWasiPreview1 so cache hits don't have to cross to the
+ * main thread.  Misses are passed to the proxy, and the main thread fills the
+ * cache with the result (see Process.Background).
+ */
+export class CachedWasiPreview1 extends Base {
+  /**
+   * @param {!SharedArrayBuffer} sab The SyscallCache memory.
+   * @param {!ProxyWasiPreview1} proxy The handler for cache misses.
+   */
+  constructor(sab, proxy) {
+    super();
+
+    this.cache = new SyscallCache(sab);
+    this.proxy_ = proxy;
+  }
+
+  /**
+   * Pass a syscall on to the proxy.
+   *
+   * @param {string} method The handler name.
+   * @param {...*} args The handler arguments.
+   * @return {*} The proxied result.
+   */
+  miss_(method, ...args) {
+    if (method in this.proxy_) {
+      return this.proxy_[method](...args);
+    }
+    return WASI.errno.ENOSYS;
+  }
+
+  /**
+   * @param {!WASI_t.fd} fd
+   * @return {!WASI_t.errno|!WASI_t.fdstat}
+   * @override
+   */
+  handle_fd_fdstat_get(fd) {
+    return this.cache.getFdstat(fd) ??
+        this.miss_('handle_fd_fdstat_get', fd);
+  }
+
+  /**
+   * @param {!WASI_t.fd} fd
+   * @return {!WASI_t.errno|
+   *          {row: number, col: number, xpixel: number, ypixel: number}}
+   */
+  handle_tty_get_window_size(fd) {
+    return this.cache.getWindowSize() ??
+        this.miss_('handle_tty_get_window_size', fd);
+  }
+
+  /**
+   * Flag a pipe change for pollers.  This doesn't need the main thread.
+   *
+   * @return {!WASI_t.errno}
+   */
+  handle_fd_pipe_notify() {
+    this.cache.setPipesPending();
+    return WASI.errno.ESUCCESS;
+  }
+
+  /**
+   * Sleeps that only wait on clocks are done here rather than in the main
+   * thread, which only interrupts them by changing the readiness word when it
+   * has signals to deliver.  Those, and polls on fds, go to the proxy.  Polls
+   * that watch pipes also end when a pipe changes.
+   *
+   * @param {!Array<!WASI_t.subscription>} subscriptions
+   * @return {!WASI_t.errno|
+   *          {events: !Array<!WASI_t.event>,
+   *           signals: (undefined|!Array<number>)}}
+   * @override
+   */
+  handle_poll_oneoff(subscriptions) {
+    if (subscriptions.length === 0 || this.cache.getSignalsPending() ||
+        subscriptions.some(({tag}) => tag !== WASI.eventtype.CLOCK)) {
+      return this.miss_('handle_poll_oneoff', subscriptions);
+    }
+
+    // Find the earliest clock timeout.
+    let deadline;
+    let userdata;
+    for (const subscription of subscriptions) {
+      const ret = util.clockDeadline(subscription.clock);
+      if (typeof ret === 'number') {
+        return ret;
+      }
+
+      if (deadline === undefined || ret.deadline < deadline) {
+        userdata = subscription.userdata;
+        deadline = ret.deadline;
+      }
+    }
+
+    const pipes = subscriptions.some(
+        ({userdata}) => userdata === kPipePollUserdata);
+    let delay;
+    while ((delay = deadline - util.monotonicNow()) > 0) {
+      // Read the word before checking for signals so we can't miss a wakeup.
+      const ready = this.cache.getReady();
+      if (this.cache.getSignalsPending()) {
+        return this.miss_('handle_poll_oneoff', subscriptions);
+      }
+      if (pipes && this.cache.takePipesPending()) {
+        return {events: []};
+      }
+      this.cache.waitReadySync(ready, delay);
+    }
+
+    return {
+      events: [/** @type {!WASI_t.event} */ ({
+        userdata: userdata,
+        error: WASI.errno.ESUCCESS,
+        type: WASI.eventtype.CLOCK,
+        fd_readwrite: {
+          flags: 0,
+          nbytes: 0n,
+        },
+      })],
+    };
+  }
+}
+
 /**
  * How many nanoseconds in one millisecond.
  */
@@ -115,6 +270,15 @@ const kNanosecToMillisec = 1000000;
  * This handler implements syscalls directly.
  */
 export class DirectWasiPreview1 extends Base {
+  constructor() {
+    super();
+
+    // Used to sleep via Atomics.wait when this thread is allowed to block.
+    /** @type {?Int32Array} */
+    this.sleeper_ = typeof SharedArrayBuffer === 'undefined' ?
+        null : new Int32Array(new SharedArrayBuffer(4));
+  }
+
   /**
    * @return {!WASI_t.errno|{argv: !Array<string|!ArrayBufferView>}}
    * @override
@@ -170,7 +334,7 @@ export class DirectWasiPreview1 extends Base {
       }
       case WASI.clock.MONOTONIC: {
         return {
-          now: BigInt(Math.floor(performance.now() * kNanosecToMillisec)),
+          now: BigInt(Math.floor(util.monotonicNow() * kNanosecToMillisec)),
         };
       }
       default:
@@ -245,35 +409,26 @@ export class DirectWasiPreview1 extends Base {
   handle_poll_oneoff(subscriptions) {
     // We can handle clock events only.
     const events = [];
-    const now = BigInt(Date.now());
 
     // Find the earliest clock timeout.
-    let timeout;
+    let deadline;
     let userdata;
-    subscriptions.forEach((subscription) => {
+    for (const subscription of subscriptions) {
       if (subscription.tag === WASI.eventtype.CLOCK) {
-        // The standard C lib doesn't use other clocks, so this is future-proof.
-        if (subscription.clock.id !== WASI.clock.REALTIME) {
-          return WASI.errno.ENOTSUP;
-        }
-
-        let subTimeout;
-        // The timeout is in nanoseconds.  We can do milliseconds at best.
-        subTimeout = subscription.clock.timeout / BigInt(kNanosecToMillisec);
-        if ((subscription.clock.flags & 1) === 0) {
-          // The timeout is relative.
-          subTimeout += now;
+        const ret = util.clockDeadline(subscription.clock);
+        if (typeof ret === 'number') {
+          return ret;
         }
 
-        if (!timeout || subTimeout < timeout) {
+        if (deadline === undefined || ret.deadline < deadline) {
           userdata = subscription.userdata;
-          timeout = subTimeout;
+          deadline = ret.deadline;
         }
       }
-    });
+    }
 
     // If there's a timeout, wait for it.
-    if (timeout !== undefined) {
+    if (deadline !== undefined) {
       events.push(/** @type {!WASI_t.event} */({
         userdata: userdata,
         error: WASI.errno.ESUCCESS,
@@ -284,8 +439,17 @@ export class DirectWasiPreview1 extends Base {
         },
       }));
 
-      while (Date.now() < timeout) {
-        // Burn the cpu.
+      let delay;
+      while ((delay = deadline - util.monotonicNow()) > 0) {
+        // Sleep if this thread is allowed to block, otherwise burn the cpu.
+        if (this.sleeper_ !== null) {
+          try {
+            Atomics.wait(this.sleeper_, 0, 0, delay);
+          } catch (e) {
+            // Main threads may not block.
+            this.sleeper_ = null;
+          }
+        }
       }
     } else {
       // If we found no clock events, but there are other events, then fail.
@@ -340,3 +504,168 @@ export class DirectWasiPreview1 extends Base {
     return WASI.errno.ESUCCESS;
   }
 }
+
+/**
+ * Used to keep async handlers async when wrapping them.
+ */
+const AsyncFunction = (async () => {}).constructor;
+
+/**
+ * This handler records every syscall the other handlers answer.
+ *
+ * Put it in front of the handlers to record, and use the trace with
+ * ReplayWasiPreview1 to run the program again without them.
+ *
+ * @unrestricted https://github.com/google/closure-compiler/issues/1737
+ */
+export class RecordWasiPreview1 extends Base {
+  /**
+   * @param {!Array<!Object>} handlers The handlers to record.
+   */
+  constructor(handlers) {
+    super();
+
+    this.handlers_ = handlers;
+    /** @const {!TraceWriter} */
+    this.trace = new TraceWriter();
+
+    // Wrap the first implementation of each syscall like SyscallEntry does.
+    handlers.forEach((handler) => {
+      for (const method of util.getAllPropertyNames(handler)) {
+        if (method.startsWith('handle_') && !(method in this)) {
+          this[method] = this.wrap_(method.slice(7), handler, method);
+        }
+      }
+    });
+  }
+
+  /**
+   * @param {!Process} process
+   * @override
+   */
+  setProcess(process) {
+    super.setProcess(process);
+    this.handlers_.forEach((handler) => handler.setProcess(process));
+  }
+
+  /**
+   * Create a recording wrapper for a handler.
+   *
+   * @param {string} name The syscall name.
+   * @param {!Object} handler The handler that implements it.
+   * @param {string} method The "handle_xxx" method.
+   * @return {function(...*)}
+   */
+  wrap_(name, handler, method) {
+    const func = handler[method].bind(handler);
+
+    if (kNoReturn.has(name)) {
+      return (...args) => {
+        this.trace.record(name, args, WASI.errno.ESUCCESS);
+        return func(...args);
+      };
+    }
+
+    const outputArg = kOutputArgs[name];
+    const record = (args, ret) => {
+      const out = outputArg === undefined ?
+          null : captureOutput(args[outputArg], ret);
+      this.trace.record(name, args, ret, out);
+      return ret;
+    };
+    if (handler[method] instanceof AsyncFunction) {
+      return async (...args) => record(args, await func(...args));
+    }
+    return (...args) => record(args, func(...args));
+  }
+}
+
+/**
+ * This handler answers syscalls from a trace (see RecordWasiPreview1).
+ *
+ * The program has to make the same syscalls in the same order as when it was
+ * recorded, so anything else that might change its behavior (like its argv &
+ * environment) needs to come from the trace too.  Syscalls that don't return
+ * (e.g. proc_exit) are left to the next handler (e.g. DirectWasiPreview1).
+ *
+ * @unrestricted https://github.com/google/closure-compiler/issues/1737
+ */
+export class ReplayWasiPreview1 extends Base {
+  /**
+   * @param {!Uint8Array|!ArrayBuffer} trace The recorded trace.
+   * @param {{
+   *   checkArgs: (boolean|undefined),
+   * }=} options Whether to make sure the program passes the same arguments as
+   *     when it was recorded.
+   */
+  constructor(trace, {checkArgs = true} = {}) {
+    super();
+
+    // Decode everything up front so replays only spend time in the program.
+    /** @const {!Array<!Object>} */
+    this.records_ = new TraceReader(trace).readAll();
+    this.pos_ = 0;
+    this.checkArgs_ = checkArgs;
+
+    this.records_.forEach(({name}) => {
+      const method = `handle_${name}`;
+      if (!kNoReturn.has(name) && !(method in this)) {
+        this[method] = (...args) => this.replay_(name, args);
+      }
+    });
+  }
+
+  /**
+   * @return {boolean} Whether every recorded syscall has been replayed.
+   */
+  isDone() {
+    return this.records_.slice(this.pos_).every(
+        ({name}) => kNoReturn.has(name));
+  }
+
+  /**
+   * Answer the next syscall from the trace.
+   *
+   * @param {string} name The syscall name.
+   * @param {!Array<*>} args The handler arguments.
+   * @return {*} The recorded result.
+   */
+  replay_(name, args) {
+    // Skip the calls the next handler answers.
+    let record;
+    do {
+      record = this.records_[this.pos_++];
+    } while (record !== undefined && kNoReturn.has(record.name));
+
+    if (record === undefined) {
+      throw new Error(`Replay: ${name} called after the end of the trace`);
+    }
+    if (record.name !== name) {
+      throw new Error(`Replay: syscall #${this.pos_ - 1} is ${record.name}, ` +
+                      `but program called ${name}`);
+    }
+
+    const outputArg = kOutputArgs[name];
+    if (this.checkArgs_) {
+      args.forEach((arg, i) => {
+        if (i !== outputArg &&
+            !sameArg(traceArg(arg), record.args[i] ?? null)) {
+          throw new Error(`Replay: syscall #${this.pos_ - 1} ${name} ` +
+                          `argument ${i} changed`);
+        }
+      });
+    }
+
+    let ret = record.ret;
+    if (record.out !== null) {
+      const dest = args[outputArg];
+      if (dest === undefined || dest === null) {
+        // The program memory isn't shared, so return the data instead.
+        ret = {...ret, buf: record.out};
+      } else {
+        restoreOutput(dest, record.out);
+      }
+    }
+    return ret;
+  }
+}
@@ -15,6 +15,593 @@ import * as util from './util.js';
 const BIGINT_MAGIC = '_WASI\x00BigInt\x01';
 const ARRAY_BUFFER_MAGIC = '_WASI\x00ArrayBuffer\x01';
 
+/**
+ * The first byte of data using the binary encoding.
+ *
+ * This can never start the JSON encoding as it isn't valid UTF-8.
+ */
+const BINARY_MAGIC = 0xff;
+
+/**
+ * The first byte of data using a fixed layout, followed by the Shape.
+ *
+ * Like BINARY_MAGIC, this can never start the JSON encoding.
+ */
+const SHAPE_MAGIC = 0xfe;
+
+/**
+ * Fixed layouts for the most common syscall results.
+ *
+ * These skip the value tags & key strings of the generic binary encoding, so
+ * they're just a few fixed size fields.  Results that don't fit their shape
+ * exactly (e.g. extra members) fall back to the generic encoding.
+ *
+ * Errnos never need any of this as they're passed in the retcode word.
+ *
+ * @enum {number}
+ */
+export const Shape = {
+  // {buf: !Uint8Array} and/or {nread: number}.
+  READ: 0,
+  FILESTAT: 1,
+  FDSTAT: 2,
+  // {family: number, address: !Array<number>, port: number}.
+  SOCKADDR: 3,
+  // READ plus {domain: number, address: !Array<number>, port: number}.
+  RECVFROM: 4,
+};
+
+/**
+ * The shape of each syscall's results.
+ *
+ * @const {!Map<string, !Shape>}
+ */
+const SYSCALL_SHAPES = new Map([
+  ['fd_fdstat_get', Shape.FDSTAT],
+  ['fd_filestat_get', Shape.FILESTAT],
+  ['fd_pread', Shape.READ],
+  ['fd_preadv', Shape.READ],
+  ['fd_read', Shape.READ],
+  ['fd_readv', Shape.READ],
+  ['path_filestat_get', Shape.FILESTAT],
+  ['sock_get_name', Shape.SOCKADDR],
+  ['sock_recvfrom', Shape.RECVFROM],
+]);
+
+/**
+ * The 64-bit members of a filestat, in wire order.
+ */
+const FILESTAT_U64S = ['dev', 'ino', 'nlink', 'size', 'atim', 'mtim', 'ctim'];
+
+/**
+ * Count the defined members of a plain object.
+ *
+ * @param {!Object} obj
+ * @return {number} The count, or -1 if it isn't a plain object.
+ */
+function countMembers(obj) {
+  const proto = Object.getPrototypeOf(obj);
+  if (proto !== Object.prototype && proto !== null) {
+    return -1;
+  }
+  let ret = 0;
+  for (const key in obj) {
+    if (obj[key] !== undefined) {
+      ++ret;
+    }
+  }
+  return ret;
+}
+
+/**
+ * Value tags for the binary encoding.
+ *
+ * @enum {number}
+ */
+const Tag = {
+  NULL: 0,
+  FALSE: 1,
+  TRUE: 2,
+  INT32: 3,
+  FLOAT64: 4,
+  BIGINT64: 5,
+  BIGUINT64: 6,
+  STRING: 7,
+  TYPED_ARRAY: 8,
+  ARRAY: 9,
+  OBJECT: 10,
+};
+
+/**
+ * Typed arrays the binary encoding can pass.  The index is the wire value.
+ */
+const TYPED_ARRAYS = [
+  Uint8Array, Int8Array, Uint8ClampedArray, Uint16Array, Int16Array,
+  Uint32Array, Int32Array, Float32Array, Float64Array, BigUint64Array,
+  BigInt64Array,
+];
+
+/**
+ * Thrown when a value can't use the binary encoding.
+ */
+export class UnsupportedValue extends Error {}
+
+/**
+ * Shared encoders to avoid creating them on every call.
+ */
+const textEncoder = new TextEncoder();
+const textDecoder = new TextDecoder();
+
+/**
+ * Serialize syscall results into a byte buffer.
+ *
+ * This handles the plain objects the syscall handlers return (numbers,
+ * bigints, strings, typed arrays, and arrays & objects of those) without going
+ * through JSON or copying buffers more than once.
+ */
+export class BinaryWriter {
+  /**
+   * @param {!Uint8Array} u8 Where to write the data.
+   */
+  constructor(u8) {
+    this.u8 = u8;
+    this.dv = new DataView(u8.buffer, u8.byteOffset, u8.byteLength);
+    this.pos = 0;
+  }
+
+  /**
+   * @param {number} length How many bytes are about to be written.
+   */
+  reserve_(length) {
+    if (this.pos + length > this.u8.length) {
+      throw new RangeError('Syscall data too large');
+    }
+  }
+
+  /** @param {number} value */
+  u8_(value) {
+    this.reserve_(1);
+    this.u8[this.pos++] = value;
+  }
+
+  /** @param {number} value */
+  u32_(value) {
+    this.reserve_(4);
+    this.dv.setUint32(this.pos, value, true);
+    this.pos += 4;
+  }
+
+  /**
+   * Write a length prefixed UTF-8 string.
+   *
+   * @param {string} str
+   */
+  string_(str) {
+    this.reserve_(4 + str.length);
+    const start = this.pos + 4;
+
+    // Most strings are short ASCII (like object keys), so skip the encoder.
+    let i;
+    for (i = 0; i < str.length; ++i) {
+      const c = str.charCodeAt(i);
+      if (c >= 0x80) {
+        break;
+      }
+      this.u8[start + i] = c;
+    }
+
+    let length = i;
+    if (i < str.length) {
+      length = util.encodeIntoSab(
+          textEncoder, str, this.u8.subarray(start, this.u8.length));
+      // If the encoder ran out of space, it stops early.
+      if (textEncoder.encode(str).length !== length) {
+        throw new RangeError('Syscall data too large');
+      }
+    }
+
+    this.dv.setUint32(this.pos, length, true);
+    this.pos = start + length;
+  }
+
+  /**
+   * @param {*} value
+   */
+  value(value) {
+    switch (typeof value) {
+      case 'boolean':
+        this.u8_(value ? Tag.TRUE : Tag.FALSE);
+        return;
+
+      case 'number':
+        if ((value | 0) === value) {
+          this.u8_(Tag.INT32);
+          this.reserve_(4);
+          this.dv.setInt32(this.pos, value, true);
+          this.pos += 4;
+        } else {
+          this.u8_(Tag.FLOAT64);
+          this.reserve_(8);
+          this.dv.setFloat64(this.pos, value, true);
+          this.pos += 8;
+        }
+        return;
+
+      case 'bigint':
+        if (value >= 0n && value < (1n << 64n)) {
+          this.u8_(Tag.BIGUINT64);
+          this.reserve_(8);
+          this.dv.setBigUint64(this.pos, value, true);
+        } else if (value < 0n && value >= -(1n << 63n)) {
+          this.u8_(Tag.BIGINT64);
+          this.reserve_(8);
+          this.dv.setBigInt64(this.pos, value, true);
+        } else {
+          throw new UnsupportedValue();
+        }
+        this.pos += 8;
+        return;
+
+      case 'string':
+        this.u8_(Tag.STRING);
+        this.string_(value);
+        return;
+
+      case 'object':
+        break;
+
+      default:
+        throw new UnsupportedValue();
+    }
+
+    if (value === null) {
+      this.u8_(Tag.NULL);
+      return;
+    }
+
+    if (ArrayBuffer.isView(value)) {
+      const kind = TYPED_ARRAYS.indexOf(value.constructor);
+      if (kind === -1) {
+        throw new UnsupportedValue();
+      }
+      const view = /** @type {!ArrayBufferView} */ (value);
+      this.u8_(Tag.TYPED_ARRAY);
+      this.u8_(kind);
+      this.u32_(view.byteLength);
+      this.reserve_(view.byteLength);
+      this.u8.set(
+          new Uint8Array(view.buffer, view.byteOffset, view.byteLength),
+          this.pos);
+      this.pos += view.byteLength;
+      return;
+    }
+
+    if (Array.isArray(value)) {
+      this.u8_(Tag.ARRAY);
+      this.u32_(value.length);
+      value.forEach((ele) => this.value(ele === undefined ? null : ele));
+      return;
+    }
+
+    const proto = Object.getPrototypeOf(value);
+    if (proto !== Object.prototype && proto !== null) {
+      throw new UnsupportedValue();
+    }
+
+    // Like JSON, skip undefined members.
+    const keys = Object.keys(value).filter((key) => value[key] !== undefined);
+    this.u8_(Tag.OBJECT);
+    this.u32_(keys.length);
+    keys.forEach((key) => {
+      this.string_(key);
+      this.value(value[key]);
+    });
+  }
+
+  /** @param {*} value */
+  shapeU8_(value) {
+    if (typeof value !== 'number' || (value & 0xff) !== value) {
+      throw new UnsupportedValue();
+    }
+    this.u8_(value);
+  }
+
+  /** @param {*} value */
+  shapeU32_(value) {
+    if (typeof value !== 'number' || (value >>> 0) !== value) {
+      throw new UnsupportedValue();
+    }
+    this.u32_(value);
+  }
+
+  /** @param {*} value */
+  shapeU64_(value) {
+    if (typeof value !== 'bigint' || value < 0n || value >= (1n << 64n)) {
+      throw new UnsupportedValue();
+    }
+    this.reserve_(8);
+    this.dv.setBigUint64(this.pos, value, true);
+    this.pos += 8;
+  }
+
+  /**
+   * Write the READ members.
+   *
+   * @param {!Object} value
+   * @return {number} How many members were written.
+   */
+  shapeRead_(value) {
+    const {buf, nread} = value;
+    if (buf !== undefined && !(buf instanceof Uint8Array)) {
+      throw new UnsupportedValue();
+    }
+    this.u8_((buf !== undefined ? 1 : 0) | (nread !== undefined ? 2 : 0));
+    if (nread !== undefined) {
+      this.shapeU32_(nread);
+    }
+    if (buf !== undefined) {
+      this.u32_(buf.length);
+      this.reserve_(buf.length);
+      this.u8.set(buf, this.pos);
+      this.pos += buf.length;
+    }
+    return (buf !== undefined ? 1 : 0) + (nread !== undefined ? 1 : 0);
+  }
+
+  /**
+   * Write the address & port of a SOCKADDR or RECVFROM.
+   *
+   * @param {*} family
+   * @param {!Object} value
+   */
+  shapeSockaddr_(family, value) {
+    const {address, port} = value;
+    if (!Array.isArray(address) || address.length > 16) {
+      throw new UnsupportedValue();
+    }
+    this.shapeU32_(family);
+    this.shapeU32_(port);
+    this.u8_(address.length);
+    address.forEach((byte) => this.shapeU8_(byte));
+  }
+
+  /**
+   * Write a syscall result using a fixed layout.
+   *
+   * @param {!Shape} shape
+   * @param {*} value
+   * @throws {!UnsupportedValue} If |value| doesn't fit |shape|.
+   */
+  shape(shape, value) {
+    if (typeof value !== 'object' || value === null) {
+      throw new UnsupportedValue();
+    }
+    const count = countMembers(value);
+    this.u8_(shape);
+
+    let written;
+    switch (shape) {
+      case Shape.READ:
+        written = this.shapeRead_(value);
+        break;
+
+      case Shape.FILESTAT:
+        this.shapeU8_(value.filetype);
+        FILESTAT_U64S.forEach((key) => this.shapeU64_(value[key]));
+        written = 8;
+        break;
+
+      case Shape.FDSTAT:
+        this.shapeU8_(value.fs_filetype);
+        this.shapeU32_(value.fs_flags);
+        this.shapeU64_(value.fs_rights_base);
+        this.shapeU64_(value.fs_rights_inheriting);
+        written = 4;
+        break;
+
+      case Shape.SOCKADDR:
+        this.shapeSockaddr_(value.family, value);
+        written = 3;
+        break;
+
+      case Shape.RECVFROM:
+        written = this.shapeRead_(value);
+        this.shapeSockaddr_(value.domain, value);
+        written += 3;
+        break;
+
+      default:
+        throw new UnsupportedValue();
+    }
+
+    // Anything we didn't write would be lost.
+    if (written !== count) {
+      throw new UnsupportedValue();
+    }
+  }
+}
+
+/**
+ * Deserialize data written by BinaryWriter.
+ */
+export class BinaryReader {
+  /**
+   * @param {!Uint8Array} u8 The data to read.
+   */
+  constructor(u8) {
+    this.u8 = u8;
+    this.dv = new DataView(u8.buffer, u8.byteOffset, u8.byteLength);
+    this.pos = 0;
+  }
+
+  /** @return {number} */
+  u32_() {
+    const ret = this.dv.getUint32(this.pos, true);
+    this.pos += 4;
+    return ret;
+  }
+
+  /** @return {string} */
+  string_() {
+    const length = this.u32_();
+    const bytes = this.u8.subarray(this.pos, this.pos + length);
+    this.pos += length;
+
+    // Short ASCII strings are faster to build by hand.
+    if (length < 256 && bytes.every((c) => c < 0x80)) {
+      return String.fromCharCode.apply(null, bytes);
+    }
+    // We have to use slice to get a copy as decode doesn't support shared
+    // array buffers yet.
+    return textDecoder.decode(bytes.slice());
+  }
+
+  /** @return {*} */
+  value() {
+    const tag = this.u8[this.pos++];
+    switch (tag) {
+      case Tag.NULL:
+        return null;
+      case Tag.FALSE:
+        return false;
+      case Tag.TRUE:
+        return true;
+
+      case Tag.INT32: {
+        const ret = this.dv.getInt32(this.pos, true);
+        this.pos += 4;
+        return ret;
+      }
+
+      case Tag.FLOAT64: {
+        const ret = this.dv.getFloat64(this.pos, true);
+        this.pos += 8;
+        return ret;
+      }
+
+      case Tag.BIGINT64: {
+        const ret = this.dv.getBigInt64(this.pos, true);
+        this.pos += 8;
+        return ret;
+      }
+
+      case Tag.BIGUINT64: {
+        const ret = this.dv.getBigUint64(this.pos, true);
+        this.pos += 8;
+        return ret;
+      }
+
+      case Tag.STRING:
+        return this.string_();
+
+      case Tag.TYPED_ARRAY: {
+        const ctor = TYPED_ARRAYS[this.u8[this.pos++]];
+        const length = this.u32_();
+        const bytes = this.u8.slice(this.pos, this.pos + length);
+        this.pos += length;
+        return new ctor(bytes.buffer);
+      }
+
+      case Tag.ARRAY: {
+        const length = this.u32_();
+        const ret = new Array(length);
+        for (let i = 0; i < length; ++i) {
+          ret[i] = this.value();
+        }
+        return ret;
+      }
+
+      case Tag.OBJECT: {
+        const length = this.u32_();
+        const ret = {};
+        for (let i = 0; i < length; ++i) {
+          const key = this.string_();
+          ret[key] = this.value();
+        }
+        return ret;
+      }
+    }
+
+    throw new Error(`Invalid serialized tag ${tag}`);
+  }
+
+  /**
+   * Read the READ members into |ret|.
+   *
+   * @param {!Object} ret
+   */
+  shapeRead_(ret) {
+    const flags = this.u8[this.pos++];
+    if (flags & 2) {
+      ret.nread = this.u32_();
+    }
+    if (flags & 1) {
+      const length = this.u32_();
+      ret.buf = this.u8.slice(this.pos, this.pos + length);
+      this.pos += length;
+    }
+  }
+
+  /**
+   * Read the address & port of a SOCKADDR or RECVFROM into |ret|.
+   *
+   * @param {!Object} ret
+   * @param {string} family The member name for the address family.
+   */
+  shapeSockaddr_(ret, family) {
+    ret[family] = this.u32_();
+    ret.port = this.u32_();
+    const length = this.u8[this.pos++];
+    ret.address = Array.from(this.u8.subarray(this.pos, this.pos + length));
+    this.pos += length;
+  }
+
+  /** @return {bigint} */
+  u64_() {
+    const ret = this.dv.getBigUint64(this.pos, true);
+    this.pos += 8;
+    return ret;
+  }
+
+  /**
+   * Read a syscall result written by BinaryWriter.shape.
+   *
+   * @return {!Object}
+   */
+  shape() {
+    const shape = this.u8[this.pos++];
+    const ret = {};
+    switch (shape) {
+      case Shape.READ:
+        this.shapeRead_(ret);
+        return ret;
+
+      case Shape.FILESTAT:
+        ret.filetype = this.u8[this.pos++];
+        FILESTAT_U64S.forEach((key) => ret[key] = this.u64_());
+        return ret;
+
+      case Shape.FDSTAT:
+        ret.fs_filetype = this.u8[this.pos++];
+        ret.fs_flags = this.u32_();
+        ret.fs_rights_base = this.u64_();
+        ret.fs_rights_inheriting = this.u64_();
+        return ret;
+
+      case Shape.SOCKADDR:
+        this.shapeSockaddr_(ret, 'family');
+        return ret;
+
+      case Shape.RECVFROM:
+        this.shapeRead_(ret);
+        this.shapeSockaddr_(ret, 'domain');
+        return ret;
+    }
+
+    throw new Error(`Invalid serialized shape ${shape}`);
+  }
+}
+
 /**
  * Locking type that's more analagous to a Win32-style signal. This class
  * creates locking semantics and a return code around a piece of shared memory
@@ -110,13 +697,52 @@ export class SyscallLock {
   /**
    * Serialize complicated objects for passing via shared memory.
    *
-   * This uses JSON internally, so objects should not be complicated, and they
-   * need to fit within 64KiB.
+   * Results of the most common syscalls use a fixed layout (see Shape).  Other
+   * plain objects use a compact binary encoding.  Anything else falls back to
+   * JSON, which can only handle one typed array per object.  Either way, the
+   * result has to fit in the shared memory.
+   *
+   * @param {!Object} obj The object to serialize.
+   * @param {string=} syscall The syscall that returned |obj|.
+   */
+  setData(obj, syscall = undefined) {
+    const shape = SYSCALL_SHAPES.get(syscall);
+    if (shape !== undefined) {
+      const writer = new BinaryWriter(this.sabDataArr);
+      try {
+        writer.u8_(SHAPE_MAGIC);
+        writer.shape(shape, obj);
+        this.sabArr[this.dataLengthIndex] = writer.pos;
+        return;
+      } catch (e) {
+        if (!(e instanceof UnsupportedValue)) {
+          throw e;
+        }
+      }
+    }
+
+    const writer = new BinaryWriter(this.sabDataArr);
+    try {
+      writer.u8_(BINARY_MAGIC);
+      writer.value(obj);
+      this.sabArr[this.dataLengthIndex] = writer.pos;
+      return;
+    } catch (e) {
+      if (!(e instanceof UnsupportedValue)) {
+        throw e;
+      }
+    }
+
+    this.setJsonData_(obj);
+  }
+
+  /**
+   * Serialize objects via JSON.
    *
    * @param {!Object} obj The object to serialize.
    */
-  setData(obj) {
-    const te = new TextEncoder();
+  setJsonData_(obj) {
+    const te = textEncoder;
     /** @type {?ArrayBufferView} */
     let ab = null;
     const str = JSON.stringify(obj, (key, value) => {
@@ -148,6 +774,48 @@ export class SyscallLock {
     }
   }
 
+  /**
+   * Serialize a syscall request for the main thread (see Scheduler).
+   *
+   * Views of shared memory aren't copied: posting them as messages lets the
+   * main thread write into them directly, so those requests have to use
+   * messages, as do requests that don't fit.
+   *
+   * @param {!Array<*>} request The syscall name & arguments.
+   * @return {boolean} Whether the request was written.
+   */
+  setRequest(request) {
+    const isShared = (arg) => ArrayBuffer.isView(arg) &&
+        arg.buffer instanceof SharedArrayBuffer;
+    if (request.some((arg) => isShared(arg) ||
+                              (Array.isArray(arg) && arg.some(isShared)))) {
+      return false;
+    }
+
+    const writer = new BinaryWriter(this.sabDataArr);
+    try {
+      writer.value(request);
+    } catch (e) {
+      if (e instanceof UnsupportedValue || e instanceof RangeError) {
+        return false;
+      }
+      throw e;
+    }
+    return true;
+  }
+
+  /**
+   * Deserialize a syscall request written by setRequest.
+   *
+   * @return {!Array<*>} The syscall name & arguments.
+   */
+  getRequest() {
+    const request = /** @type {!Array<*>} */ (
+        new BinaryReader(this.sabDataArr).value());
+    // Syscall arguments are never null, so these were undefined.
+    return request.map((arg) => arg === null ? undefined : arg);
+  }
+
   /**
    * Deserialize complicated objects.
    *
@@ -160,7 +828,20 @@ export class SyscallLock {
       return null;
     }
 
-    const td = new TextDecoder();
+    if (this.sabDataArr[0] === SHAPE_MAGIC) {
+      return new BinaryReader(this.sabDataArr.subarray(1, length)).shape();
+    }
+
+    if (this.sabDataArr[0] === BINARY_MAGIC) {
+      const reader = new BinaryReader(this.sabDataArr.subarray(1, length));
+      const ret = reader.value();
+      if (!(ret instanceof Object)) {
+        throw new Error(`Invalid serialized object`);
+      }
+      return ret;
+    }
+
+    const td = textDecoder;
     // We have to use slice to get a copy as decode doesn't support shared array
     // buffers yet.
     const bytes = this.sabDataArr.slice(0, length);
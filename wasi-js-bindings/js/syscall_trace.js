@@ -0,0 +1,323 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Binary traces of syscalls for record & replay.
+ *
+ * A trace is every syscall handler call a program made: its name, arguments,
+ * result, and any data the handler wrote into program memory (e.g. read
+ * payloads & random bytes).  That's enough to run the program again with the
+ * same results and no real I/O (see RecordWasiPreview1 & ReplayWasiPreview1).
+ *
+ * The format is a small header followed by the records, using the same value
+ * encoding as SyscallLock.  Syscall names are written out the first time
+ * they're used, and referred to by index after that.
+ */
+
+import {BinaryReader, BinaryWriter} from './syscall_lock.js';
+
+/**
+ * The first bytes of every trace ("WJBT" & the format version).
+ */
+const kMagic = [0x57, 0x4a, 0x42, 0x54, 1];
+
+/**
+ * The size of the first chunk of trace data.
+ */
+const kChunkSize = 64 * 1024;
+
+/**
+ * The arguments that handlers may write their results into.
+ *
+ * These are views of program memory (see SyscallEntry.getDest_), so the trace
+ * needs their contents after the call, not before.
+ *
+ * @type {!Object<string, number>}
+ */
+export const kOutputArgs = {
+  'fd_pread': 3,
+  'fd_preadv': 3,
+  'fd_read': 2,
+  'fd_readdir': 1,
+  'fd_readv': 2,
+  'path_readlink': 2,
+  'random_get': 0,
+  'sock_recvfrom': 3,
+};
+
+/**
+ * Syscalls that don't return to the program.
+ *
+ * These are recorded before they're called, and are left to the other
+ * handlers when replaying.
+ */
+export const kNoReturn = new Set(['proc_exit', 'proc_raise']);
+
+/**
+ * A single syscall in a trace.
+ *
+ * @typedef {{
+ *   name: string,
+ *   args: !Array<*>,
+ *   ret: *,
+ *   out: ?Uint8Array,
+ * }}
+ */
+export let Record;
+
+/**
+ * Convert a handler argument into what the trace stores.
+ *
+ * Buffers the program passed in are stored as their length only: they're the
+ * program's own output, so replays recreate them.
+ *
+ * @param {*} arg
+ * @return {*}
+ */
+export function traceArg(arg) {
+  if (arg === undefined) {
+    return null;
+  }
+  if (ArrayBuffer.isView(arg) || arg instanceof ArrayBuffer ||
+      (typeof SharedArrayBuffer !== 'undefined' &&
+       arg instanceof SharedArrayBuffer)) {
+    return arg.byteLength;
+  }
+  if (Array.isArray(arg) && ArrayBuffer.isView(arg[0])) {
+    return arg.map((ele) => ele.byteLength);
+  }
+  return arg;
+}
+
+/**
+ * Check whether two traced arguments are the same.
+ *
+ * @param {*} a
+ * @param {*} b
+ * @return {boolean}
+ */
+export function sameArg(a, b) {
+  if (a === b) {
+    return true;
+  }
+  if (typeof a !== 'object' || typeof b !== 'object' || a === null ||
+      b === null) {
+    return false;
+  }
+  if (ArrayBuffer.isView(a) && ArrayBuffer.isView(b)) {
+    const u8a = new Uint8Array(a.buffer, a.byteOffset, a.byteLength);
+    const u8b = new Uint8Array(b.buffer, b.byteOffset, b.byteLength);
+    return u8a.length === u8b.length && u8a.every((byte, i) => byte === u8b[i]);
+  }
+  const keys = Object.keys(a);
+  return Array.isArray(a) === Array.isArray(b) &&
+      keys.length === Object.keys(b).length &&
+      keys.every((key) => sameArg(a[key], b[key]));
+}
+
+/**
+ * Convert a handler result into what the trace stores.
+ *
+ * @param {*} ret
+ * @return {*}
+ */
+function traceRet(ret) {
+  // Read handlers may return raw buffers.
+  if (typeof ret === 'object' && ret !== null &&
+      (ret.buf instanceof ArrayBuffer ||
+       (typeof SharedArrayBuffer !== 'undefined' &&
+        ret.buf instanceof SharedArrayBuffer))) {
+    return {...ret, buf: new Uint8Array(ret.buf)};
+  }
+  return ret;
+}
+
+/**
+ * Copy what a handler wrote into its output argument.
+ *
+ * @param {!Uint8Array|!Array<!Uint8Array>|undefined} dest The output argument.
+ * @param {*} ret The handler result.
+ * @return {?Uint8Array} The data, or null if the handler didn't write any.
+ */
+export function captureOutput(dest, ret) {
+  if (dest === undefined || dest === null) {
+    return null;
+  }
+
+  let length;
+  if (typeof ret === 'number') {
+    // Errors leave the buffer alone, while successful calls fill it.
+    if (ret !== 0) {
+      return null;
+    }
+  } else if (typeof ret === 'object' && ret !== null) {
+    // The data was returned rather than written.
+    if (ret.buf !== undefined) {
+      return null;
+    }
+    length = ret.nread ?? ret.length;
+  }
+
+  const dests = Array.isArray(dest) ? dest : [dest];
+  if (length === undefined) {
+    length = dests.reduce((sum, buf) => sum + buf.length, 0);
+  }
+  const out = new Uint8Array(length);
+  let off = 0;
+  for (let i = 0; i < dests.length && off < length; ++i) {
+    const chunk = dests[i].subarray(0, length - off);
+    out.set(chunk, off);
+    off += chunk.length;
+  }
+  return out;
+}
+
+/**
+ * Copy recorded output back into a handler's output argument.
+ *
+ * @param {!Uint8Array|!Array<!Uint8Array>} dest The output argument.
+ * @param {!Uint8Array} out The recorded data.
+ */
+export function restoreOutput(dest, out) {
+  const dests = Array.isArray(dest) ? dest : [dest];
+  let off = 0;
+  for (let i = 0; i < dests.length && off < out.length; ++i) {
+    const chunk = out.subarray(off, off + dests[i].length);
+    dests[i].set(chunk);
+    off += chunk.length;
+  }
+}
+
+/**
+ * Record syscalls into a trace.
+ */
+export class TraceWriter {
+  constructor() {
+    /** @type {!Array<!Uint8Array>} Full chunks of trace data. */
+    this.chunks_ = [];
+    this.writer_ = new BinaryWriter(new Uint8Array(kChunkSize));
+    this.writer_.u8.set(kMagic);
+    this.writer_.pos = kMagic.length;
+    /** @type {!Map<string, number>} */
+    this.names_ = new Map();
+    /** @type {number} How many syscalls have been recorded. */
+    this.count = 0;
+  }
+
+  /**
+   * Add a syscall to the trace.
+   *
+   * @param {string} name The syscall name.
+   * @param {!Array<*>} args The handler arguments.
+   * @param {*} ret The handler result.
+   * @param {?Uint8Array=} out What the handler wrote into its output argument.
+   */
+  record(name, args, ret, out = null) {
+    const index = this.names_.get(name);
+    const record = [
+      index ?? name, args.map(traceArg), traceRet(ret), out,
+    ];
+
+    const start = this.writer_.pos;
+    try {
+      record.forEach((value) => this.writer_.value(value));
+    } catch (e) {
+      if (!(e instanceof RangeError)) {
+        throw e;
+      }
+
+      // Start a new chunk that's big enough for this record.
+      this.writer_.pos = start;
+      this.chunks_.push(this.writer_.u8.subarray(0, start));
+      let size = this.writer_.u8.length * 2;
+      while (true) {
+        this.writer_ = new BinaryWriter(new Uint8Array(size));
+        try {
+          record.forEach((value) => this.writer_.value(value));
+          break;
+        } catch (e) {
+          if (!(e instanceof RangeError)) {
+            throw e;
+          }
+          size *= 2;
+        }
+      }
+    }
+
+    if (index === undefined) {
+      this.names_.set(name, this.names_.size);
+    }
+    ++this.count;
+  }
+
+  /**
+   * @return {!Uint8Array} The trace so far.
+   */
+  toBytes() {
+    const chunks = [
+      ...this.chunks_, this.writer_.u8.subarray(0, this.writer_.pos),
+    ];
+    const ret = new Uint8Array(
+        chunks.reduce((sum, chunk) => sum + chunk.length, 0));
+    let off = 0;
+    chunks.forEach((chunk) => {
+      ret.set(chunk, off);
+      off += chunk.length;
+    });
+    return ret;
+  }
+}
+
+/**
+ * Read the syscalls out of a trace.
+ */
+export class TraceReader {
+  /**
+   * @param {!Uint8Array|!ArrayBuffer} bytes The trace.
+   */
+  constructor(bytes) {
+    const u8 = bytes instanceof Uint8Array ? bytes : new Uint8Array(bytes);
+    if (u8.length < kMagic.length ||
+        kMagic.some((byte, i) => u8[i] !== byte)) {
+      throw new Error('Not a syscall trace');
+    }
+    this.reader_ = new BinaryReader(u8);
+    this.reader_.pos = kMagic.length;
+    /** @type {!Array<string>} */
+    this.names_ = [];
+  }
+
+  /**
+   * @return {?Record} The next syscall, or null at the end of the trace.
+   */
+  next() {
+    const reader = this.reader_;
+    if (reader.pos >= reader.u8.length) {
+      return null;
+    }
+
+    let name = reader.value();
+    if (typeof name === 'string') {
+      this.names_.push(name);
+    } else {
+      name = this.names_[/** @type {number} */ (name)];
+    }
+    const args = /** @type {!Array<*>} */ (reader.value());
+    const ret = reader.value();
+    const out = /** @type {?Uint8Array} */ (reader.value());
+    return {name: /** @type {string} */ (name), args, ret, out};
+  }
+
+  /**
+   * @return {!Array<!Record>} All the (remaining) syscalls.
+   */
+  readAll() {
+    const ret = [];
+    let record;
+    while ((record = this.next()) !== null) {
+      ret.push(record);
+    }
+    return ret;
+  }
+}
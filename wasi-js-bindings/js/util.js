@@ -6,7 +6,9 @@
  * @fileoverview Random utility functions with no real home.
  */
 
+import * as CLOCK from './wasi/clock.js';
 import * as ERRNO from './wasi/errno.js';
+import * as SUBCLOCKFLAGS from './wasi/subclockflags.js';
 
 // eslint-disable-next-line jsdoc/require-returns-check
 /**
@@ -109,3 +111,77 @@ export function encodeIntoSab(encoder, str, buf) {
     throw e;
   }
 }
+
+/**
+ * Move the data from a read result into the program's memory.
+ *
+ * Read handlers may be given a view of the destination in the program's memory
+ * (see getDest_ in syscall_entry.js).  Handlers that produce their data in a
+ * separate buffer use this to write it there, and return only the count, so it
+ * doesn't have to be copied through the syscall lock too.
+ *
+ * @param {!WASI_t.errno|{buf: (!ArrayBufferView|!Array<number>|undefined),
+ *                         nread: (number|undefined)}} ret The read result.
+ * @param {!Uint8Array=} dest Where the program wants the data.
+ * @return {!WASI_t.errno|!Object} The updated read result.
+ */
+export function writeReadResult(ret, dest) {
+  if (dest === undefined || typeof ret === 'number' || ret.buf === undefined) {
+    return ret;
+  }
+
+  const buf = ArrayBuffer.isView(ret.buf) ?
+      new Uint8Array(ret.buf.buffer, ret.buf.byteOffset, ret.buf.byteLength) :
+      new Uint8Array(ret.buf);
+  const nread = Math.min(buf.length, dest.length);
+  dest.set(buf.subarray(0, nread));
+  delete ret.buf;
+  if (ret.nread === undefined) {
+    ret.nread = nread;
+  }
+  return ret;
+}
+
+/**
+ * How many nanoseconds in one millisecond.
+ */
+const kNanosecToMillisec = 1000000;
+
+/**
+ * The current MONOTONIC time in milliseconds.
+ *
+ * performance.now() counts from when each thread started, so the program's
+ * worker and the main thread would disagree on absolute times.  Adding the
+ * time origin puts them all on one timeline.
+ *
+ * @return {number} The time in milliseconds (with microsecond precision).
+ */
+export function monotonicNow() {
+  return performance.timeOrigin + performance.now();
+}
+
+/**
+ * Convert a poll_oneoff clock subscription into a deadline.
+ *
+ * Deadlines are on the monotonicNow() timeline so wall clock jumps don't
+ * affect timeouts.
+ *
+ * @param {!WASI_t.subscription_clock} clock The clock subscription.
+ * @return {!WASI_t.errno|{deadline: number}} The deadline, or errno for
+ *     unknown clocks.
+ */
+export function clockDeadline(clock) {
+  const now = monotonicNow();
+  const timeout = Number(clock.timeout) / kNanosecToMillisec;
+  const absolute = clock.flags & SUBCLOCKFLAGS.SUBSCRIPTION_CLOCK_ABSTIME;
+
+  switch (clock.id) {
+    case CLOCK.REALTIME:
+      // Convert wall clock times to our timeline.
+      return {deadline: now + (absolute ? timeout - Date.now() : timeout)};
+    case CLOCK.MONOTONIC:
+      return {deadline: absolute ? timeout : now + timeout};
+    default:
+      return ERRNO.ENOTSUP;
+  }
+}
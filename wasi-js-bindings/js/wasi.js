@@ -10,6 +10,7 @@
 import * as advice from './wasi/advice.js';
 import * as clock from './wasi/clock.js';
 import * as errno from './wasi/errno.js';
+import * as eventrwflags from './wasi/eventrwflags.js';
 import * as eventtype from './wasi/eventtype.js';
 import * as fdflags from './wasi/fdflags.js';
 import * as filetype from './wasi/filetype.js';
@@ -18,6 +19,7 @@ import * as lookupflags from './wasi/lookupflags.js';
 import * as oflags from './wasi/oflags.js';
 import * as rights from './wasi/rights.js';
 import * as signal from './wasi/signal.js';
+import * as subclockflags from './wasi/subclockflags.js';
 import * as whence from './wasi/whence.js';
-export {advice, clock, errno, eventtype, fdflags, filetype, fstflags,
-        lookupflags, oflags, rights, signal, whence};
+export {advice, clock, errno, eventrwflags, eventtype, fdflags, filetype,
+        fstflags, lookupflags, oflags, rights, signal, subclockflags, whence};
@@ -0,0 +1,9 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview WASI eventrwflags API constants from wasi/api.h.
+ */
+
+export const FD_READWRITE_HANGUP = 1;
@@ -7,6 +7,8 @@
  */
 
 import * as Process from './process.js';
+import {Slot} from './scheduler.js';
+import {RecordWasiPreview1} from './syscall_handler.js';
 
 /**
  * Base class for creating your own background worker.
@@ -30,15 +32,18 @@ export class Base {
   /**
    * Create a new process!
    *
-   * @param {string} executable The path to the WASM program.
+   * @param {string|!WebAssembly.Module} executable The path to the WASM
+   *     program, or the compiled program (see ModuleCache).
    * @param {!Array<string>} argv The program's command line opts.
    * @param {!Object<string, string>} environ The program's environment.
    * @param {!SharedArrayBuffer=} sab The shared array buffer memory.
    * @param {*=} handler_ids
+   * @param {!SharedArrayBuffer=} cache_sab The SyscallCache memory.
+   * @param {?Slot=} slot The Scheduler slot for ProxyWasiPreview1, if any.
    * @return {!Process.Foreground} The new process.
    */
   newProcess(executable, argv, environ, sab = undefined,
-             handler_ids = undefined) {
+             handler_ids = undefined, cache_sab = undefined, slot = undefined) {
     const sys_handlers = [];
     const sys_entries = [];
     return new Process.Foreground(
@@ -89,6 +94,31 @@ export class Base {
     this.worker.postMessage({name, argv: args});
   }
 
+  /**
+   * Send the process's syscall profile, if it has one.
+   *
+   * @param {!Process.Foreground} proc The process.
+   */
+  postProfile(proc) {
+    if (proc.profiler) {
+      this.postMessage('profile', proc.profiler.getSummary(),
+                       proc.profiler.toChromeTrace());
+    }
+  }
+
+  /**
+   * Send the process's syscall trace, if it's being recorded.
+   *
+   * @param {!Process.Foreground} proc The process.
+   */
+  postTrace(proc) {
+    const recorder = proc.sys_handlers.find(
+        (handler) => handler instanceof RecordWasiPreview1);
+    if (recorder) {
+      this.postMessage('trace', recorder.trace.toBytes());
+    }
+  }
+
   /**
    * Handle an incoming messsage.
    *
@@ -123,15 +153,22 @@ export class Base {
   /**
    * Create & run the program.
    *
-   * @param {string} executable The path to the WASM program.
+   * @param {string|!WebAssembly.Module} executable The path to the WASM
+   *     program, or the compiled program (see ModuleCache).
    * @param {!Array<string>} argv The program's command line opts.
    * @param {!Object<string, string>} environ The program's environment.
    * @param {!SharedArrayBuffer} sab The shared array buffer memory.
-   * @param {...*} handlers
+   * @param {*} handlers
+   * @param {!SharedArrayBuffer} cache_sab The SyscallCache memory.
+   * @param {?Slot} slot The Scheduler slot, if any.
    */
-  async onMessage_run(executable, argv, environ, sab, handlers) {
-    const proc = this.newProcess(executable, argv, environ, sab, handlers);
+  async onMessage_run(executable, argv, environ, sab, handlers, cache_sab,
+                      slot) {
+    const proc = this.newProcess(executable, argv, environ, sab, handlers,
+                                 cache_sab, slot);
     const ret = await proc.run();
+    this.postProfile(proc);
+    this.postTrace(proc);
     this.postMessage('exit', ret);
   }
 }
@@ -0,0 +1,85 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Pool of pre-spawned web workers.
+ *
+ * Starting a worker means loading & evaluating its module graph, which isn't
+ * free.  The pool keeps spare workers around so new processes can claim one
+ * that's already initialized (see Process.Background).
+ */
+
+/**
+ * Pool of idle workers that all run the same script.
+ */
+export class WorkerPool {
+  /**
+   * @param {string} workerUri The script the workers run.
+   * @param {{
+   *   size: (number|undefined),
+   * }=} options How many idle workers to keep around.
+   */
+  constructor(workerUri, {size = 1} = {}) {
+    this.workerUri = workerUri;
+    this.size_ = size;
+    /** @type {!Array<!Worker>} */
+    this.idle_ = [];
+  }
+
+  /**
+   * Spawn a new worker.
+   *
+   * @return {!Worker}
+   */
+  spawn_() {
+    return new Worker(this.workerUri, {type: 'module'});
+  }
+
+  /**
+   * Spawn idle workers until the pool is full.
+   */
+  fill() {
+    while (this.idle_.length < this.size_) {
+      const w = this.spawn_();
+      // If the script fails to load, don't hand it out later.
+      w.addEventListener('error', () => this.discard_(w), {once: true});
+      this.idle_.push(w);
+    }
+  }
+
+  /**
+   * Drop a worker from the idle pool.
+   *
+   * @param {!Worker} w
+   */
+  discard_(w) {
+    const i = this.idle_.indexOf(w);
+    if (i !== -1) {
+      this.idle_.splice(i, 1);
+      w.terminate();
+    }
+  }
+
+  /**
+   * Take a worker out of the pool.
+   *
+   * The pool is refilled in the background for the next caller.
+   *
+   * @return {!Worker} An idle worker, or a new one if none are left.
+   */
+  claim() {
+    const w = this.idle_.shift() ?? this.spawn_();
+    setTimeout(() => this.fill());
+    return w;
+  }
+
+  /**
+   * Shut down all the idle workers.
+   */
+  terminate() {
+    this.size_ = 0;
+    this.idle_.forEach((w) => w.terminate());
+    this.idle_ = [];
+  }
+}
@@ -6,7 +6,7 @@
  * @fileoverview Tests for clock APIs.
  */
 
-import {Process, SyscallEntry, SyscallHandler, WASI} from '../index.js';
+import {Process, SyscallEntry, SyscallHandler, util, WASI} from '../index.js';
 
 describe('clock.js', () => {
 
@@ -144,4 +144,50 @@ it('realtime', async function() {
   }
 });
 
+/**
+ * Run a function as if on a thread with a different time origin.
+ *
+ * @param {number} origin The time origin in milliseconds.
+ * @param {number} now What performance.now() should return.
+ * @param {function()} callback The code to run.
+ * @return {*} Whatever the callback returned.
+ */
+function withTimeOrigin(origin, now, callback) {
+  Object.defineProperty(performance, 'timeOrigin',
+                        {value: origin, configurable: true});
+  Object.defineProperty(performance, 'now',
+                        {value: () => now, configurable: true});
+  try {
+    return callback();
+  } finally {
+    delete performance.timeOrigin;
+    delete performance.now;
+  }
+}
+
+/**
+ * Verify absolute monotonic times agree across threads.
+ */
+it('monotonic across time origins', () => {
+  const handler = new SyscallHandler.DirectWasiPreview1();
+  const origin = 1700000000000;
+
+  // The worker started 3 seconds after the main thread.
+  const {now} = withTimeOrigin(
+      origin + 3000, 2000,
+      () => handler.handle_clock_time_get(WASI.clock.MONOTONIC));
+
+  // Sleep until 100ms from now, but resolve it on the main thread.
+  const clock = {
+    id: WASI.clock.MONOTONIC,
+    timeout: now + 100000000n,
+    precision: 0n,
+    flags: WASI.subclockflags.SUBSCRIPTION_CLOCK_ABSTIME,
+  };
+  const delay = withTimeOrigin(origin, 5000, () => {
+    return util.clockDeadline(clock).deadline - util.monotonicNow();
+  });
+  assert.closeTo(delay, 100, 0.001);
+});
+
 });
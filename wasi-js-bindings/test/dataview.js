@@ -7,6 +7,7 @@
  */
 
 import {WasiView} from '../index.js';
+import * as structs from '../js/structs.js';
 
 describe('dataview.js', () => {
 
@@ -321,4 +322,48 @@ describe('uint64', () => {
   checkPrimitive('Userdata', ...args);
 });
 
+/**
+ * Check the generated codecs agree with the generic spec walking.
+ */
+it('generated codecs match specs', () => {
+  const u8 = new Uint8Array(64);
+  u8.set(Array.from(u8.keys()));
+  const view = new WasiView(u8.buffer);
+  const value = structs.readFilestat(view, 0);
+  assert.deepStrictEqual(value, view.get_(WasiView.filestat_t, 0, true));
+
+  const generated = new WasiView(new ArrayBuffer(64));
+  const generic = new WasiView(new ArrayBuffer(64));
+  structs.writeFilestat(generated, 0, value);
+  generic.set_(WasiView.filestat_t, 0, value, true);
+  assert.deepStrictEqual(new Uint8Array(generated.buffer),
+                         new Uint8Array(generic.buffer));
+});
+
+/**
+ * Check readers fill in objects they're given.
+ */
+it('reader reuse', () => {
+  const view = new WasiView(new ArrayBuffer(16));
+  structs.writeIovec(view, 8, {buf: 1, buf_len: 2});
+  const iovec = {};
+  assert.strictEqual(structs.readIovec(view, 8, iovec), iovec);
+  assert.deepStrictEqual(iovec, {buf: 1, buf_len: 2, struct_size: 8});
+});
+
+/**
+ * Check batch iovec decoding.
+ */
+it('readIovecs', () => {
+  const view = new WasiView(new ArrayBuffer(24));
+  [[100, 1], [200, 2], [300, 3]].forEach(([buf, buf_len], i) => {
+    structs.writeIovec(view, i * 8, {buf, buf_len});
+  });
+  const bufs = new Uint32Array(4);
+  const lens = new Uint32Array(4);
+  assert.equal(structs.readIovecs(view, 0, 3, bufs, lens), 6);
+  assert.deepStrictEqual(Array.from(bufs), [100, 200, 300, 0]);
+  assert.deepStrictEqual(Array.from(lens), [1, 2, 3, 0]);
+});
+
 });
@@ -0,0 +1,81 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Tests for ModuleCache.
+ */
+
+import {ModuleCache} from '../index.js';
+import {hashBytes} from '../js/module_cache.js';
+import {Program} from '../js/program.js';
+
+describe('module_cache.js', () => {
+
+/**
+ * Create a new (empty) WASM program.
+ *
+ * @param {number=} version Used to create programs with different content.
+ * @return {!ArrayBuffer}
+ */
+function newProgram(version = 0) {
+  // The header, and optionally a custom section to vary the content.
+  const bytes = [0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00];
+  if (version) {
+    bytes.push(0x00, 0x02, 0x01, 0x76 + version);
+  }
+  return new Uint8Array(bytes).buffer;
+}
+
+/**
+ * Check content hashing.
+ */
+it('hashBytes', async () => {
+  const hash = await hashBytes(newProgram());
+  assert.match(hash, /^[0-9a-f]{64}$/);
+  assert.equal(await hashBytes(newProgram()), hash);
+  assert.notEqual(await hashBytes(newProgram(1)), hash);
+});
+
+/**
+ * Check the same content compiles only once.
+ */
+it('reuse by content', async () => {
+  const cache = new ModuleCache({persist: false});
+  const module = await cache.get(newProgram());
+  assert.instanceOf(module, WebAssembly.Module);
+  assert.strictEqual(await cache.get(newProgram()), module);
+  assert.notStrictEqual(await cache.get(newProgram(1)), module);
+
+  await cache.clear();
+  assert.notStrictEqual(await cache.get(newProgram()), module);
+});
+
+/**
+ * Check bad programs aren't cached.
+ */
+it('compile errors', async () => {
+  const cache = new ModuleCache({persist: false});
+  const bad = new Uint8Array([1, 2, 3]).buffer;
+  for (let i = 0; i < 2; ++i) {
+    try {
+      await cache.get(bad);
+      assert.fail('compile should have failed');
+    } catch (e) {
+      assert.instanceOf(e, WebAssembly.CompileError);
+    }
+  }
+});
+
+/**
+ * Check programs can run from compiled modules.
+ */
+it('Program', async () => {
+  const cache = new ModuleCache({persist: false});
+  const program = new Program(await cache.get(newProgram()));
+  const instance = await program.instantiate({});
+  assert.instanceOf(instance, WebAssembly.Instance);
+  assert.strictEqual(program.instance, instance);
+});
+
+});
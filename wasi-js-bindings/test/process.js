@@ -0,0 +1,66 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Tests for processes.
+ */
+
+import {Process} from '../index.js';
+
+describe('process.js', () => {
+
+/**
+ * Create a foreground process with some memory.
+ *
+ * @param {!WebAssembly.Memory} memory
+ * @return {!Process.Foreground}
+ */
+function newProcess(memory) {
+  const proc = new Process.Foreground({
+    executable: new ArrayBuffer(0),
+    sys_handlers: [],
+    sys_entries: [],
+  });
+  proc.instance_ = /** @type {!WebAssembly.Instance} */ (
+      {exports: {memory}});
+  return proc;
+}
+
+/**
+ * Check memory views are reused until memory grows.
+ */
+it('memory views', () => {
+  const memory = new WebAssembly.Memory({initial: 1, maximum: 2});
+  const proc = newProcess(memory);
+
+  const dv = proc.getMemView();
+  assert.strictEqual(proc.getMemView(), dv);
+  assert.equal(dv.byteLength, 64 * 1024);
+  dv.setUint32(8, 0x12345678, true);
+  assert.deepStrictEqual(Array.from(proc.getMem(8, 12)),
+                         [0x78, 0x56, 0x34, 0x12]);
+
+  memory.grow(1);
+  const grown = proc.getMemView();
+  assert.notStrictEqual(grown, dv);
+  assert.equal(grown.byteLength, 128 * 1024);
+  assert.equal(grown.getUint32(8, true), 0x12345678);
+  assert.equal(proc.getMem(0).length, 128 * 1024);
+});
+
+/**
+ * Check shared memory views are updated when memory grows.
+ */
+it('shared memory views', () => {
+  const memory = new WebAssembly.Memory(
+      {initial: 1, maximum: 2, shared: true});
+  const proc = newProcess(memory);
+
+  const dv = proc.getMemView();
+  assert.strictEqual(proc.getMemView(), dv);
+  memory.grow(1);
+  assert.equal(proc.getMemView().byteLength, 128 * 1024);
+});
+
+});
@@ -0,0 +1,115 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Tests for the syscall profiler.
+ */
+
+import {Profiler, SyscallEntry, WASI} from '../index.js';
+
+describe('profiler.js', () => {
+
+/**
+ * Check calls are counted & split into worker/wait time.
+ */
+it('summary', () => {
+  const profiler = new Profiler.Profiler();
+  for (let i = 0; i < 3; ++i) {
+    profiler.begin();
+    profiler.addWait(1);
+    profiler.addBytes(10);
+    profiler.end('fd_read');
+  }
+  profiler.begin();
+  profiler.end('clock_time_get');
+
+  const summary = profiler.getSummary();
+  assert.deepStrictEqual(summary.map((row) => row.name),
+                         ['fd_read', 'clock_time_get']);
+  const [read] = summary;
+  assert.equal(read.count, 3);
+  assert.equal(read.wait, 3);
+  assert.equal(read.bytes, 30);
+  assert.closeTo(read.worker, read.total - read.wait, 1e-9);
+  assert.isAtMost(read.p50, read.p99);
+  assert.isAtMost(read.p99, read.max);
+
+  const table = Profiler.formatSummary(summary);
+  assert.include(table, 'fd_read');
+  assert.equal(table.split('\n').length, 3);
+});
+
+/**
+ * Check nested calls are only counted once.
+ */
+it('nested', () => {
+  const profiler = new Profiler.Profiler();
+  profiler.begin();
+  profiler.begin();
+  profiler.end('inner');
+  profiler.end('outer');
+  assert.deepStrictEqual(profiler.getSummary().map((row) => row.name),
+                         ['outer']);
+});
+
+/**
+ * Check the Chrome trace output & its size limit.
+ */
+it('chrome trace', () => {
+  const profiler = new Profiler.Profiler({maxEvents: 2});
+  for (let i = 0; i < 3; ++i) {
+    profiler.begin();
+    profiler.end('fd_write');
+  }
+
+  const trace = profiler.toChromeTrace();
+  const events = trace.traceEvents.filter((e) => e.ph === 'X');
+  assert.equal(events.length, 2);
+  assert.equal(events[0].name, 'fd_write');
+  assert.equal(trace.otherData.droppedEvents, 1);
+  assert.equal(profiler.getSummary()[0].count, 3);
+  // Make sure it's valid JSON.
+  assert.deepStrictEqual(JSON.parse(JSON.stringify(trace)), trace);
+});
+
+/**
+ * Check byte counting from handler results.
+ */
+it('countBytes', () => {
+  const buf = new Uint8Array(5);
+  assert.equal(Profiler.countBytes([1, buf], {nwritten: 3}), 3);
+  assert.equal(Profiler.countBytes([1, 5], {nread: 2}), 2);
+  assert.equal(Profiler.countBytes([1, 5], {buf}), 5);
+  assert.equal(Profiler.countBytes([buf, [buf]], WASI.errno.ESUCCESS), 10);
+  assert.equal(Profiler.countBytes([buf], WASI.errno.EBADF), 0);
+});
+
+/**
+ * Check syscall entries feed the profiler.
+ */
+it('syscall entries', () => {
+  const profiler = new Profiler.Profiler();
+  const mem = new Uint8Array(64);
+  const process = {
+    profiler,
+    getMem: (base, end) => mem.subarray(base, end),
+    debug() {},
+  };
+  const handler = {
+    handle_random_get(buf) {
+      return WASI.errno.ESUCCESS;
+    },
+  };
+  const entry = new SyscallEntry.WasiPreview1(
+      {sys_handlers: [handler], process});
+  const imports = entry.getImports()[entry.namespace];
+
+  assert.equal(imports.random_get(0, 16), WASI.errno.ESUCCESS);
+  const [row] = profiler.getSummary();
+  assert.equal(row.name, 'random_get');
+  assert.equal(row.count, 1);
+  assert.equal(row.bytes, 16);
+});
+
+});
@@ -0,0 +1,138 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Tests for the syscall Scheduler.
+ */
+
+import {Scheduler, SlotClient} from '../js/scheduler.js';
+import {SyscallLock} from '../js/syscall_lock.js';
+
+describe('scheduler.js', () => {
+
+/**
+ * If running on a web page, SharedArrayBuffers might not work.
+ *
+ * @suppress {missingProperties} https://github.com/google/closure-compiler/issues/4170
+ */
+before(function() {
+  if (window.SharedArrayBuffer === undefined) {
+    console.warn('SharedArrayBuffer API not available');
+    this.skip();
+  }
+});
+
+/**
+ * A process that records the requests it gets.
+ */
+class TestClient {
+  constructor() {
+    this.lock = new SyscallLock(new SharedArrayBuffer(1024));
+    this.requests = [];
+  }
+
+  onRequest(request) {
+    this.requests.push(request);
+  }
+}
+
+/**
+ * Wait for something to happen.
+ *
+ * @param {function(): boolean} check
+ */
+async function until(check) {
+  for (let i = 0; i < 100 && !check(); ++i) {
+    await new Promise((resolve) => setTimeout(resolve, 1));
+  }
+  assert.isTrue(check());
+}
+
+/**
+ * Check requests are decoded & handed to their process.
+ */
+it('requests', async () => {
+  const scheduler = new Scheduler();
+  const client = new TestClient();
+  const slot = scheduler.add(client);
+  assert.isNotNull(slot);
+
+  const worker = new SlotClient(slot);
+  assert.isTrue(worker.submit(
+      client.lock, ['fd_write', 1, new Uint8Array([1, 2]), undefined]));
+  await until(() => client.requests.length === 1);
+  assert.deepStrictEqual(client.requests[0],
+                         ['fd_write', 1, new Uint8Array([1, 2]), undefined]);
+
+  scheduler.remove(client);
+  await until(() => !scheduler.running_);
+});
+
+/**
+ * Check requests that can't be queued are left to messages.
+ */
+it('unqueueable requests', () => {
+  const scheduler = new Scheduler();
+  const client = new TestClient();
+  const worker = new SlotClient(scheduler.add(client));
+  scheduler.remove(client);
+
+  // Handlers write into shared memory directly.
+  const shared = new Uint8Array(new SharedArrayBuffer(4));
+  assert.isFalse(worker.submit(client.lock, ['fd_read', 0, 4, shared]));
+  assert.isFalse(worker.submit(client.lock, ['fd_readv', 0, [4], [shared]]));
+  // Too big.
+  assert.isFalse(worker.submit(
+      client.lock, ['fd_write', 1, new Uint8Array(2048)]));
+});
+
+/**
+ * Check slots run out & get reused.
+ */
+it('slots', async () => {
+  const scheduler = new Scheduler({slots: 1});
+  const client1 = new TestClient();
+  const client2 = new TestClient();
+  assert.isNotNull(scheduler.add(client1));
+  assert.isNull(scheduler.add(client2));
+  scheduler.remove(client1);
+  assert.equal(scheduler.add(client2).index, 0);
+  scheduler.remove(client2);
+  await until(() => !scheduler.running_);
+});
+
+/**
+ * Check busy processes can't starve the others.
+ */
+it('fairness', async () => {
+  // With no time budget, every turn ends after one request.
+  const scheduler = new Scheduler({slots: 4, budget: 0});
+  const clients = [new TestClient(), new TestClient(), new TestClient()];
+  const workers = clients.map((client) => new SlotClient(
+      scheduler.add(client)));
+
+  // Everyone resubmits as soon as they're serviced, like a busy program.
+  const order = [];
+  clients.forEach((client, i) => {
+    client.onRequest = () => {
+      order.push(i);
+      if (order.length < 30) {
+        workers[i].submit(client.lock, ['sched_yield']);
+      }
+    };
+    workers[i].submit(client.lock, ['sched_yield']);
+  });
+
+  await until(() => order.length >= 30);
+  // Each process gets one turn before anyone gets a second.
+  for (let i = 0; i < 30; i += 3) {
+    assert.deepStrictEqual(order.slice(i, i + 3).sort(), [0, 1, 2]);
+  }
+  assert.isAtLeast(scheduler.stats.deferred, 1);
+
+  clients.forEach((client) => scheduler.remove(client));
+  await until(() => !scheduler.running_);
+});
+
+});
@@ -0,0 +1,219 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Tests for SyscallCache.
+ */
+
+import {SyscallHandler, WASI} from '../index.js';
+import {SyscallCache, kMaxFds} from '../js/syscall_cache.js';
+
+describe('syscall_cache.js', () => {
+
+/**
+ * If running on a web page, SharedArrayBuffers might not work.
+ *
+ * @suppress {missingProperties} https://github.com/google/closure-compiler/issues/4170
+ */
+before(function() {
+  if (window.SharedArrayBuffer === undefined) {
+    console.warn('SharedArrayBuffer API not available');
+    this.skip();
+  }
+});
+
+const stat = {
+  fs_filetype: WASI.filetype.CHARACTER_DEVICE,
+  fs_flags: WASI.fdflags.NONBLOCK,
+  fs_rights_base: 0xffffffffffffffffn,
+  fs_rights_inheriting: 0x100000001n,
+};
+
+/**
+ * Check fd metadata is shared & can be invalidated.
+ */
+it('fdstat', () => {
+  const writer = new SyscallCache();
+  const reader = new SyscallCache(writer.sab);
+  assert.isUndefined(reader.getFdstat(1));
+
+  writer.setFdstat(1, stat);
+  assert.deepStrictEqual(reader.getFdstat(1), stat);
+  assert.isUndefined(reader.getFdstat(2));
+
+  writer.invalidateFd(1);
+  assert.isUndefined(reader.getFdstat(1));
+});
+
+/**
+ * Check fds outside of the cache are ignored.
+ */
+it('fdstat out of range', () => {
+  const cache = new SyscallCache();
+  cache.setFdstat(kMaxFds, stat);
+  cache.invalidateFd(-1);
+  assert.isUndefined(cache.getFdstat(kMaxFds));
+  assert.isUndefined(cache.getFdstat(-1));
+});
+
+/**
+ * Check the window size is shared & can be invalidated.
+ */
+it('window size', () => {
+  const writer = new SyscallCache();
+  const reader = new SyscallCache(writer.sab);
+  assert.isUndefined(reader.getWindowSize());
+
+  const size = {row: 24, col: 80, xpixel: 0, ypixel: 0};
+  writer.setWindowSize(size);
+  assert.deepStrictEqual(reader.getWindowSize(), size);
+
+  writer.invalidateWindowSize();
+  assert.isUndefined(reader.getWindowSize());
+});
+
+/**
+ * Check the cached handler only proxies misses.
+ */
+it('CachedWasiPreview1', () => {
+  const calls = [];
+  const proxy = {
+    handle_fd_fdstat_get(fd) {
+      calls.push(fd);
+      return WASI.errno.EBADF;
+    },
+  };
+  const cache = new SyscallCache();
+  const handler = new SyscallHandler.CachedWasiPreview1(
+      cache.sab, /** @type {?} */ (proxy));
+
+  cache.setFdstat(0, stat);
+  assert.deepStrictEqual(handler.handle_fd_fdstat_get(0), stat);
+  assert.equal(handler.handle_fd_fdstat_get(3), WASI.errno.EBADF);
+  assert.deepStrictEqual(calls, [3]);
+
+  // The proxy doesn't implement this one.
+  assert.equal(handler.handle_tty_get_window_size(0), WASI.errno.ENOSYS);
+});
+
+/**
+ * Check waiters wake up when the readiness word changes.
+ */
+it('readiness', async () => {
+  const writer = new SyscallCache();
+  const reader = new SyscallCache(writer.sab);
+
+  // Changes between reading the word & waiting aren't lost.
+  const ready = reader.getReady();
+  writer.notifyReady();
+  assert.notEqual(reader.getReady(), ready);
+  await reader.waitReady(ready);
+
+  // Waiters are woken up.
+  const waiter = reader.waitReady(reader.getReady());
+  writer.notifyReady();
+  await waiter;
+
+  // Waits time out.
+  await reader.waitReady(reader.getReady(), 1);
+});
+
+/**
+ * Check pending signals are shared & wake up waiters.
+ */
+it('signals pending', async () => {
+  const writer = new SyscallCache();
+  const reader = new SyscallCache(writer.sab);
+  assert.isFalse(reader.getSignalsPending());
+
+  const waiter = reader.waitReady(reader.getReady());
+  writer.setSignalsPending(true);
+  await waiter;
+  assert.isTrue(reader.getSignalsPending());
+
+  writer.setSignalsPending(false);
+  assert.isFalse(reader.getSignalsPending());
+});
+
+/**
+ * Check pipe changes stay flagged until a poller takes them.
+ */
+it('pipes pending', async () => {
+  const writer = new SyscallCache();
+  const reader = new SyscallCache(writer.sab);
+  assert.isFalse(reader.takePipesPending());
+
+  const waiter = reader.waitReady(reader.getReady());
+  writer.setPipesPending();
+  await waiter;
+  assert.isTrue(reader.takePipesPending());
+  assert.isFalse(reader.takePipesPending());
+});
+
+/**
+ * Check clock-only polls are handled locally.
+ */
+it('CachedWasiPreview1 poll_oneoff', () => {
+  const calls = [];
+  const proxy = {
+    handle_poll_oneoff(subscriptions) {
+      calls.push(subscriptions.length);
+      return {events: []};
+    },
+  };
+  const cache = new SyscallCache();
+  const handler = new SyscallHandler.CachedWasiPreview1(
+      cache.sab, /** @type {?} */ (proxy));
+
+  const clock = {
+    userdata: 1n,
+    tag: WASI.eventtype.CLOCK,
+    clock: {
+      id: WASI.clock.MONOTONIC,
+      timeout: 0n,
+      precision: 0n,
+      flags: 0,
+    },
+  };
+  const fd = {
+    userdata: 2n,
+    tag: WASI.eventtype.FD_READ,
+    fd_read: {file_descriptor: 0},
+  };
+
+  const ret = handler.handle_poll_oneoff([clock]);
+  assert.equal(ret.events.length, 1);
+  assert.equal(ret.events[0].userdata, 1n);
+  assert.equal(ret.events[0].type, WASI.eventtype.CLOCK);
+  assert.deepStrictEqual(calls, []);
+
+  // Unknown clocks are rejected.
+  assert.equal(
+      handler.handle_poll_oneoff([{...clock, clock: {...clock.clock, id: 9}}]),
+      WASI.errno.ENOTSUP);
+
+  // Anything with fds goes to the main thread.
+  handler.handle_poll_oneoff([clock, fd]);
+  assert.deepStrictEqual(calls, [2]);
+
+  // Polls that watch pipes end early when one changes.
+  const pipeClock = {
+    ...clock,
+    userdata: SyscallHandler.kPipePollUserdata,
+    clock: {...clock.clock, timeout: 0xffffffffn * 1000000n},
+  };
+  assert.equal(handler.handle_fd_pipe_notify(), WASI.errno.ESUCCESS);
+  assert.deepStrictEqual(handler.handle_poll_oneoff([pipeClock]), {events: []});
+  // The flag is only for pipe polls, so it doesn't cut other sleeps short.
+  handler.handle_fd_pipe_notify();
+  assert.equal(handler.handle_poll_oneoff([clock]).events.length, 1);
+  assert.isTrue(cache.takePipesPending());
+
+  // As do sleeps when signals are waiting.
+  cache.setSignalsPending(true);
+  handler.handle_poll_oneoff([clock]);
+  assert.deepStrictEqual(calls, [2, 1]);
+});
+
+});
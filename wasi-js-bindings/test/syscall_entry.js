@@ -0,0 +1,238 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Tests for the syscall entries.
+ */
+
+import {SyscallEntry, WASI, WasiView} from '../index.js';
+
+describe('syscall_entry.js', () => {
+
+/**
+ * A minimal process backed by a chunk of memory.
+ */
+class FakeProcess {
+  /**
+   * @param {!ArrayBuffer|!SharedArrayBuffer} buffer The program memory.
+   */
+  constructor(buffer) {
+    this.mem = new Uint8Array(buffer);
+  }
+
+  getMem(base, end = undefined) {
+    return this.mem.subarray(base, end);
+  }
+
+  getView(base, length = undefined) {
+    return new WasiView(this.mem.buffer, base, length);
+  }
+
+  getMemView() {
+    return this.getView(0);
+  }
+
+  debug() {}
+  logGroup() {}
+  logError() {}
+}
+
+/**
+ * Layout in the fake memory: the iovec array, the result, then the buffers.
+ */
+const kIovs = 0;
+const kResult = 64;
+const kBufs = 128;
+
+/**
+ * Create an entry with iovecs of the specified sizes.
+ *
+ * @param {!Object} handler The syscall handler.
+ * @param {!Array<number>} lengths The size of each iovec.
+ * @param {boolean=} shared Whether to use shared memory.
+ * @return {{entry: !SyscallEntry.WasiPreview1, process: !FakeProcess}}
+ */
+function newEntry(handler, lengths, shared = false) {
+  const size = kBufs + Math.max(1024, lengths.reduce((a, b) => a + b, 0));
+  const process = new FakeProcess(
+      shared ? new SharedArrayBuffer(size) : new ArrayBuffer(size));
+  const dv = process.getView(kIovs);
+  let ptr = kBufs;
+  lengths.forEach((length, i) => {
+    dv.setUint32(i * 8, ptr, true);
+    dv.setUint32(i * 8 + 4, length, true);
+    ptr += length;
+  });
+  const entry = new SyscallEntry.WasiPreview1(
+      {sys_handlers: [handler], process});
+  return {entry, process};
+}
+
+/**
+ * Check vectored writes use one handler call.
+ */
+it('fd_write writev', () => {
+  const calls = [];
+  const handler = {
+    handle_fd_writev(fd, bufs) {
+      calls.push(bufs.map((buf) => Array.from(buf)));
+      return {nwritten: 3};
+    },
+  };
+  const {entry, process} = newEntry(handler, [2, 1]);
+  process.mem.set([1, 2, 3], kBufs);
+
+  assert.equal(entry.sys_fd_write(1, kIovs, 2, kResult), WASI.errno.ESUCCESS);
+  assert.deepStrictEqual(calls, [[[1, 2], [3]]]);
+  assert.equal(process.getView(kResult).getUint32(0, true), 3);
+});
+
+/**
+ * Check writes fallback to one call per iovec.
+ */
+it('fd_write fallback', () => {
+  const calls = [];
+  const handler = {
+    handle_fd_write(fd, buf) {
+      calls.push(Array.from(buf));
+      return {nwritten: buf.length};
+    },
+  };
+  const {entry, process} = newEntry(handler, [2, 1]);
+  process.mem.set([1, 2, 3], kBufs);
+
+  assert.equal(entry.sys_fd_write(1, kIovs, 2, kResult), WASI.errno.ESUCCESS);
+  assert.deepStrictEqual(calls, [[1, 2], [3]]);
+  assert.equal(process.getView(kResult).getUint32(0, true), 3);
+});
+
+/**
+ * Check vectored reads scatter a returned buffer over the iovecs.
+ */
+it('fd_read readv', () => {
+  const calls = [];
+  const handler = {
+    handle_fd_readv(fd, lengths, dests) {
+      calls.push({lengths, dests});
+      return {buf: new Uint8Array([1, 2, 3, 4])};
+    },
+  };
+  const {entry, process} = newEntry(handler, [3, 3]);
+
+  assert.equal(entry.sys_fd_read(0, kIovs, 2, kResult), WASI.errno.ESUCCESS);
+  assert.deepStrictEqual(calls, [{lengths: [3, 3], dests: undefined}]);
+  assert.deepStrictEqual(Array.from(process.getMem(kBufs, kBufs + 6)),
+                         [1, 2, 3, 4, 0, 0]);
+  assert.equal(process.getView(kResult).getUint32(0, true), 4);
+});
+
+/**
+ * Check vectored reads into shared memory write directly.
+ */
+it('fd_read readv shared', () => {
+  const handler = {
+    handle_fd_readv(fd, lengths, dests) {
+      dests[0].set([1, 2]);
+      dests[1].set([3]);
+      return {nread: 3};
+    },
+  };
+  const {entry, process} = newEntry(handler, [2, 2], true);
+
+  assert.equal(entry.sys_fd_read(0, kIovs, 2, kResult), WASI.errno.ESUCCESS);
+  assert.deepStrictEqual(Array.from(process.getMem(kBufs, kBufs + 4)),
+                         [1, 2, 3, 0]);
+  assert.equal(process.getView(kResult).getUint32(0, true), 3);
+});
+
+/**
+ * Check large vectored reads into unshared memory go through shared staging.
+ */
+it('fd_read readv staged', () => {
+  const big = 16 * 1024;
+  const handler = {
+    handle_fd_readv(fd, lengths, dests) {
+      assert.isTrue(dests[0].buffer instanceof SharedArrayBuffer);
+      assert.deepStrictEqual(dests.map((dest) => dest.length), lengths);
+      dests[0].fill(1);
+      dests[1].set([2]);
+      return {nread: big + 1};
+    },
+  };
+  const {entry, process} = newEntry(handler, [big, 2]);
+
+  assert.equal(entry.sys_fd_read(0, kIovs, 2, kResult), WASI.errno.ESUCCESS);
+  const mem = process.getMem(kBufs, kBufs + big + 2);
+  assert.isTrue(mem.subarray(0, big).every((byte) => byte === 1));
+  assert.deepStrictEqual(Array.from(mem.subarray(big)), [2, 0]);
+  assert.equal(process.getView(kResult).getUint32(0, true), big + 1);
+});
+
+/**
+ * Check large reads into unshared memory go through shared staging.
+ */
+it('fd_read staged', () => {
+  const big = 16 * 1024;
+  const handler = {
+    handle_fd_read(fd, length, dest) {
+      dest.set([1, 2, 3]);
+      return {nread: 3};
+    },
+  };
+  const {entry, process} = newEntry(handler, [big]);
+
+  assert.equal(entry.sys_fd_read(0, kIovs, 1, kResult), WASI.errno.ESUCCESS);
+  assert.deepStrictEqual(Array.from(process.getMem(kBufs, kBufs + 4)),
+                         [1, 2, 3, 0]);
+  assert.equal(process.getView(kResult).getUint32(0, true), 3);
+});
+
+/**
+ * Check reads fallback to one call per iovec.
+ */
+it('fd_read fallback', () => {
+  const calls = [];
+  const handler = {
+    handle_fd_read(fd, length) {
+      calls.push(length);
+      return {buf: new Uint8Array(length).fill(calls.length)};
+    },
+  };
+  const {entry, process} = newEntry(handler, [1, 2]);
+
+  assert.equal(entry.sys_fd_read(0, kIovs, 2, kResult), WASI.errno.ESUCCESS);
+  assert.deepStrictEqual(calls, [1, 2]);
+  assert.deepStrictEqual(Array.from(process.getMem(kBufs, kBufs + 3)),
+                         [1, 2, 2]);
+  assert.equal(process.getView(kResult).getUint32(0, true), 3);
+});
+
+/**
+ * Check vectored pread/pwrite get the offset.
+ */
+it('fd_pread/fd_pwrite vectored', () => {
+  const calls = [];
+  const handler = {
+    handle_fd_preadv(fd, lengths, offset, dests) {
+      calls.push(offset);
+      return {buf: new Uint8Array([5])};
+    },
+    handle_fd_pwritev(fd, bufs, offset) {
+      calls.push(offset);
+      return WASI.errno.ESUCCESS;
+    },
+  };
+  const {entry, process} = newEntry(handler, [1, 2]);
+  const dv = process.getView(kResult);
+
+  assert.equal(entry.sys_fd_pread(3, kIovs, 2, 10n, kResult),
+               WASI.errno.ESUCCESS);
+  assert.equal(dv.getUint32(0, true), 1);
+  assert.equal(entry.sys_fd_pwrite(3, kIovs, 2, 20n, kResult),
+               WASI.errno.ESUCCESS);
+  assert.equal(dv.getUint32(0, true), 3);
+  assert.deepStrictEqual(calls, [10n, 20n]);
+});
+
+});
@@ -35,17 +35,139 @@ it('setData and getData BigInt', () => {
 });
 
 /**
- * Check TypedArray is correctly serialized and deserialized as an Array.
+ * Check TypedArray is correctly serialized and deserialized.
  */
 it('setData and getData TypedArray', () => {
   const typedArray = new Uint8Array([1, 2, 3, 4, 5]);
   const buf = new SharedArrayBuffer(64 * 1024);
   const lock = new SyscallLock(buf);
   const data = {foo: [{bar: typedArray}]};
-  const expected = {foo: [{bar: Array.from(typedArray)}]};
   lock.setData(data);
   const deserialized = lock.getData();
-  assert.deepStrictEqual(deserialized, expected);
+  assert.deepStrictEqual(deserialized, data);
+});
+
+/**
+ * Check the common syscall result shapes round trip.
+ */
+it('setData and getData shapes', () => {
+  const buf = new SharedArrayBuffer(64 * 1024);
+  const lock = new SyscallLock(buf);
+  [
+    {nread: 10},
+    {buf: new Uint8Array([0, 255]), nread: 2},
+    {
+      nwritten: 3,
+      domain: 1,
+      address: '127.0.0.1',
+      port: 22,
+    },
+    {
+      fs_filetype: 4,
+      fs_flags: 0,
+      fs_rights_base: 0xffffffffffffffffn,
+      fs_rights_inheriting: 0n,
+    },
+    {events: [{userdata: -1n, error: 0, type: 1}], neg: -5, float: 1.5},
+    {path: 'ünïcode ✓', ok: true, bad: false, none: null},
+    {a: new Uint16Array([1, 2]), b: new Int32Array([-1]), c: []},
+  ].forEach((data) => {
+    lock.setData(data);
+    assert.deepStrictEqual(lock.getData(), data);
+  });
+});
+
+/**
+ * Check the fixed layouts round trip, and fall back when results don't fit.
+ */
+it('setData and getData fixed shapes', () => {
+  const buf = new SharedArrayBuffer(64 * 1024);
+  const lock = new SyscallLock(buf);
+  const filestat = {
+    filetype: 4,
+    dev: 1n,
+    ino: 2n,
+    nlink: 3n,
+    size: 0xffffffffffffffffn,
+    atim: 5n,
+    mtim: 6n,
+    ctim: 7n,
+  };
+  [
+    ['fd_read', {buf: new Uint8Array([1, 2, 3])}],
+    ['fd_readv', {nread: 0xffffffff}],
+    ['fd_pread', {buf: new Uint8Array(0), nread: 0}],
+    ['fd_read', {}],
+    ['fd_filestat_get', filestat],
+    ['path_filestat_get', filestat],
+    ['fd_fdstat_get', {
+      fs_filetype: 6,
+      fs_flags: 4,
+      fs_rights_base: 0xffffffffffffffffn,
+      fs_rights_inheriting: 0n,
+    }],
+    ['sock_get_name', {family: 2, address: [127, 0, 0, 1], port: 22}],
+    ['sock_recvfrom', {
+      nread: 5,
+      domain: 10,
+      address: [0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1],
+      port: 65535,
+    }],
+  ].forEach(([syscall, data]) => {
+    lock.setData(data, syscall);
+    assert.equal(lock.sabDataArr[0], 0xfe, syscall);
+    assert.deepStrictEqual(lock.getData(), data);
+  });
+
+  // Results that don't match their shape use the generic encoding.
+  [
+    ['fd_read', {nread: 1, extra: 2}],
+    ['fd_read', {nread: -1}],
+    ['fd_read', {buf: new Uint16Array(1)}],
+    ['fd_fdstat_get', {fs_filetype: 6}],
+    ['fd_filestat_get', {...filestat, size: 10}],
+    ['sock_get_name', {family: 2, address: [256, 0, 0, 1], port: 22}],
+    ['sock_get_name', {family: 2, address: '127.0.0.1', port: 22}],
+  ].forEach(([syscall, data]) => {
+    lock.setData(data, syscall);
+    assert.equal(lock.sabDataArr[0], 0xff, syscall);
+    assert.deepStrictEqual(lock.getData(), data);
+  });
+});
+
+/**
+ * Check undefined members are dropped like JSON does.
+ */
+it('setData and getData undefined', () => {
+  const buf = new SharedArrayBuffer(64 * 1024);
+  const lock = new SyscallLock(buf);
+  lock.setData({a: undefined, b: [undefined]});
+  assert.deepStrictEqual(lock.getData(), {b: [null]});
+});
+
+/**
+ * Check objects the binary encoding can't handle fall back to JSON.
+ */
+it('setData and getData fallback', () => {
+  class Foo {
+    constructor() {
+      this.x = 1;
+      this.y = new Uint8Array([1, 2]);
+    }
+  }
+  const buf = new SharedArrayBuffer(64 * 1024);
+  const lock = new SyscallLock(buf);
+  lock.setData({foo: new Foo()});
+  assert.deepStrictEqual(lock.getData(), {foo: {x: 1, y: [1, 2]}});
+});
+
+/**
+ * Check data that doesn't fit is rejected.
+ */
+it('setData too large', () => {
+  const buf = new SharedArrayBuffer(1024);
+  const lock = new SyscallLock(buf);
+  assert.throws(() => lock.setData({buf: new Uint8Array(2048)}), RangeError);
 });
 
 });
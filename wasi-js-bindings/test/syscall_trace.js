@@ -0,0 +1,192 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Tests for syscall record & replay.
+ */
+
+import {SyscallHandler, WASI} from '../index.js';
+import {TraceReader, TraceWriter} from '../js/syscall_trace.js';
+
+describe('syscall_trace.js', () => {
+
+/**
+ * Check traces decode to what was recorded.
+ */
+it('round trip', () => {
+  const writer = new TraceWriter();
+  writer.record('clock_time_get', [1], {now: 123456789n});
+  writer.record('fd_write', [1, new Uint8Array(3)], WASI.errno.ESUCCESS);
+  writer.record('clock_time_get', [1], WASI.errno.EINVAL);
+  writer.record('fd_read', [0, 4, undefined], {nread: 2},
+                new Uint8Array([1, 2]));
+  assert.equal(writer.count, 4);
+
+  const reader = new TraceReader(writer.toBytes());
+  assert.deepStrictEqual(reader.readAll(), [
+    {name: 'clock_time_get', args: [1], ret: {now: 123456789n}, out: null},
+    // Buffers from the program are only recorded by length.
+    {name: 'fd_write', args: [1, 3], ret: WASI.errno.ESUCCESS, out: null},
+    {name: 'clock_time_get', args: [1], ret: WASI.errno.EINVAL, out: null},
+    {
+      name: 'fd_read', args: [0, 4, null], ret: {nread: 2},
+      out: new Uint8Array([1, 2]),
+    },
+  ]);
+  assert.isNull(reader.next());
+});
+
+/**
+ * Check large records grow the trace.
+ */
+it('large records', () => {
+  const writer = new TraceWriter();
+  const buf = new Uint8Array(200 * 1024).fill(7);
+  writer.record('sched_yield', [], WASI.errno.ESUCCESS);
+  writer.record('fd_read', [0, buf.length], {buf});
+  writer.record('sched_yield', [], WASI.errno.ESUCCESS);
+
+  const records = new TraceReader(writer.toBytes()).readAll();
+  assert.equal(records.length, 3);
+  assert.deepStrictEqual(records[1].ret.buf, buf);
+  assert.equal(records[2].name, 'sched_yield');
+});
+
+/**
+ * Check non-traces are rejected.
+ */
+it('bad trace', () => {
+  assert.throws(() => new TraceReader(new Uint8Array([1, 2, 3, 4, 5, 6])));
+});
+
+/**
+ * A handler with some typical syscalls.
+ */
+class TestHandler extends SyscallHandler.Base {
+  constructor() {
+    super();
+    this.calls = [];
+  }
+
+  handle_clock_time_get(clockid) {
+    this.calls.push('clock_time_get');
+    return {now: 1000n};
+  }
+
+  handle_fd_read(fd, length, dest) {
+    this.calls.push('fd_read');
+    if (dest) {
+      dest.set([1, 2, 3]);
+      return {nread: 3};
+    }
+    return {buf: new Uint8Array([4, 5])};
+  }
+
+  handle_fd_write(fd, buf) {
+    this.calls.push('fd_write');
+    return WASI.errno.ESUCCESS;
+  }
+
+  handle_proc_exit(status) {
+    this.calls.push('proc_exit');
+    throw new Error('exited');
+  }
+
+  handle_random_get(buf) {
+    this.calls.push('random_get');
+    buf.fill(9);
+    return WASI.errno.ESUCCESS;
+  }
+}
+
+/**
+ * Check the recorder passes calls thru & captures their results.
+ */
+it('RecordWasiPreview1', () => {
+  const handler = new TestHandler();
+  const recorder = new SyscallHandler.RecordWasiPreview1([handler]);
+
+  assert.deepStrictEqual(recorder.handle_clock_time_get(0), {now: 1000n});
+  const dest = new Uint8Array(8);
+  assert.deepStrictEqual(recorder.handle_fd_read(0, 8, dest), {nread: 3});
+  assert.deepStrictEqual(recorder.handle_fd_read(0, 8, undefined),
+                         {buf: new Uint8Array([4, 5])});
+  assert.equal(recorder.handle_fd_write(1, new Uint8Array(10)),
+               WASI.errno.ESUCCESS);
+  assert.equal(recorder.handle_random_get(new Uint8Array(2)),
+               WASI.errno.ESUCCESS);
+  assert.throws(() => recorder.handle_proc_exit(0), /exited/);
+  assert.deepStrictEqual(handler.calls, [
+    'clock_time_get', 'fd_read', 'fd_read', 'fd_write', 'random_get',
+    'proc_exit',
+  ]);
+
+  const records = new TraceReader(recorder.trace.toBytes()).readAll();
+  assert.deepStrictEqual(records.map(({name, out}) => [name, out]), [
+    ['clock_time_get', null],
+    // Only the bytes read are kept.
+    ['fd_read', new Uint8Array([1, 2, 3])],
+    ['fd_read', null],
+    ['fd_write', null],
+    ['random_get', new Uint8Array([9, 9])],
+    ['proc_exit', null],
+  ]);
+});
+
+/**
+ * Check the replay answers calls from the trace.
+ */
+it('ReplayWasiPreview1', () => {
+  const recorder = new SyscallHandler.RecordWasiPreview1([new TestHandler()]);
+  recorder.handle_clock_time_get(0);
+  recorder.handle_fd_read(0, 8, new Uint8Array(8));
+  recorder.handle_fd_read(0, 8, undefined);
+  recorder.handle_random_get(new Uint8Array(2));
+  recorder.handle_fd_write(1, new Uint8Array(10));
+  assert.throws(() => recorder.handle_proc_exit(0));
+
+  const replay = new SyscallHandler.ReplayWasiPreview1(
+      recorder.trace.toBytes());
+  // The next handler has to exit the program.
+  assert.isFalse('handle_proc_exit' in replay);
+
+  assert.deepStrictEqual(replay.handle_clock_time_get(0), {now: 1000n});
+  // Output is written directly when possible, or returned otherwise.
+  const dest = new Uint8Array(8);
+  assert.deepStrictEqual(replay.handle_fd_read(0, 8, dest), {nread: 3});
+  assert.deepStrictEqual(dest, new Uint8Array([1, 2, 3, 0, 0, 0, 0, 0]));
+  assert.deepStrictEqual(replay.handle_fd_read(0, 8, undefined),
+                         {buf: new Uint8Array([4, 5])});
+  const buf = new Uint8Array(2);
+  assert.equal(replay.handle_random_get(buf), WASI.errno.ESUCCESS);
+  assert.deepStrictEqual(buf, new Uint8Array([9, 9]));
+  assert.isFalse(replay.isDone());
+
+  // Programs that do something different are caught.
+  assert.throws(() => replay.handle_fd_write(2, new Uint8Array(10)),
+                /argument 0/);
+});
+
+/**
+ * Check the replay catches programs that diverge from the trace.
+ */
+it('ReplayWasiPreview1 divergence', () => {
+  const recorder = new SyscallHandler.RecordWasiPreview1([new TestHandler()]);
+  recorder.handle_clock_time_get(0);
+  recorder.handle_fd_write(1, new Uint8Array(10));
+
+  let replay = new SyscallHandler.ReplayWasiPreview1(
+      recorder.trace.toBytes());
+  assert.throws(() => replay.handle_fd_write(1, new Uint8Array(10)),
+                /is clock_time_get/);
+
+  replay = new SyscallHandler.ReplayWasiPreview1(
+      recorder.trace.toBytes(), {checkArgs: false});
+  replay.handle_clock_time_get(1);
+  replay.handle_fd_write(1, new Uint8Array(5));
+  assert.isTrue(replay.isDone());
+  assert.throws(() => replay.handle_clock_time_get(0), /end of the trace/);
+});
+
+});
@@ -0,0 +1,77 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Tests for WorkerPool.
+ */
+
+import {WorkerPool} from '../index.js';
+
+describe('worker_pool.js', () => {
+
+/**
+ * A pool that creates fake workers.
+ */
+class TestPool extends WorkerPool {
+  constructor(...args) {
+    super(...args);
+    this.spawned = [];
+  }
+
+  /** @override */
+  spawn_() {
+    const w = new EventTarget();
+    w.terminated = false;
+    w.terminate = () => { w.terminated = true; };
+    this.spawned.push(w);
+    return /** @type {!Worker} */ (w);
+  }
+}
+
+/**
+ * Check idle workers are handed out & replaced.
+ */
+it('claim', async () => {
+  const pool = new TestPool('worker.js', {size: 2});
+  pool.fill();
+  assert.equal(pool.spawned.length, 2);
+
+  assert.strictEqual(pool.claim(), pool.spawned[0]);
+  assert.strictEqual(pool.claim(), pool.spawned[1]);
+  // The pool is empty, so this is a new one.
+  assert.strictEqual(pool.claim(), pool.spawned[2]);
+
+  // Let the refill run.
+  await new Promise((resolve) => setTimeout(resolve));
+  assert.equal(pool.spawned.length, 5);
+  assert.strictEqual(pool.claim(), pool.spawned[3]);
+});
+
+/**
+ * Check broken workers aren't handed out.
+ */
+it('error', () => {
+  const pool = new TestPool('worker.js');
+  pool.fill();
+  const [w] = pool.spawned;
+  w.dispatchEvent(new Event('error'));
+  assert.isTrue(w.terminated);
+  assert.notStrictEqual(pool.claim(), w);
+});
+
+/**
+ * Check shutting down the pool.
+ */
+it('terminate', async () => {
+  const pool = new TestPool('worker.js');
+  pool.fill();
+  pool.terminate();
+  assert.isTrue(pool.spawned[0].terminated);
+  pool.claim();
+  await new Promise((resolve) => setTimeout(resolve));
+  // Nothing new was spawned in the background.
+  assert.equal(pool.spawned.length, 2);
+});
+
+});
@@ -0,0 +1,92 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Benchmark in-memory VFS file writes.
+ *
+ * Compares appending to a FileHandle against the exact-size growth it used to
+ * do, where every write past the end copied the whole file.  This is what
+ * known_hosts updates, logs, and scp/sftp downloads into the VFS look like.
+ *
+ * Run it with node:
+ *   node bench/vfs.js
+ */
+
+import * as VFS from '../js/vfs.js';
+
+/**
+ * The file sizes (in MiB) & write sizes (in bytes) to try.
+ */
+const kCases = [
+  {size: 1, write: 1024},
+  {size: 4, write: 4096},
+  {size: 8, write: 16 * 1024},
+];
+
+/**
+ * A FileHandle that grows like it used to.
+ */
+class ExactFileHandle extends VFS.FileHandle {
+  /** @override */
+  async pwrite(buf, offset) {
+    offset = Number(offset);
+    if (this.data.length < offset + buf.length) {
+      const data = new Uint8Array(offset + buf.length);
+      data.set(this.data);
+      this.data = data;
+    }
+    this.data.set(buf, offset);
+    return {nwritten: buf.length};
+  }
+}
+
+/**
+ * Time appending a file.
+ *
+ * @param {function(new:VFS.FileHandle, string)} cls The handle to use.
+ * @param {number} size How big to make the file in bytes.
+ * @param {number} write How many bytes to append at a time.
+ * @return {!Promise<number>} How long it took in milliseconds.
+ */
+async function timeAppend(cls, size, write) {
+  const buf = new Uint8Array(write).fill(0xa5);
+  const fh = new cls('/bench');
+  const start = performance.now();
+  for (let written = 0; written < size; written += write) {
+    await fh.write(buf);
+  }
+  return performance.now() - start;
+}
+
+/**
+ * Run all the benchmarks.
+ *
+ * @return {!Promise<!Array<{name: string, before: number, after: number}>>}
+ *     The time to write each file in milliseconds.
+ */
+export async function run() {
+  const ret = [];
+  for (const {size, write} of kCases) {
+    const bytes = size * 1024 * 1024;
+    // Warm up the JIT before timing.
+    await timeAppend(ExactFileHandle, 64 * 1024, write);
+    await timeAppend(VFS.FileHandle, 64 * 1024, write);
+    ret.push({
+      name: `append ${size} MiB in ${write} byte writes`,
+      before: await timeAppend(ExactFileHandle, bytes, write),
+      after: await timeAppend(VFS.FileHandle, bytes, write),
+    });
+  }
+  return ret;
+}
+
+if (globalThis.process?.argv?.[1]?.endsWith('vfs.js')) {
+  console.log('workload'.padEnd(36) + 'before ms'.padStart(12) +
+              'after ms'.padStart(12) + 'speedup'.padStart(10));
+  (await run()).forEach(({name, before, after}) => {
+    console.log(name.padEnd(36) + before.toFixed(1).padStart(12) +
+                after.toFixed(1).padStart(12) +
+                `${(before / after).toFixed(1)}x`.padStart(10));
+  });
+}
@@ -17,4 +17,33 @@ export const AF_INET = 1;
 export const AF_INET6 = 2;
 export const AF_UNIX = 3;
 
+// wasi-libc maps MSG_PEEK & MSG_WAITALL to the WASI riflags.
+export const MSG_PEEK = 0x1;
+export const MSG_WAITALL = 0x2;
 export const MSG_DONTWAIT = 0x40;
+
+// Linux epoll() settings.
+export const EPOLL_CTL_ADD = 1;
+export const EPOLL_CTL_DEL = 2;
+export const EPOLL_CTL_MOD = 3;
+export const EPOLLIN = 0x001;
+export const EPOLLOUT = 0x004;
+export const EPOLLERR = 0x008;
+export const EPOLLHUP = 0x010;
+export const EPOLLRDNORM = 0x040;
+export const EPOLLWRNORM = 0x100;
+export const EPOLLRDHUP = 0x2000;
+
+// Linux splice() flags.
+export const SPLICE_F_MOVE = 0x1;
+export const SPLICE_F_NONBLOCK = 0x2;
+export const SPLICE_F_MORE = 0x4;
+
+// wassh SO_WASSH_PROFILE values.
+export const WASSH_SOCK_PROFILE_DEFAULT = 0;
+export const WASSH_SOCK_PROFILE_INTERACTIVE = 1;
+export const WASSH_SOCK_PROFILE_BULK = 2;
+
+// wassh SO_WASSH_DROP_POLICY values.
+export const WASSH_SOCK_DROP_OLDEST = 0;
+export const WASSH_SOCK_DROP_NEWEST = 1;
@@ -13,10 +13,44 @@ import {Process} from '../../wasi-js-bindings/index.js';
 /**
  * Background process w/wassh extensions.
  *
- * We aren't customizing it currently, but we might in the future, so provide a
- * name now to avoid rewriting symbols in the future.
+ * This adds the pending signal bitmap shared with the C library.
  */
-export class Foreground extends Process.Foreground {}
+export class Foreground extends Process.Foreground {
+  constructor(...args) {
+    super(...args);
+
+    /**
+     * Where the program wants pending signals queued (see signal_register).
+     *
+     * @type {?number}
+     */
+    this.signal_pending_ptr = null;
+  }
+
+  /**
+   * Queue signals in the program's pending bitmap.
+   *
+   * @param {!Array<number>} signals The signals to queue.  These use musl ABI
+   *     for signal numbers, not WASI ABI.
+   * @return {boolean} Whether the signals were queued.  If the program hasn't
+   *     registered a bitmap, the caller needs to deliver them itself.
+   */
+  queue_signals(signals) {
+    if (this.signal_pending_ptr === null) {
+      return false;
+    }
+
+    const u32 = new Uint32Array(
+        this.instance_.exports.memory.buffer, this.signal_pending_ptr, 2);
+    signals.forEach((signum) => {
+      const bit = signum - 1;
+      if (bit >= 0 && bit < 64) {
+        Atomics.or(u32, bit >> 5, 1 << (bit & 31));
+      }
+    });
+    return true;
+  }
+}
 
 /**
  * Background process w/wassh extensions.
@@ -36,10 +70,13 @@ export class Background extends Process.Background {
    *     numbers, not WASI ABI.
    */
   send_signal(signum) {
-    this.signal_queue.push(signum);
-    if (this.handler.notify_) {
-      this.handler.notify_();
+    // Standard signals don't queue, so coalesce repeats (e.g. SIGWINCH while
+    // the user drags the window around).
+    if (!this.signal_queue.includes(signum)) {
+      this.signal_queue.push(signum);
     }
+    // Wake up the program if it's sleeping or polling.
+    this.cache.setSignalsPending(true);
   }
 
   /**
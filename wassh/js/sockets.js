@@ -13,21 +13,70 @@ import * as Constants from './constants.js';
 import * as VFS from './vfs.js';
 
 const SOL_SOCKET = 0x7fffffff;
-// const SO_RCVBUF sets bufferSize.
 const SO_REUSEADDR = 2;
 const SO_ERROR = 4;
+const SO_SNDBUF = 7;
+const SO_RCVBUF = 8;
 const SO_KEEPALIVE = 9;
+// Our own option to pick the socket's Constants.WASSH_SOCK_PROFILE_xxx.
+const SO_WASSH_PROFILE = 0x5700;
+// Our own option to pick the datagram Constants.WASSH_SOCK_DROP_xxx policy.
+const SO_WASSH_DROP_POLICY = 0x5701;
 const IPPROTO_IP = 0;
 const IPPROTO_IPV6 = 41;
 const IP_TOS = 1;
 const IP_MTU_DISCOVER = 10;
 const IPPROTO_TCP = 6;
 const TCP_NODELAY = 1;
+const TCP_CORK = 3;
 const IPV6_V6ONLY = 26;
 const IPV6_TCLASS = 67;
 // Time (seconds) for default keep alive intervals.  This matches Linux.
 const TCP_KEEPALIVE_INTVL = 75;
 
+// Default & limits for SO_SNDBUF & SO_RCVBUF.
+const kDefaultBufferSize = 64 * 1024;
+const kMinBufferSize = 4 * 1024;
+const kMaxBufferSize = 4 * 1024 * 1024;
+
+// Interactive sockets never hand more than this to the transport in one write
+// so keystrokes don't get stuck behind a large bulk transfer.
+const kInteractiveSendSize = 16 * 1024;
+
+// Like Linux, corked data is sent anyway after this long (milliseconds).
+const kCorkDelay = 200;
+
+// Stream sockets stop reading from the transport once this many receive
+// buffers (SO_RCVBUF) worth of data is waiting for the program, and start again
+// once it has read all but a quarter buffer.
+const kRecvHighWater = 2;
+const kRecvLowWater = 0.25;
+
+/**
+ * Clamp a SO_SNDBUF or SO_RCVBUF size to what we support.
+ *
+ * @param {number} size
+ * @return {number}
+ */
+function clampBufferSize(size) {
+  return Math.min(Math.max(size, kMinBufferSize), kMaxBufferSize);
+}
+
+/**
+ * IP_TOS/IPV6_TCLASS values that select a socket profile.
+ *
+ * This covers the values OpenSSH's IPQoS setting uses for interactive & bulk
+ * sessions.  Anything else uses the default profile.
+ */
+const TOS_TO_PROFILE = new Map([
+  // Interactive: lowdelay, af21, af31, af41, cs5, ef, cs6, cs7.
+  ...[0x10, 0x48, 0x68, 0x88, 0xa0, 0xb8, 0xc0, 0xe0].map(
+      (tos) => [tos, Constants.WASSH_SOCK_PROFILE_INTERACTIVE]),
+  // Bulk: le, throughput, cs1, af11.
+  ...[0x04, 0x08, 0x20, 0x28].map(
+      (tos) => [tos, Constants.WASSH_SOCK_PROFILE_BULK]),
+]);
+
 /**
  * Map Chrome net errors to errno values when possible.
  */
@@ -36,6 +85,7 @@ const CHROME_NET_ERROR_TO_ERRNO = {
   [NetErrorList.INVALID_ARGUMENT]: WASI.errno.EINVAL,
   [NetErrorList.TIMED_OUT]: WASI.errno.ETIMEDOUT,
   [NetErrorList.SUCCESS]: WASI.errno.ESUCCESS,
+  [NetErrorList.CONNECTION_RESET]: WASI.errno.ECONNRESET,
   [NetErrorList.CONNECTION_REFUSED]: WASI.errno.ECONNREFUSED,
   [NetErrorList.NAME_NOT_RESOLVED]: WASI.errno.EHOSTUNREACH,
   [NetErrorList.ADDRESS_IN_USE]: WASI.errno.EADDRINUSE,
@@ -122,6 +172,107 @@ export function strAddrToArray(strAddress) {
   return address;
 }
 
+/**
+ * Queue of received stream data.
+ *
+ * Data is kept in the chunks it arrived in, so adding data never copies what's
+ * already queued, and reads only copy what they return.
+ */
+export class ByteQueue {
+  constructor() {
+    // Chunks before head_ have been read, and are cleared to free them.
+    /** @type {!Array<?Uint8Array>} */
+    this.chunks_ = [];
+    // The first chunk that hasn't been fully read.
+    this.head_ = 0;
+    // How much of the first chunk has been read.
+    this.offset_ = 0;
+    /** @type {number} How many bytes are queued. */
+    this.length = 0;
+  }
+
+  /**
+   * Add data to the end of the queue.
+   *
+   * @param {!Uint8Array} u8 The data.  The queue keeps a reference to it.
+   */
+  push(u8) {
+    if (u8.length) {
+      this.chunks_.push(u8);
+      this.length += u8.length;
+    }
+  }
+
+  /**
+   * Copy data from the front of the queue without removing it.
+   *
+   * @param {!Uint8Array} dest Where to copy the data to.
+   * @param {number=} length How many bytes to copy.
+   * @return {number} How many bytes were copied.
+   */
+  copyTo(dest, length = dest.length) {
+    length = Math.min(length, dest.length, this.length);
+    let offset = this.offset_;
+    let copied = 0;
+    for (let i = this.head_; copied < length; ++i) {
+      const chunk = this.chunks_[i].subarray(offset, offset + length - copied);
+      dest.set(chunk, copied);
+      copied += chunk.length;
+      offset = 0;
+    }
+    return copied;
+  }
+
+  /**
+   * Get data from the front of the queue without removing it.
+   *
+   * @param {number} length The most bytes to return.
+   * @return {!Uint8Array} The data.  This may be a view of queued data.
+   */
+  peek(length) {
+    length = Math.min(length, this.length);
+    if (length === 0) {
+      return new Uint8Array(0);
+    }
+    const first = this.chunks_[this.head_];
+    if (this.offset_ + length <= first.length) {
+      return first.subarray(this.offset_, this.offset_ + length);
+    }
+    const ret = new Uint8Array(length);
+    this.copyTo(ret);
+    return ret;
+  }
+
+  /**
+   * Remove data from the front of the queue.
+   *
+   * @param {number} length How many bytes to remove.
+   */
+  consume(length) {
+    length = Math.min(length, this.length);
+    this.length -= length;
+    while (length) {
+      const left = this.chunks_[this.head_].length - this.offset_;
+      if (length < left) {
+        this.offset_ += length;
+        break;
+      }
+      length -= left;
+      this.chunks_[this.head_++] = null;
+      this.offset_ = 0;
+    }
+
+    // Drop the consumed chunks once they're a good part of the list.
+    if (this.head_ === this.chunks_.length) {
+      this.chunks_.length = 0;
+      this.head_ = 0;
+    } else if (this.head_ >= 1024 && this.head_ * 2 >= this.chunks_.length) {
+      this.chunks_ = this.chunks_.slice(this.head_);
+      this.head_ = 0;
+    }
+  }
+}
+
 /**
  * Base class for all socket types.
  *
@@ -183,6 +334,53 @@ export class Socket extends VFS.PathHandle {
     throw new Error('onData(): unimplemented');
   }
 
+  /**
+   * How many bytes the next read could return (for FIONREAD).
+   *
+   * @return {number}
+   */
+  pendingBytes() {
+    return 0;
+  }
+
+  /**
+   * Whether the peer won't send any more data (EOF, reset, or close).
+   *
+   * Reads return right away once this is set, so it counts as readable.
+   *
+   * @return {boolean}
+   */
+  recvEnded() {
+    return false;
+  }
+
+  /**
+   * Whether a write would be queued right away rather than wait for room.
+   *
+   * @return {boolean}
+   */
+  writeReady() {
+    return true;
+  }
+
+  /**
+   * Whether an error is waiting to be returned (see SO_ERROR).
+   *
+   * @return {boolean}
+   */
+  hasError() {
+    return this.error !== WASI.errno.ESUCCESS;
+  }
+
+  /**
+   * Send anything still queued before the socket is shut down.
+   *
+   * @return {!Promise<!WASI_t.errno>} The first error sending it, if any.
+   */
+  async drain() {
+    return WASI.errno.ESUCCESS;
+  }
+
   /**
    * @return {!Promise<!WASI_t.errno|!WASI_t.fdstat>}
    * @override
@@ -299,8 +497,241 @@ export class StreamSocket extends Socket {
   constructor(domain, type, protocol) {
     super(domain, type, protocol);
 
-    // TODO(vapier): Make this into a stream.
-    this.data = new Uint8Array(0);
+    /** @type {!ByteQueue} Data waiting for the program to read. */
+    this.data = new ByteQueue();
+    // Whether we've stopped reading from the transport until the program
+    // catches up.
+    this.recvPaused_ = false;
+    // Whether the transport won't deliver any more data (EOF or close).
+    this.recvEnded_ = false;
+
+    // The SO_SNDBUF & SO_RCVBUF sizes.
+    this.sendBufferSize_ = kDefaultBufferSize;
+    this.recvBufferSize_ = kDefaultBufferSize;
+    // Whether the program picked the send buffer size itself.
+    this.sendBufferSet_ = false;
+    this.tcpNoDelay_ = false;
+    this.tcpCork_ = false;
+    // The SO_WASSH_PROFILE & IP_TOS/IPV6_TCLASS settings.
+    this.profile_ = Constants.WASSH_SOCK_PROFILE_DEFAULT;
+    this.tos_ = 0;
+
+    // Writes waiting to be sent together (see queueWrite_).
+    /** @type {!Array<!Uint8Array>} */
+    this.sendQueue_ = [];
+    this.sendQueued_ = 0;
+    /** @type {?number} */
+    this.flushTimer_ = null;
+    /** @type {?Promise<void>} The send in progress. */
+    this.sending_ = null;
+    // The first error from a send, returned by the next write.
+    this.sendError_ = WASI.errno.ESUCCESS;
+    /** @const */
+    this.stats = {
+      // Writes from the program, and the sends they were coalesced into.
+      writes: 0,
+      sends: 0,
+    };
+  }
+
+  /**
+   * @return {string}
+   * @override
+   */
+  toString() {
+    const {writes, sends} = this.stats;
+    return `${super.toString().slice(0, -1)}, writes=${writes}, ` +
+        `sends=${sends})`;
+  }
+
+  /**
+   * Whether small writes should be sent immediately.
+   *
+   * @return {boolean}
+   */
+  noDelay_() {
+    return this.tcpNoDelay_ ||
+        this.profile_ === Constants.WASSH_SOCK_PROFILE_INTERACTIVE;
+  }
+
+  /**
+   * The most we hand to the transport in a single write.
+   *
+   * @return {number}
+   */
+  sendSize_() {
+    if (this.profile_ === Constants.WASSH_SOCK_PROFILE_INTERACTIVE) {
+      return Math.min(this.sendBufferSize_, kInteractiveSendSize);
+    }
+    return this.sendBufferSize_;
+  }
+
+  /**
+   * Trim a write down to what the send buffer allows.
+   *
+   * Callers report the shorter length back as a partial write, so the program
+   * regains control (e.g. to send a keystroke) between chunks.  That's only
+   * done for programs that asked for it via SO_SNDBUF or the interactive
+   * profile; everyone else gets whole writes like they always have.
+   *
+   * @param {!TypedArray} buf
+   * @return {!TypedArray}
+   */
+  clampWrite_(buf) {
+    if (!this.sendBufferSet_ &&
+        this.profile_ !== Constants.WASSH_SOCK_PROFILE_INTERACTIVE) {
+      return buf;
+    }
+    const size = this.sendSize_();
+    return buf.length > size ? buf.slice(0, size) : buf;
+  }
+
+  /**
+   * Queue a write to be sent along with any others made around the same time.
+   *
+   * OpenSSH makes a lot of small writes, so rather than send each one by
+   * itself, we flush from a zero delay timer, and everything the program
+   * writes before that task runs is sent together.  Sockets with TCP_NODELAY
+   * (or the interactive profile) send right away, and corked sockets wait
+   * until they're uncorked, a full send is queued, or kCorkDelay passes.
+   *
+   * Like the kernel, the write is done once it's queued, and errors sending it
+   * are returned by a later write.
+   *
+   * @param {!TypedArray} buf
+   * @return {!Promise<!WASI_t.errno|{nwritten: number}>}
+   */
+  async queueWrite_(buf) {
+    buf = this.clampWrite_(buf);
+    // Wait for room.
+    while (this.sendQueued_ &&
+           this.sendQueued_ + buf.length > this.sendSize_()) {
+      await this.flush_();
+    }
+    if (this.sendError_ !== WASI.errno.ESUCCESS) {
+      const ret = this.sendError_;
+      this.sendError_ = WASI.errno.ESUCCESS;
+      return ret;
+    }
+
+    // The program may reuse its buffer once we return.
+    this.sendQueue_.push(new Uint8Array(buf));
+    this.sendQueued_ += buf.length;
+    ++this.stats.writes;
+
+    if (this.tcpCork_) {
+      if (this.sendQueued_ >= this.sendSize_()) {
+        // Like a full kernel buffer, the writer waits for this send.
+        await this.flush_();
+      } else {
+        this.scheduleFlush_(kCorkDelay);
+      }
+    } else if (this.noDelay_()) {
+      await this.flush_();
+    } else {
+      this.scheduleFlush_(0);
+    }
+    return {nwritten: buf.length};
+  }
+
+  /**
+   * Flush the send queue later unless something else does first.
+   *
+   * A zero delay still waits for a later task (and browsers clamp nested
+   * timers to a few milliseconds), which gives the program's next writes a
+   * chance to join the queue.
+   *
+   * @param {number} delay In milliseconds.
+   */
+  scheduleFlush_(delay) {
+    if (this.flushTimer_ === null) {
+      this.flushTimer_ = setTimeout(() => {
+        this.flushTimer_ = null;
+        // Nothing waits on this: send errors are saved for the next write.
+        this.flush_();
+      }, delay);
+    }
+  }
+
+  /**
+   * Send everything that's been queued.
+   *
+   * @return {!Promise<void>}
+   */
+  async flush_() {
+    if (this.flushTimer_ !== null) {
+      clearTimeout(this.flushTimer_);
+      this.flushTimer_ = null;
+    }
+    // Keep the data in order.
+    while (this.sending_) {
+      await this.sending_;
+    }
+    if (this.sendQueued_ === 0) {
+      return;
+    }
+
+    let buf;
+    if (this.sendQueue_.length === 1) {
+      buf = this.sendQueue_[0];
+    } else {
+      buf = new Uint8Array(this.sendQueued_);
+      let offset = 0;
+      this.sendQueue_.forEach((chunk) => {
+        buf.set(chunk, offset);
+        offset += chunk.length;
+      });
+    }
+    this.sendQueue_ = [];
+    this.sendQueued_ = 0;
+    ++this.stats.sends;
+
+    this.sending_ = this.send_(buf).then((ret) => {
+      if (this.sendError_ === WASI.errno.ESUCCESS) {
+        this.sendError_ = ret;
+      }
+    });
+    await this.sending_;
+    this.sending_ = null;
+
+    // Let pollers know there's room again (or an error to report).
+    if (this.receiveListener_) {
+      this.receiveListener_();
+    }
+  }
+
+  /**
+   * Send data to the transport for queueWrite_.
+   *
+   * @param {!Uint8Array} buf The data.  It owns its whole buffer.
+   * @return {!Promise<!WASI_t.errno>}
+   */
+  async send_(buf) {
+    throw new Error('send_(): unimplemented');
+  }
+
+  /**
+   * Handle IP_TOS & IPV6_TCLASS.
+   *
+   * We can't mark the packets themselves, but we can pick a matching profile.
+   *
+   * @param {number} value
+   * @return {!Promise<!WASI_t.errno>}
+   */
+  async setTos_(value) {
+    this.tos_ = value & 0xff;
+    this.profile_ = TOS_TO_PROFILE.get(this.tos_) ??
+        Constants.WASSH_SOCK_PROFILE_DEFAULT;
+    return this.applyOptions_();
+  }
+
+  /**
+   * Push TCP_NODELAY & the buffer sizes down to the transport.
+   *
+   * @return {!Promise<!WASI_t.errno>}
+   */
+  async applyOptions_() {
+    return WASI.errno.ESUCCESS;
   }
 
   /**
@@ -308,11 +739,10 @@ export class StreamSocket extends Socket {
    * @override
    */
   onRecv(data) {
-    const u8 = new Uint8Array(data);
-    const newData = new Uint8Array(this.data.length + u8.length);
-    newData.set(this.data);
-    newData.set(u8, this.data.length);
-    this.data = newData;
+    this.data.push(new Uint8Array(data));
+    if (this.data.length >= this.recvBufferSize_ * kRecvHighWater) {
+      this.setRecvPaused_(true);
+    }
 
     // If there are any readers waiting, wake them up.
     if (this.reader_) {
@@ -325,26 +755,276 @@ export class StreamSocket extends Socket {
     }
   }
 
+  /**
+   * Note that the transport won't deliver any more data.
+   *
+   * Readers waiting on data get whatever is left (i.e. a short read or EOF).
+   *
+   * @param {!WASI_t.errno=} error Why the connection ended, or ESUCCESS if
+   *     the peer closed it cleanly.
+   */
+  onRecvEnd(error = WASI.errno.ESUCCESS) {
+    this.recvEnded_ = true;
+    if (this.error === WASI.errno.ESUCCESS) {
+      this.error = error;
+    }
+
+    if (this.reader_) {
+      this.reader_();
+      this.reader_ = null;
+    }
+
+    if (this.receiveListener_) {
+      this.receiveListener_();
+    }
+  }
+
   /**
    * @param {number} length
    * @param {boolean=} block
+   * @param {{
+   *   peek: (boolean|undefined),
+   *   waitAll: (boolean|undefined),
+   *   dest: (!Uint8Array|undefined),
+   * }=} options MSG_PEEK & MSG_WAITALL settings, and optional program memory
+   *     to read into directly.
    * @return {!Promise<!WASI_t.errno|
    *                   {buf: !Uint8Array, nread: number}|
    *                   {buf: !Uint8Array}|
    *                   {nread: number}>}
    * @override
    */
-  async read(length, block = true) {
-    if (this.data.length === 0) {
-      if (!block || !this.blocking_) {
+  async read(length, block = true, options = {}) {
+    block = block && this.blocking_;
+    // Once the connection is gone, reads return what's left, then EOF.
+    if (this.data.length === 0 && !this.recvEnded_) {
+      if (!block) {
         return WASI.errno.EAGAIN;
       }
       await new Promise((resolve) => this.reader_ = resolve);
     }
 
-    const buf = this.data.slice(0, length);
-    this.data = this.data.subarray(length);
-    return {buf};
+    // Keep waiting until the full request is available, unless the connection
+    // ends or runs into an error.  Nonblocking reads ignore this like Linux.
+    if (options.waitAll && block) {
+      while (this.data.length < length && !this.recvEnded_ &&
+             this.error === WASI.errno.ESUCCESS) {
+        // Don't wait on ourselves if the request is bigger than the queue.
+        this.setRecvPaused_(false);
+        await new Promise((resolve) => this.reader_ = resolve);
+      }
+    }
+
+    let ret;
+    if (options.dest) {
+      ret = {nread: this.data.copyTo(options.dest, length)};
+    } else {
+      ret = {buf: this.data.peek(length)};
+    }
+    if (!options.peek) {
+      this.data.consume(length);
+      if (this.data.length <= this.recvBufferSize_ * kRecvLowWater) {
+        this.setRecvPaused_(false);
+      }
+    }
+    return ret;
+  }
+
+  /**
+   * Stop or start reading data from the transport when it changes.
+   *
+   * @param {boolean} paused
+   */
+  setRecvPaused_(paused) {
+    if (this.recvPaused_ !== paused) {
+      this.recvPaused_ = paused;
+      this.pauseRecv_(paused);
+    }
+  }
+
+  /**
+   * Stop or start reading data from the transport.
+   *
+   * Received data still gets queued while paused, but transports that can stop
+   * reading should, so the peer has to wait for the program to catch up.
+   *
+   * @param {boolean} paused
+   */
+  pauseRecv_(paused) {}
+
+  /**
+   * @return {number}
+   * @override
+   */
+  pendingBytes() {
+    return this.data.length;
+  }
+
+  /**
+   * @return {boolean}
+   * @override
+   */
+  recvEnded() {
+    return this.recvEnded_;
+  }
+
+  /**
+   * @return {boolean}
+   * @override
+   */
+  writeReady() {
+    return this.sendQueued_ < this.sendSize_();
+  }
+
+  /**
+   * @return {boolean}
+   * @override
+   */
+  hasError() {
+    return super.hasError() || this.sendError_ !== WASI.errno.ESUCCESS;
+  }
+
+  /**
+   * @return {!Promise<!WASI_t.errno>}
+   * @override
+   */
+  async drain() {
+    await this.flush_();
+    const ret = this.sendError_;
+    this.sendError_ = WASI.errno.ESUCCESS;
+    return ret;
+  }
+
+  /**
+   * @param {number} level
+   * @param {number} name
+   * @return {!Promise<!WASI_t.errno|{option: number}>}
+   * @override
+   */
+  async getSocketOption(level, name) {
+    const superRet = await super.getSocketOption(level, name);
+    if (typeof superRet !== 'number' || superRet !== WASI.errno.ENOPROTOOPT) {
+      return superRet;
+    }
+
+    switch (level) {
+      case SOL_SOCKET: {
+        switch (name) {
+          case SO_SNDBUF:
+            return {option: this.sendSize_()};
+          case SO_RCVBUF:
+            return {option: this.recvBufferSize_};
+          case SO_WASSH_PROFILE:
+            return {option: this.profile_};
+        }
+        break;
+      }
+
+      case IPPROTO_IP: {
+        switch (name) {
+          case IP_TOS:
+            return {option: this.tos_};
+        }
+        break;
+      }
+
+      case IPPROTO_IPV6: {
+        switch (name) {
+          case IPV6_TCLASS:
+            return {option: this.tos_};
+        }
+        break;
+      }
+
+      case IPPROTO_TCP: {
+        switch (name) {
+          case TCP_NODELAY:
+            return {option: this.noDelay_() ? 1 : 0};
+          case TCP_CORK:
+            return {option: this.tcpCork_ ? 1 : 0};
+        }
+        break;
+      }
+    }
+
+    return WASI.errno.ENOPROTOOPT;
+  }
+
+  /**
+   * @param {number} level
+   * @param {number} name
+   * @param {number} value
+   * @return {!Promise<!WASI_t.errno>}
+   * @override
+   */
+  async setSocketOption(level, name, value) {
+    switch (level) {
+      case SOL_SOCKET: {
+        switch (name) {
+          case SO_SNDBUF:
+            this.sendBufferSize_ = clampBufferSize(value);
+            this.sendBufferSet_ = true;
+            return this.applyOptions_();
+
+          case SO_RCVBUF:
+            this.recvBufferSize_ = clampBufferSize(value);
+            return this.applyOptions_();
+
+          case SO_WASSH_PROFILE: {
+            switch (value) {
+              case Constants.WASSH_SOCK_PROFILE_DEFAULT:
+              case Constants.WASSH_SOCK_PROFILE_INTERACTIVE:
+              case Constants.WASSH_SOCK_PROFILE_BULK:
+                this.profile_ = value;
+                return this.applyOptions_();
+            }
+            return WASI.errno.EINVAL;
+          }
+        }
+        break;
+      }
+
+      case IPPROTO_IP: {
+        switch (name) {
+          case IP_TOS:
+            return this.setTos_(value);
+        }
+        break;
+      }
+
+      case IPPROTO_IPV6: {
+        switch (name) {
+          case IPV6_TCLASS:
+            return this.setTos_(value);
+        }
+        break;
+      }
+
+      case IPPROTO_TCP: {
+        switch (name) {
+          case TCP_NODELAY: {
+            const old = this.tcpNoDelay_;
+            this.tcpNoDelay_ = !!value;
+            const ret = await this.applyOptions_();
+            if (ret !== WASI.errno.ESUCCESS) {
+              this.tcpNoDelay_ = old;
+            }
+            return ret;
+          }
+
+          case TCP_CORK: {
+            this.tcpCork_ = !!value;
+            if (!this.tcpCork_) {
+              await this.flush_();
+            }
+            return WASI.errno.ESUCCESS;
+          }
+        }
+        break;
+      }
+    }
+
+    return WASI.errno.ENOPROTOOPT;
   }
 }
 
@@ -361,15 +1041,70 @@ export class DatagramSocket extends Socket {
   constructor(domain, type, protocol) {
     super(domain, type, protocol);
 
+    /** @type {!Array<!Uint8Array>} Packets waiting for the program. */
     this.data = [];
+    // How many bytes are in the queued packets.
+    this.dataBytes_ = 0;
+    // The SO_RCVBUF limit on dataBytes_, and the SO_WASSH_DROP_POLICY.
+    this.recvBufferSize_ = kDefaultBufferSize;
+    this.dropPolicy_ = Constants.WASSH_SOCK_DROP_OLDEST;
+    /** @const */
+    this.stats = {
+      // Packets queued, including ones dropped later to make room.
+      enqueued: 0,
+      dropped: 0,
+      // The most packets that have been waiting at once.
+      maxDepth: 0,
+    };
+  }
+
+  /**
+   * @return {string}
+   * @override
+   */
+  toString() {
+    const {enqueued, dropped, maxDepth} = this.stats;
+    return `${super.toString().slice(0, -1)}, enqueued=${enqueued}, ` +
+        `dropped=${dropped}, maxDepth=${maxDepth})`;
   }
 
   /**
+   * Drop a packet that didn't fit in the queue.
+   */
+  drop_() {
+    if (this.stats.dropped++ === 0) {
+      this.debug(`${this}: receive queue full; dropping packets`);
+    }
+  }
+
+  /**
+   * Queue a packet, dropping packets if it doesn't fit.
+   *
+   * A packet is always queued if nothing else is, even if it's too big.
+   *
    * @param {!ArrayBuffer} data
    * @override
    */
   onRecv(data) {
-    this.data.push(new Uint8Array(data));
+    const u8 = new Uint8Array(data);
+    if (this.dropPolicy_ === Constants.WASSH_SOCK_DROP_OLDEST) {
+      // Stale packets are worth less than new ones (e.g. mosh state).
+      while (this.data.length &&
+             this.dataBytes_ + u8.length > this.recvBufferSize_) {
+        this.dataBytes_ -= this.data.shift().length;
+        this.drop_();
+      }
+    } else if (this.data.length &&
+               this.dataBytes_ + u8.length > this.recvBufferSize_) {
+      // Like Linux, drop what doesn't fit.
+      this.drop_();
+      return;
+    }
+
+    this.data.push(u8);
+    this.dataBytes_ += u8.length;
+    ++this.stats.enqueued;
+    this.stats.maxDepth = Math.max(this.stats.maxDepth, this.data.length);
 
     // If there are any readers waiting, wake them up.
     if (this.reader_) {
@@ -377,34 +1112,117 @@ export class DatagramSocket extends Socket {
       this.reader_ = null;
     }
 
-    if (this.receiveListener_) {
-      this.receiveListener_();
+    if (this.receiveListener_) {
+      this.receiveListener_();
+    }
+  }
+
+  /**
+   * @param {number} length
+   * @param {boolean=} block
+   * @param {{
+   *   peek: (boolean|undefined),
+   *   waitAll: (boolean|undefined),
+   *   dest: (!Uint8Array|undefined),
+   * }=} options MSG_PEEK & MSG_WAITALL settings, and optional program memory
+   *     to read into directly.
+   * @return {!Promise<!WASI_t.errno|
+   *                   {buf: !Uint8Array, nread: number}|
+   *                   {buf: !Uint8Array}|
+   *                   {nread: number}>}
+   * @override
+   */
+  async read(length, block = true, options = {}) {
+    if (this.data.length === 0) {
+      if (!block || !this.blocking_) {
+        return WASI.errno.EAGAIN;
+      }
+      await new Promise((resolve) => this.reader_ = resolve);
+    }
+
+    // Packets have to be read completely, one at a time.
+    if (this.data[0].byteLength > length) {
+      return WASI.errno.ENOMEM;
+    }
+
+    // MSG_WAITALL has no meaning for packets.
+    if (options.peek) {
+      return {buf: this.data[0]};
+    }
+    const buf = this.data.shift();
+    this.dataBytes_ -= buf.length;
+    return {buf};
+  }
+
+  /**
+   * Like Linux, only report the size of the next packet.
+   *
+   * @return {number}
+   * @override
+   */
+  pendingBytes() {
+    return this.data.length ? this.data[0].byteLength : 0;
+  }
+
+  /**
+   * @param {number} level
+   * @param {number} name
+   * @return {!Promise<!WASI_t.errno|{option: number}>}
+   * @override
+   */
+  async getSocketOption(level, name) {
+    const superRet = await super.getSocketOption(level, name);
+    if (typeof superRet !== 'number' || superRet !== WASI.errno.ENOPROTOOPT) {
+      return superRet;
+    }
+
+    switch (level) {
+      case SOL_SOCKET: {
+        switch (name) {
+          case SO_RCVBUF:
+            return {option: this.recvBufferSize_};
+          case SO_WASSH_DROP_POLICY:
+            return {option: this.dropPolicy_};
+        }
+        break;
+      }
     }
+
+    return WASI.errno.ENOPROTOOPT;
   }
 
   /**
-   * @param {number} length
-   * @param {boolean=} block
-   * @return {!Promise<!WASI_t.errno|
-   *                   {buf: !Uint8Array, nread: number}|
-   *                   {buf: !Uint8Array}|
-   *                   {nread: number}>}
+   * @param {number} level
+   * @param {number} name
+   * @param {number} value
+   * @return {!Promise<!WASI_t.errno>}
    * @override
    */
-  async read(length, block = true) {
-    if (this.data.length === 0) {
-      if (!block || !this.blocking_) {
-        return WASI.errno.EAGAIN;
-      }
-      await new Promise((resolve) => this.reader_ = resolve);
-    }
+  async setSocketOption(level, name, value) {
+    switch (level) {
+      case SOL_SOCKET: {
+        switch (name) {
+          case SO_RCVBUF:
+            // This only limits our own queue, so it takes effect right away
+            // for new packets.
+            this.recvBufferSize_ = clampBufferSize(value);
+            return WASI.errno.ESUCCESS;
 
-    // Packets have to be read completely, one at a time.
-    if (this.data[0].byteLength > length) {
-      return WASI.errno.ENOMEM;
+          case SO_WASSH_DROP_POLICY: {
+            switch (value) {
+              case Constants.WASSH_SOCK_DROP_OLDEST:
+              case Constants.WASSH_SOCK_DROP_NEWEST:
+                this.dropPolicy_ = value;
+                return WASI.errno.ESUCCESS;
+            }
+            return WASI.errno.EINVAL;
+          }
+        }
+        break;
+      }
     }
 
-    return {buf: this.data.shift()};
+    return WASI.errno.ENOPROTOOPT;
   }
 
   /**
@@ -518,7 +1336,6 @@ export class ChromeTcpSocket extends StreamSocket {
     this.socketId_ = -1;
 
     this.tcpKeepAlive_ = false;
-    this.tcpNoDelay_ = false;
   }
 
   /**
@@ -530,7 +1347,7 @@ export class ChromeTcpSocket extends StreamSocket {
       const info = await new Promise(async (resolve) => {
         chrome.sockets.tcp.create({
           name: await getChromeSocketsName(),
-          bufferSize: 64 * 1024,
+          bufferSize: this.recvBufferSize_,
         }, resolve);
       });
 
@@ -596,6 +1413,7 @@ export class ChromeTcpSocket extends StreamSocket {
     // If a socket was created but not connected, we can't disconnect it, but we
     // need to stiil close it.
     if (this.address) {
+      await this.flush_();
       // We wait for the disconnect only so that we can reset the internal
       // state below, but we could probably wait for the close too if needed.
       await new Promise((resolve) => {
@@ -605,6 +1423,7 @@ export class ChromeTcpSocket extends StreamSocket {
 
     chrome.sockets.tcp.close(this.socketId_);
     ChromeTcpSocket.eventRouter_.unregister(this.socketId_);
+    this.onRecvEnd();
 
     this.socketId_ = -1;
     this.address = null;
@@ -617,19 +1436,37 @@ export class ChromeTcpSocket extends StreamSocket {
    * @override
    */
   async write(buf) {
-    const {resultCode, bytesSent} = await new Promise((resolve) => {
-      // TODO(vapier): Double check whether send accepts TypedArrays directly.
-      // Or if we have to respect buf.byteOffset & buf.byteLength ourself.
-      chrome.sockets.tcp.send(this.socketId_, buf.buffer, resolve);
-    });
-
-    const ret = netErrorToErrno(resultCode);
-    if (ret !== WASI.errno.ESUCCESS) {
-      clearLastError();
-      return ret;
+    // A closed (or shut down) socket is broken, while one that was never
+    // connected has nowhere to send to.
+    if (this.socketId_ === -1) {
+      return WASI.errno.EPIPE;
+    }
+    if (this.address === null) {
+      return WASI.errno.ENOTCONN;
     }
 
-    return {nwritten: bytesSent};
+    return this.queueWrite_(buf);
+  }
+
+  /**
+   * @param {!Uint8Array} buf
+   * @return {!Promise<!WASI_t.errno>}
+   * @override
+   */
+  async send_(buf) {
+    while (buf.length) {
+      const {resultCode, bytesSent} = await new Promise((resolve) => {
+        chrome.sockets.tcp.send(this.socketId_, buf.buffer, resolve);
+      });
+
+      const ret = netErrorToErrno(resultCode);
+      if (ret !== WASI.errno.ESUCCESS) {
+        clearLastError();
+        return ret;
+      }
+      buf = buf.slice(bytesSent);
+    }
+    return WASI.errno.ESUCCESS;
   }
 
   /**
@@ -679,14 +1516,6 @@ export class ChromeTcpSocket extends StreamSocket {
         }
         break;
       }
-
-      case IPPROTO_TCP: {
-        switch (name) {
-          case TCP_NODELAY:
-            return {option: this.tcpNoDelay_ ? 1 : 0};
-        }
-        break;
-      }
     }
 
     return WASI.errno.ENOPROTOOPT;
@@ -700,6 +1529,11 @@ export class ChromeTcpSocket extends StreamSocket {
    * @override
    */
   async setSocketOption(level, name, value) {
+    const superRet = await super.setSocketOption(level, name, value);
+    if (superRet !== WASI.errno.ENOPROTOOPT) {
+      return superRet;
+    }
+
     switch (level) {
       case SOL_SOCKET: {
         switch (name) {
@@ -724,48 +1558,52 @@ export class ChromeTcpSocket extends StreamSocket {
         }
         break;
       }
+    }
 
-      case IPPROTO_IP: {
-        switch (name) {
-          case IP_TOS: {
-            // TODO(vapier): Try and extend Chrome sockets API to support this.
-            console.warn(`Ignoring IP_TOS=${value}`);
-            return WASI.errno.ESUCCESS;
-          }
-        }
-        break;
-      }
+    return WASI.errno.ENOPROTOOPT;
+  }
 
-      case IPPROTO_IPV6: {
-        switch (name) {
-          case IPV6_TCLASS: {
-            // TODO(vapier): Try and extend Chrome sockets API to support this.
-            console.warn(`Ignoring IPV6_TCLASS=${value}`);
-            return WASI.errno.ESUCCESS;
-          }
-        }
-        break;
-      }
+  /**
+   * @return {!Promise<!WASI_t.errno>}
+   * @override
+   */
+  async applyOptions_() {
+    if (this.socketId_ === -1) {
+      return WASI.errno.ESUCCESS;
+    }
 
-      case IPPROTO_TCP: {
-        switch (name) {
-          case TCP_NODELAY: {
-            const result = await new Promise((resolve) => {
-              chrome.sockets.tcp.setNoDelay(this.socketId_, !!value, resolve);
-            });
-            if (result < 0) {
-              console.warn(`setNoDelay(${value}) failed with ${result})`);
-              return WASI.errno.EINVAL;
-            }
-            this.tcpNoDelay_ = value;
-            return WASI.errno.ESUCCESS;
-          }
-        }
-        break;
-      }
+    const noDelay = this.noDelay_();
+    const result = await new Promise((resolve) => {
+      chrome.sockets.tcp.setNoDelay(this.socketId_, noDelay, resolve);
+    });
+    if (result < 0) {
+      console.warn(`setNoDelay(${noDelay}) failed with ${result})`);
+      clearLastError();
+      return WASI.errno.EINVAL;
     }
 
-    return WASI.errno.ENOPROTOOPT;
+    // Chrome only exposes the receive buffer size.
+    const error = await new Promise((resolve) => {
+      chrome.sockets.tcp.update(
+          this.socketId_, {bufferSize: this.recvBufferSize_},
+          () => resolve(chrome.runtime.lastError));
+    });
+    if (error) {
+      console.warn(`update(bufferSize=${this.recvBufferSize_}) failed with ` +
+                   `${error.message}`);
+      return WASI.errno.EINVAL;
+    }
+    return WASI.errno.ESUCCESS;
+  }
+
+  /**
+   * @param {boolean} paused
+   * @override
+   */
+  pauseRecv_(paused) {
+    if (this.socketId_ !== -1) {
+      chrome.sockets.tcp.setPaused(this.socketId_, paused, clearLastError);
+    }
   }
 
   /**
@@ -1094,6 +1932,11 @@ export class ChromeUdpSocket extends DatagramSocket {
    * @override
    */
   async setSocketOption(level, name, value) {
+    const superRet = await super.setSocketOption(level, name, value);
+    if (superRet !== WASI.errno.ENOPROTOOPT) {
+      return superRet;
+    }
+
     switch (level) {
       case IPPROTO_IP: {
         switch (name) {
@@ -1145,7 +1988,6 @@ export class RelaySocket extends StreamSocket {
     this.callback_ = null;
 
     this.tcpKeepAlive_ = false;
-    this.tcpNoDelay_ = false;
   }
 
   /**
@@ -1177,6 +2019,14 @@ export class RelaySocket extends StreamSocket {
     return WASI.errno.ESUCCESS;
   }
 
+  /**
+   * @param {boolean} paused
+   * @override
+   */
+  pauseRecv_(paused) {
+    this.callback_?.setPaused(paused);
+  }
+
   /** @override */
   async close() {
     // In the *NIX world, close must never fail.  That's why we don't return
@@ -1189,6 +2039,7 @@ export class RelaySocket extends StreamSocket {
 
     this.address = null;
     this.port = null;
+    this.onRecvEnd();
   }
 
   /**
@@ -1200,6 +2051,7 @@ export class RelaySocket extends StreamSocket {
     if (!this.callback_) {
       return WASI.errno.ECONNRESET;
     }
+    buf = this.clampWrite_(buf);
     await this.callback_.write(buf);
     return {nwritten: buf.length};
   }
@@ -1242,14 +2094,6 @@ export class RelaySocket extends StreamSocket {
         }
         break;
       }
-
-      case IPPROTO_TCP: {
-        switch (name) {
-          case TCP_NODELAY:
-            return {option: this.tcpNoDelay_ ? 1 : 0};
-        }
-        break;
-      }
     }
 
     return WASI.errno.ENOPROTOOPT;
@@ -1263,6 +2107,11 @@ export class RelaySocket extends StreamSocket {
    * @override
    */
   async setSocketOption(level, name, value) {
+    const superRet = await super.setSocketOption(level, name, value);
+    if (superRet !== WASI.errno.ENOPROTOOPT) {
+      return superRet;
+    }
+
     switch (level) {
       case SOL_SOCKET: {
         switch (name) {
@@ -1278,36 +2127,6 @@ export class RelaySocket extends StreamSocket {
         }
         break;
       }
-
-      case IPPROTO_IP: {
-        switch (name) {
-          case IP_TOS: {
-            console.warn(`Ignoring IP_TOS=${value}`);
-            return WASI.errno.ESUCCESS;
-          }
-        }
-        break;
-      }
-
-      case IPPROTO_IPV6: {
-        switch (name) {
-          case IPV6_TCLASS: {
-            console.warn(`Ignoring IPV6_TCLASS=${value}`);
-            return WASI.errno.ESUCCESS;
-          }
-        }
-        break;
-      }
-
-      case IPPROTO_TCP: {
-        switch (name) {
-          case TCP_NODELAY: {
-            this.tcpNoDelay_ = value;
-            return WASI.errno.ESUCCESS;
-          }
-        }
-        break;
-      }
     }
 
     return WASI.errno.ENOPROTOOPT;
@@ -1332,9 +2151,11 @@ export class WebTcpSocket extends StreamSocket {
     this.socket_ = null;
     this.directSocketsReader_ = null;
     this.directSocketsWriter_ = null;
+    // Callback to restart pollData_ after the program catches up.
+    /** @type {?function()} */
+    this.resumeRecv_ = null;
 
     this.tcpKeepAlive_ = false;
-    this.tcpNoDelay_ = false;
     this.ipv6Only_ = false;
   }
 
@@ -1373,8 +2194,10 @@ export class WebTcpSocket extends StreamSocket {
     }
 
     const options = {
-      noDelay: this.tcpNoDelay_,
+      noDelay: this.noDelay_(),
       ipv6Only: this.ipv6Only_,
+      sendBufferSize: this.sendBufferSize_,
+      receiveBufferSize: this.recvBufferSize_,
     };
     // Keep alive is disabled by default, so don't specify it if it's disabled.
     if (this.tcpKeepAlive_) {
@@ -1420,22 +2243,42 @@ export class WebTcpSocket extends StreamSocket {
     };
 
     while (true) {
+      // Leave unread data with the socket so the peer backs off.
+      if (this.recvPaused_) {
+        await new Promise((resolve) => this.resumeRecv_ = resolve);
+        if (this.socket_ === null) {
+          break;
+        }
+      }
+
       const {value, done} = await read();
       if (done) {
         await this.close();
-        this.receiveListener_();
         break;
       }
       this.onRecv(value);
     }
   }
 
+  /**
+   * @param {boolean} paused
+   * @override
+   */
+  pauseRecv_(paused) {
+    if (!paused && this.resumeRecv_) {
+      this.resumeRecv_();
+      this.resumeRecv_ = null;
+    }
+  }
+
   /** @override */
   async close() {
     if (this.socket_ === null) {
       return;
     }
 
+    await this.flush_();
+
     if (this.directSocketsReader_) {
       try {
         await this.directSocketsReader_.cancel('closing');
@@ -1465,22 +2308,35 @@ export class WebTcpSocket extends StreamSocket {
     this.socket_ = null;
     this.address = null;
     this.port = null;
+    this.onRecvEnd();
+
+    // Let pollData_ see the socket is gone.
+    if (this.resumeRecv_) {
+      this.resumeRecv_();
+      this.resumeRecv_ = null;
+    }
   }
 
   /**
    * @param {number} length
    * @param {boolean=} block
+   * @param {{
+   *   peek: (boolean|undefined),
+   *   waitAll: (boolean|undefined),
+   *   dest: (!Uint8Array|undefined),
+   * }=} options MSG_PEEK & MSG_WAITALL settings, and optional program memory
+   *     to read into directly.
    * @return {!Promise<!WASI_t.errno|
    *                   {buf: !Uint8Array, nread: number}|
    *                   {buf: !Uint8Array}|
    *                   {nread: number}>}
    * @override
    */
-  async read(length, block = true) {
+  async read(length, block = true, options = {}) {
     if (this.socket_ === null) {
       return WASI.errno.ENOTCONN;
     }
-    return super.read(length, block);
+    return super.read(length, block, options);
   }
 
   /**
@@ -1493,10 +2349,19 @@ export class WebTcpSocket extends StreamSocket {
       return WASI.errno.EPIPE;
     }
 
+    return this.queueWrite_(buf);
+  }
+
+  /**
+   * @param {!Uint8Array} buf
+   * @return {!Promise<!WASI_t.errno>}
+   * @override
+   */
+  async send_(buf) {
     try {
       await this.directSocketsWriter_.ready;
-      await this.directSocketsWriter_.write(buf.buffer);
-      return {nwritten: buf.buffer.byteLength};
+      await this.directSocketsWriter_.write(buf);
+      return WASI.errno.ESUCCESS;
     } catch (e) {
       console.warn('Chunk error:', e);
       return WASI.errno.EIO;
@@ -1548,14 +2413,6 @@ export class WebTcpSocket extends StreamSocket {
         break;
       }
 
-      case IPPROTO_TCP: {
-        switch (name) {
-          case TCP_NODELAY:
-            return {option: this.tcpNoDelay_ ? 1 : 0};
-        }
-        break;
-      }
-
       case IPPROTO_IPV6: {
         switch (name) {
           case IPV6_V6ONLY: {
@@ -1577,6 +2434,11 @@ export class WebTcpSocket extends StreamSocket {
    * @override
    */
   async setSocketOption(level, name, value) {
+    const superRet = await super.setSocketOption(level, name, value);
+    if (superRet !== WASI.errno.ENOPROTOOPT) {
+      return superRet;
+    }
+
     switch (level) {
       case SOL_SOCKET: {
         switch (name) {
@@ -1593,23 +2455,8 @@ export class WebTcpSocket extends StreamSocket {
         break;
       }
 
-      case IPPROTO_IP: {
-        switch (name) {
-          case IP_TOS: {
-            console.warn(`Ignoring IP_TOS=${value}`);
-            return WASI.errno.ESUCCESS;
-          }
-        }
-        break;
-      }
-
       case IPPROTO_IPV6: {
         switch (name) {
-          case IPV6_TCLASS: {
-            console.warn(`Ignoring IPV6_TCLASS=${value}`);
-            return WASI.errno.ESUCCESS;
-          }
-
           case IPV6_V6ONLY: {
             this.ipv6Only_ = value;
             return WASI.errno.ESUCCESS;
@@ -1617,21 +2464,24 @@ export class WebTcpSocket extends StreamSocket {
         }
         break;
       }
-
-      case IPPROTO_TCP: {
-        switch (name) {
-          case TCP_NODELAY: {
-            this.tcpNoDelay_ = value;
-            return WASI.errno.ESUCCESS;
-          }
-        }
-        break;
-      }
     }
 
     return WASI.errno.ENOPROTOOPT;
   }
 
+  /**
+   * @return {!Promise<!WASI_t.errno>}
+   * @override
+   */
+  async applyOptions_() {
+    // Direct Sockets only takes these when opening the connection, so later
+    // changes only affect our own write sizes.
+    if (this.socket_ !== null) {
+      this.debug('transport options are fixed after connect');
+    }
+    return WASI.errno.ESUCCESS;
+  }
+
   /**
    * @return {boolean}
    * @override
@@ -2100,6 +2950,11 @@ export class WebUdpSocket extends DatagramSocket {
    * @override
    */
   async setSocketOption(level, name, value) {
+    const superRet = await super.setSocketOption(level, name, value);
+    if (superRet !== WASI.errno.ENOPROTOOPT) {
+      return superRet;
+    }
+
     switch (level) {
       case IPPROTO_IP: {
         switch (name) {
@@ -2194,22 +3049,29 @@ export class UnixSocket extends StreamSocket {
     this.address = null;
     this.port = null;
     this.callback_ = null;
+    this.onRecvEnd();
   }
 
   /**
    * @param {number} length
    * @param {boolean=} block
+   * @param {{
+   *   peek: (boolean|undefined),
+   *   waitAll: (boolean|undefined),
+   *   dest: (!Uint8Array|undefined),
+   * }=} options MSG_PEEK & MSG_WAITALL settings, and optional program memory
+   *     to read into directly.
    * @return {!Promise<!WASI_t.errno|
    *                   {buf: !Uint8Array, nread: number}|
    *                   {buf: !Uint8Array}|
    *                   {nread: number}>}
    * @override
    */
-  async read(length, block = true) {
+  async read(length, block = true, options = {}) {
     if (this.address === null) {
       return WASI.errno.EINVAL;
     }
-    return super.read(length, block);
+    return super.read(length, block, options);
   }
 
   /**
@@ -2221,6 +3083,7 @@ export class UnixSocket extends StreamSocket {
     if (this.address === null) {
       return WASI.errno.ENOTCONN;
     }
+    buf = this.clampWrite_(buf);
     await this.callback_.write(buf);
     return {nwritten: buf.length};
   }
@@ -2265,6 +3128,8 @@ class ChromeTcpSocketEventRouter extends ChromeSocketsEventRouter {
     super();
 
     chrome.sockets.tcp.onReceive.addListener(this.onSocketRecv_.bind(this));
+    chrome.sockets.tcp.onReceiveError.addListener(
+        this.onSocketRecvError_.bind(this));
   }
 
   /**
@@ -2286,6 +3151,25 @@ class ChromeTcpSocketEventRouter extends ChromeSocketsEventRouter {
 
     handle.onRecv(data);
   }
+
+  /**
+   * The onReceiveError listener for the chrome.sockets API which tells the
+   * associated socket its connection is done.
+   *
+   * @param {{socketId: number, resultCode: number}} options
+   */
+  onSocketRecvError_({socketId, resultCode}) {
+    const handle = this.socketMap_.get(socketId);
+    if (handle === undefined) {
+      // See onSocketRecv_ for why this is ignored.
+      return;
+    }
+
+    clearLastError();
+    // The peer closing the connection is a normal EOF.
+    handle.onRecvEnd(resultCode === NetErrorList.CONNECTION_CLOSED ?
+                     WASI.errno.ESUCCESS : netErrorToErrno(resultCode));
+  }
 }
 
 /**
@@ -2,12 +2,44 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+import {WASI} from '../../wasi-js-bindings/index.js';
+import * as Constants from './constants.js';
 import * as Sockets from './sockets.js';
 
 /**
  * @fileoverview Test suite for sockets code.
  */
 
+// Socket options from sockets.js.
+const SOL_SOCKET = 0x7fffffff;
+const SO_SNDBUF = 7;
+const SO_RCVBUF = 8;
+const SO_WASSH_PROFILE = 0x5700;
+const SO_WASSH_DROP_POLICY = 0x5701;
+const IPPROTO_IP = 0;
+const IP_TOS = 1;
+const IPPROTO_TCP = 6;
+const TCP_NODELAY = 1;
+const TCP_CORK = 3;
+
+/**
+ * Create an IPv4 socket for testing.
+ *
+ * @param {number=} type Constants.SOCK_STREAM or Constants.SOCK_DGRAM.
+ * @param {!Object<number, number>=} options SOL_SOCKET options to set.
+ * @return {!Promise<!Sockets.StreamSocket|!Sockets.DatagramSocket>}
+ */
+async function newSocket(type = Constants.SOCK_STREAM, options = {}) {
+  const sock = type === Constants.SOCK_STREAM ?
+      new Sockets.StreamSocket(Constants.AF_INET, type, 0) :
+      new Sockets.DatagramSocket(Constants.AF_INET, type, 0);
+  for (const [name, value] of Object.entries(options)) {
+    assert.equal(await sock.setSocketOption(SOL_SOCKET, Number(name), value),
+                 WASI.errno.ESUCCESS);
+  }
+  return sock;
+}
+
 /**
  * Check IPv4 parsing.
  */
@@ -41,3 +73,397 @@ describe('strAddrToArray-ipv6', () => {
     });
   });
 });
+
+/**
+ * Check stream socket read flags.
+ */
+describe('StreamSocket-read', () => {
+  const te = new TextEncoder();
+
+  it('peek', async () => {
+    const sock = await newSocket();
+    sock.onRecv(te.encode('abcd').buffer);
+    assert.equal(sock.pendingBytes(), 4);
+
+    let ret = await sock.read(2, true, {peek: true});
+    assert.deepStrictEqual(ret.buf, te.encode('ab'));
+    assert.equal(sock.pendingBytes(), 4);
+
+    ret = await sock.read(10);
+    assert.deepStrictEqual(ret.buf, te.encode('abcd'));
+    assert.equal(sock.pendingBytes(), 0);
+  });
+
+  it('dontwait', async () => {
+    const sock = await newSocket();
+    assert.equal(await sock.read(1, false), WASI.errno.EAGAIN);
+  });
+
+  it('waitall', async () => {
+    const sock = await newSocket();
+    sock.onRecv(te.encode('ab').buffer);
+    const pending = sock.read(4, true, {waitAll: true});
+    sock.onRecv(te.encode('c').buffer);
+    sock.onRecv(te.encode('de').buffer);
+    const ret = await pending;
+    assert.deepStrictEqual(ret.buf, te.encode('abcd'));
+    assert.equal(sock.pendingBytes(), 1);
+  });
+
+  it('waitall eof', async () => {
+    const sock = await newSocket();
+    sock.onRecv(te.encode('ab').buffer);
+    const pending = sock.read(4, true, {waitAll: true});
+    // Like Linux, the peer going away returns what's left.
+    sock.onRecvEnd();
+    const ret = await pending;
+    assert.deepStrictEqual(ret.buf, te.encode('ab'));
+
+    // And then EOF rather than blocking.
+    assert.deepStrictEqual(await sock.read(4), {buf: new Uint8Array(0)});
+  });
+
+  it('recv ended', async () => {
+    const sock = await newSocket();
+    sock.onRecv(te.encode('ab').buffer);
+    assert.isFalse(sock.recvEnded());
+    // Pollers treat this as readable even once the queue drains.
+    sock.onRecvEnd();
+    assert.isTrue(sock.recvEnded());
+    await sock.read(4);
+    assert.equal(sock.pendingBytes(), 0);
+    assert.isTrue(sock.recvEnded());
+  });
+
+  it('waitall nonblocking', async () => {
+    const sock = await newSocket();
+    sock.onRecv(te.encode('ab').buffer);
+    const ret = await sock.read(4, false, {waitAll: true});
+    assert.deepStrictEqual(ret.buf, te.encode('ab'));
+  });
+
+  it('dest', async () => {
+    const sock = await newSocket();
+    sock.onRecv(te.encode('abcd').buffer);
+    const mem = new Uint8Array(new SharedArrayBuffer(8));
+    const dest = mem.subarray(2, 5);
+
+    let ret = await sock.read(dest.length, true, {dest});
+    assert.deepStrictEqual(ret, {nread: 3});
+    assert.deepStrictEqual(Array.from(mem), [0, 0, 97, 98, 99, 0, 0, 0]);
+
+    ret = await sock.read(dest.length, true, {dest});
+    assert.deepStrictEqual(ret, {nread: 1});
+    assert.equal(mem[2], 100);
+    assert.equal(sock.pendingBytes(), 0);
+  });
+});
+
+/**
+ * Check the stream receive queue.
+ */
+describe('ByteQueue', () => {
+  it('partial reads', () => {
+    const queue = new Sockets.ByteQueue();
+    queue.push(new Uint8Array([1, 2, 3]));
+    queue.push(new Uint8Array(0));
+    queue.push(new Uint8Array([4, 5]));
+    assert.equal(queue.length, 5);
+
+    // Reads within a chunk don't copy.
+    assert.deepStrictEqual(queue.peek(2), new Uint8Array([1, 2]));
+    queue.consume(2);
+    assert.deepStrictEqual(queue.peek(10), new Uint8Array([3, 4, 5]));
+
+    const dest = new Uint8Array(2);
+    assert.equal(queue.copyTo(dest), 2);
+    assert.deepStrictEqual(dest, new Uint8Array([3, 4]));
+    queue.consume(2);
+    assert.equal(queue.length, 1);
+    assert.deepStrictEqual(queue.peek(10), new Uint8Array([5]));
+
+    queue.consume(10);
+    assert.equal(queue.length, 0);
+    assert.deepStrictEqual(queue.peek(10), new Uint8Array(0));
+  });
+
+  it('many chunks', () => {
+    const queue = new Sockets.ByteQueue();
+    for (let i = 0; i < 5000; ++i) {
+      queue.push(new Uint8Array([i & 0xff]));
+    }
+    for (let i = 0; i < 4999; ++i) {
+      assert.equal(queue.peek(1)[0], i & 0xff);
+      queue.consume(1);
+    }
+    assert.isBelow(queue.chunks_.length, 5000);
+    assert.deepStrictEqual(queue.peek(2), new Uint8Array([4999 & 0xff]));
+  });
+});
+
+/**
+ * Check stream sockets stop reading when the program falls behind.
+ */
+describe('StreamSocket-backpressure', () => {
+  /**
+   * @return {!Promise<!Sockets.StreamSocket>} A socket that records pauses.
+   */
+  const newPausingSocket = async () => {
+    const sock = await newSocket(Constants.SOCK_STREAM, {[SO_RCVBUF]: 4096});
+    sock.pauses = [];
+    sock.pauseRecv_ = (paused) => sock.pauses.push(paused);
+    return sock;
+  };
+
+  it('water marks', async () => {
+    const sock = await newPausingSocket();
+    for (let i = 0; i < 3; ++i) {
+      sock.onRecv(new ArrayBuffer(4096));
+    }
+    assert.deepStrictEqual(sock.pauses, [true]);
+
+    // Still above the low water mark.
+    await sock.read(8192);
+    assert.deepStrictEqual(sock.pauses, [true]);
+    await sock.read(3072);
+    assert.deepStrictEqual(sock.pauses, [true, false]);
+  });
+
+  it('waitall', async () => {
+    const sock = await newPausingSocket();
+    // Requests bigger than the high water mark still finish.
+    const pending = sock.read(12288, true, {waitAll: true});
+    for (let i = 0; i < 3; ++i) {
+      sock.onRecv(new ArrayBuffer(4096));
+      await new Promise((resolve) => setTimeout(resolve));
+    }
+    const ret = await pending;
+    assert.equal(ret.buf.length, 12288);
+    assert.deepStrictEqual(sock.pauses, [true, false, true, false]);
+  });
+});
+
+/**
+ * Check stream socket writes get coalesced.
+ */
+describe('StreamSocket-write', () => {
+  /**
+   * @return {!Promise<!Sockets.StreamSocket>} A socket that records sends.
+   */
+  const newSendingSocket = async () => {
+    const sock = await newSocket();
+    sock.sent = [];
+    sock.send_ = async (buf) => {
+      sock.sent.push(Array.from(buf));
+      return WASI.errno.ESUCCESS;
+    };
+    return sock;
+  };
+
+  it('coalesce', async () => {
+    const sock = await newSendingSocket();
+    const buf = new Uint8Array([1, 2]);
+    assert.deepStrictEqual(await sock.queueWrite_(buf), {nwritten: 2});
+    // The program can reuse its buffer right away.
+    buf.fill(3);
+    assert.deepStrictEqual(await sock.queueWrite_(buf), {nwritten: 2});
+    assert.deepStrictEqual(sock.sent, []);
+
+    await new Promise((resolve) => setTimeout(resolve));
+    assert.deepStrictEqual(sock.sent, [[1, 2, 3, 3]]);
+    assert.deepStrictEqual(sock.stats, {writes: 2, sends: 1});
+  });
+
+  it('nodelay', async () => {
+    const sock = await newSendingSocket();
+    await sock.setSocketOption(IPPROTO_TCP, TCP_NODELAY, 1);
+    await sock.queueWrite_(new Uint8Array([1]));
+    await sock.queueWrite_(new Uint8Array([2]));
+    assert.deepStrictEqual(sock.sent, [[1], [2]]);
+  });
+
+  it('cork', async () => {
+    const sock = await newSendingSocket();
+    await sock.setSocketOption(IPPROTO_TCP, TCP_NODELAY, 1);
+    await sock.setSocketOption(IPPROTO_TCP, TCP_CORK, 1);
+    assert.deepStrictEqual(
+        await sock.getSocketOption(IPPROTO_TCP, TCP_CORK), {option: 1});
+    await sock.queueWrite_(new Uint8Array([1]));
+    await sock.queueWrite_(new Uint8Array([2]));
+    await new Promise((resolve) => setTimeout(resolve));
+    assert.deepStrictEqual(sock.sent, []);
+
+    await sock.setSocketOption(IPPROTO_TCP, TCP_CORK, 0);
+    assert.deepStrictEqual(sock.sent, [[1, 2]]);
+  });
+
+  it('errors', async () => {
+    const sock = await newSendingSocket();
+    sock.send_ = async () => WASI.errno.ECONNRESET;
+    await sock.queueWrite_(new Uint8Array([1]));
+    await new Promise((resolve) => setTimeout(resolve));
+    // Errors show up on the next write.
+    assert.equal(await sock.queueWrite_(new Uint8Array([2])),
+                 WASI.errno.ECONNRESET);
+  });
+
+  it('drain', async () => {
+    const sock = await newSendingSocket();
+    await sock.queueWrite_(new Uint8Array([1]));
+    assert.equal(await sock.drain(), WASI.errno.ESUCCESS);
+    assert.deepStrictEqual(sock.sent, [[1]]);
+
+    // Errors sending the last of the data aren't lost.
+    sock.send_ = async () => WASI.errno.ECONNRESET;
+    await sock.queueWrite_(new Uint8Array([2]));
+    assert.equal(await sock.drain(), WASI.errno.ECONNRESET);
+    assert.equal(await sock.drain(), WASI.errno.ESUCCESS);
+  });
+});
+
+/**
+ * Check stream socket options.
+ */
+describe('StreamSocket-options', () => {
+  it('buffer sizes', async () => {
+    const sock = await newSocket();
+    assert.equal(
+        await sock.setSocketOption(SOL_SOCKET, SO_SNDBUF, 32 * 1024),
+        WASI.errno.ESUCCESS);
+    assert.deepStrictEqual(
+        await sock.getSocketOption(SOL_SOCKET, SO_SNDBUF), {option: 32 * 1024});
+
+    // Sizes are clamped, and the real value reported back.
+    await sock.setSocketOption(SOL_SOCKET, SO_RCVBUF, 1);
+    assert.deepStrictEqual(
+        await sock.getSocketOption(SOL_SOCKET, SO_RCVBUF), {option: 4096});
+  });
+
+  it('write clamping', async () => {
+    const sock = await newSocket();
+    const buf = new Uint8Array(100000);
+    // Writes are left alone by default.
+    assert.strictEqual(sock.clampWrite_(buf), buf);
+
+    await sock.setSocketOption(SOL_SOCKET, SO_SNDBUF, 8192);
+    assert.equal(sock.clampWrite_(buf).length, 8192);
+    assert.strictEqual(sock.clampWrite_(buf.subarray(0, 100)).length, 100);
+  });
+
+  it('interactive profile', async () => {
+    const sock = await newSocket();
+    assert.deepStrictEqual(
+        await sock.getSocketOption(IPPROTO_TCP, TCP_NODELAY), {option: 0});
+
+    assert.equal(
+        await sock.setSocketOption(
+            SOL_SOCKET, SO_WASSH_PROFILE,
+            Constants.WASSH_SOCK_PROFILE_INTERACTIVE),
+        WASI.errno.ESUCCESS);
+    assert.deepStrictEqual(
+        await sock.getSocketOption(IPPROTO_TCP, TCP_NODELAY), {option: 1});
+    assert.deepStrictEqual(
+        await sock.getSocketOption(SOL_SOCKET, SO_SNDBUF), {option: 16 * 1024});
+    assert.equal(sock.clampWrite_(new Uint8Array(100000)).length, 16 * 1024);
+
+    assert.equal(
+        await sock.setSocketOption(SOL_SOCKET, SO_WASSH_PROFILE, 100),
+        WASI.errno.EINVAL);
+  });
+
+  it('IPQoS', async () => {
+    const sock = await newSocket();
+    const tests = [
+      // lowdelay & ef.
+      [0x10, Constants.WASSH_SOCK_PROFILE_INTERACTIVE],
+      [0xb8, Constants.WASSH_SOCK_PROFILE_INTERACTIVE],
+      // throughput & cs1.
+      [0x08, Constants.WASSH_SOCK_PROFILE_BULK],
+      [0x20, Constants.WASSH_SOCK_PROFILE_BULK],
+      [0, Constants.WASSH_SOCK_PROFILE_DEFAULT],
+    ];
+    for (const [tos, profile] of tests) {
+      await sock.setSocketOption(IPPROTO_IP, IP_TOS, tos);
+      assert.deepStrictEqual(
+          await sock.getSocketOption(IPPROTO_IP, IP_TOS), {option: tos});
+      assert.deepStrictEqual(
+          await sock.getSocketOption(SOL_SOCKET, SO_WASSH_PROFILE),
+          {option: profile});
+    }
+  });
+});
+
+/**
+ * Check datagram socket read flags.
+ */
+describe('DatagramSocket-read', () => {
+  it('peek', async () => {
+    const sock = await newSocket(Constants.SOCK_DGRAM);
+    sock.onRecv(new Uint8Array([1, 2, 3]).buffer);
+    sock.onRecv(new Uint8Array([4]).buffer);
+    assert.equal(sock.pendingBytes(), 3);
+
+    let ret = await sock.read(10, true, {peek: true});
+    assert.deepStrictEqual(ret.buf, new Uint8Array([1, 2, 3]));
+    ret = await sock.read(10);
+    assert.deepStrictEqual(ret.buf, new Uint8Array([1, 2, 3]));
+    assert.equal(sock.pendingBytes(), 1);
+  });
+});
+
+/**
+ * Check datagram sockets bound their receive queue.
+ */
+describe('DatagramSocket-queue', () => {
+  /**
+   * @param {number} policy The Constants.WASSH_SOCK_DROP_xxx policy.
+   * @return {!Promise<!Sockets.DatagramSocket>} A socket that had to drop.
+   */
+  const newFullSocket = async (policy) => {
+    const sock = await newSocket(Constants.SOCK_DGRAM, {
+      [SO_RCVBUF]: 4096,
+      [SO_WASSH_DROP_POLICY]: policy,
+    });
+    for (let i = 0; i < 5; ++i) {
+      sock.onRecv(new Uint8Array(1024).fill(i).buffer);
+    }
+    return sock;
+  };
+
+  it('drop oldest', async () => {
+    const sock = await newFullSocket(Constants.WASSH_SOCK_DROP_OLDEST);
+    assert.deepStrictEqual(sock.stats, {enqueued: 5, dropped: 1, maxDepth: 4});
+    const ret = await sock.read(1024);
+    assert.equal(ret.buf[0], 1);
+  });
+
+  it('drop newest', async () => {
+    const sock = await newFullSocket(Constants.WASSH_SOCK_DROP_NEWEST);
+    assert.deepStrictEqual(sock.stats, {enqueued: 4, dropped: 1, maxDepth: 4});
+    let ret = await sock.read(1024);
+    assert.equal(ret.buf[0], 0);
+
+    // Reading makes room again.
+    sock.onRecv(new Uint8Array(1024).fill(5).buffer);
+    assert.equal(sock.stats.dropped, 1);
+    for (let i = 0; i < 4; ++i) {
+      ret = await sock.read(1024);
+    }
+    assert.equal(ret.buf[0], 5);
+  });
+
+  it('options', async () => {
+    const sock = await newSocket(Constants.SOCK_DGRAM);
+    assert.deepStrictEqual(
+        await sock.getSocketOption(SOL_SOCKET, SO_WASSH_DROP_POLICY),
+        {option: Constants.WASSH_SOCK_DROP_OLDEST});
+    assert.equal(
+        await sock.setSocketOption(SOL_SOCKET, SO_WASSH_DROP_POLICY, 100),
+        WASI.errno.EINVAL);
+
+    // Oversized packets still get thru when the queue is empty.
+    await sock.setSocketOption(SOL_SOCKET, SO_RCVBUF, 4096);
+    sock.onRecv(new ArrayBuffer(8192));
+    assert.equal(sock.pendingBytes(), 8192);
+  });
+});
@@ -11,6 +11,11 @@
 import {SyscallEntry, util, WASI} from '../../wasi-js-bindings/index.js';
 import * as Constants from './constants.js';
 
+/**
+ * How many nanoseconds in one millisecond.
+ */
+const kNanosecToMillisec = 1000000;
+
 /**
  * WASSH syscall extensions.
  */
@@ -31,8 +36,8 @@ export class WasshExperimental extends SyscallEntry.Base {
       return ret;
     }
 
-    const dv = this.getView_(newsock_ptr, 4);
-    dv.setFd(0, ret.socket, true);
+    const dv = this.getMemView_();
+    dv.setFd(newsock_ptr, ret.socket, true);
 
     return WASI.errno.ESUCCESS;
   }
@@ -48,11 +53,11 @@ export class WasshExperimental extends SyscallEntry.Base {
     let address;
     switch (domain) {
       case Constants.AF_INET: {
-        const dv = this.getView_(addr_ptr, 4);
+        const dv = this.getMemView_();
         const bytes = this.getMem_(addr_ptr, addr_ptr + 4);
         // If address is within the fake range (0.0.0.0/8), pass it as an
         // integer to look up the real host later.
-        address = dv.getUint32(0, true);
+        address = dv.getUint32(addr_ptr, true);
         if (address >= 0x1000000) {
           address = bytes.join('.');
         }
@@ -66,9 +71,10 @@ export class WasshExperimental extends SyscallEntry.Base {
           // integer to look up the real host later.
           address = bytes[15];
         } else {
-          const dv = this.getView_(addr_ptr, 16);
+          const dv = this.getMemView_();
           address = [...Array(8).keys()].map(
-              (i) => dv.getUint16(i << 1, false).toString(16).padStart(4, '0'),
+              (i) => dv.getUint16(addr_ptr + (i << 1), false)
+                  .toString(16).padStart(4, '0'),
           ).join(':');
         }
         break;
@@ -115,8 +121,8 @@ export class WasshExperimental extends SyscallEntry.Base {
       return ret;
     }
 
-    const dv = this.getView_(sock_ptr, 4);
-    dv.setUint32(0, ret.socket, true);
+    const dv = this.getMemView_();
+    dv.setUint32(sock_ptr, ret.socket, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -146,11 +152,11 @@ export class WasshExperimental extends SyscallEntry.Base {
       }
 
       case Constants.AF_INET: {
-        const dv = this.getView_(addr_ptr, 4);
+        const dv = this.getMemView_();
         const bytes = this.getMem_(addr_ptr, addr_ptr + 4);
         // If address is within the fake range (0.0.0.0/8), pass it as an
         // integer to look up the real host later.
-        address = dv.getUint32(0, true);
+        address = dv.getUint32(addr_ptr, true);
         if (address >= 0x1000000) {
           address = bytes.join('.');
         }
@@ -164,9 +170,10 @@ export class WasshExperimental extends SyscallEntry.Base {
           // integer to look up the real host later.
           address = bytes[15];
         } else {
-          const dv = this.getView_(addr_ptr, 16);
+          const dv = this.getMemView_();
           address = [...Array(8).keys()].map(
-              (i) => dv.getUint16(i << 1, false).toString(16).padStart(4, '0'),
+              (i) => dv.getUint16(addr_ptr + (i << 1), false)
+                  .toString(16).padStart(4, '0'),
           ).join(':');
         }
         break;
@@ -192,8 +199,7 @@ export class WasshExperimental extends SyscallEntry.Base {
       return ret;
     }
 
-    const dvFamily = this.getView_(family_ptr, 4);
-    const dvPort = this.getView_(port_ptr, 2);
+    const dv = this.getMemView_();
     let addrLen;
 
     switch (ret.family) {
@@ -209,8 +215,8 @@ export class WasshExperimental extends SyscallEntry.Base {
         return WASI.errno.EPROTONOSUPPORT;
     }
 
-    dvFamily.setInt32(0, ret.family, true);
-    dvPort.setUint16(0, ret.port, true);
+    dv.setInt32(family_ptr, ret.family, true);
+    dv.setUint16(port_ptr, ret.port, true);
 
     const bytes = this.getMem_(addr_ptr, addr_ptr + addrLen);
     bytes.set(ret.address);
@@ -231,8 +237,8 @@ export class WasshExperimental extends SyscallEntry.Base {
       return ret;
     }
 
-    const dv = this.getView_(value_ptr);
-    dv.setInt32(0, ret.option, true);
+    const dv = this.getMemView_();
+    dv.setInt32(value_ptr, ret.option, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -260,24 +266,31 @@ export class WasshExperimental extends SyscallEntry.Base {
    */
   sys_sock_recvfrom(sock, buf_ptr, buf_len, nwritten_ptr, flags, domain_ptr,
                     addr_ptr, port_ptr) {
-    if (flags & ~(Constants.MSG_DONTWAIT)) {
+    if (flags & ~(Constants.MSG_DONTWAIT | Constants.MSG_PEEK |
+                  Constants.MSG_WAITALL)) {
       return WASI.errno.EINVAL;
     }
 
-    const ret = this.handle_sock_recvfrom(sock, buf_len, flags);
+    const bytes = this.getMem_(buf_ptr, buf_ptr + buf_len);
+    const dest = this.getDest_(bytes);
+    const ret = this.handle_sock_recvfrom(sock, buf_len, flags, dest);
     if (typeof ret === 'number') {
       return ret;
     }
 
-    const bytes = this.getMem_(buf_ptr, buf_ptr + buf_len);
-    bytes.set(ret.buf);
+    let nread = ret.nread;
+    if (ret.buf !== undefined) {
+      bytes.set(ret.buf);
+      nread = ret.buf.length;
+    } else {
+      this.finishDest_(bytes, dest, nread);
+    }
 
-    const dvWritten = this.getView_(nwritten_ptr, 4);
-    dvWritten.setUint32(0, ret.buf.length, true);
+    const dv = this.getMemView_();
+    dv.setUint32(nwritten_ptr, nread, true);
 
     if (domain_ptr) {
-      const dv = this.getView_(domain_ptr, 4);
-      dv.setUint32(0, ret.domain, true);
+      dv.setUint32(domain_ptr, ret.domain, true);
     }
 
     if (addr_ptr) {
@@ -297,8 +310,7 @@ export class WasshExperimental extends SyscallEntry.Base {
     }
 
     if (port_ptr) {
-      const dv = this.getView_(port_ptr, 2);
-      dv.setUint16(0, ret.port, true);
+      dv.setUint16(port_ptr, ret.port, true);
     }
 
     return WASI.errno.ESUCCESS;
@@ -324,11 +336,11 @@ export class WasshExperimental extends SyscallEntry.Base {
     let address;
     switch (domain) {
       case Constants.AF_INET: {
-        const dv = this.getView_(addr_ptr, 4);
+        const dv = this.getMemView_();
         const bytes = this.getMem_(addr_ptr, addr_ptr + 4);
         // If address is within the fake range (0.0.0.0/8), pass it as an
         // integer to look up the real host later.
-        address = dv.getUint32(0, true);
+        address = dv.getUint32(addr_ptr, true);
         if (address >= 0x1000000) {
           address = bytes.join('.');
         }
@@ -342,9 +354,10 @@ export class WasshExperimental extends SyscallEntry.Base {
           // integer to look up the real host later.
           address = bytes[15];
         } else {
-          const dv = this.getView_(addr_ptr, 16);
+          const dv = this.getMemView_();
           address = [...Array(8).keys()].map(
-              (i) => dv.getUint16(i << 1, false).toString(16).padStart(4, '0'),
+              (i) => dv.getUint16(addr_ptr + (i << 1), false)
+                  .toString(16).padStart(4, '0'),
           ).join(':');
         }
         break;
@@ -362,8 +375,8 @@ export class WasshExperimental extends SyscallEntry.Base {
       return ret;
     }
 
-    const dvWritten = this.getView_(nwritten_ptr, 4);
-    dvWritten.setUint32(0, ret.nwritten, true);
+    const dv = this.getMemView_();
+    dv.setUint32(nwritten_ptr, ret.nwritten, true);
 
     return WASI.errno.ESUCCESS;
   }
@@ -379,8 +392,8 @@ export class WasshExperimental extends SyscallEntry.Base {
       return ret;
     }
 
-    const dv = this.getView_(newfd_ptr);
-    dv.setFd(0, ret.fd, true);
+    const dv = this.getMemView_();
+    dv.setFd(newfd_ptr, ret.fd, true);
     return WASI.errno.ESUCCESS;
   }
 
@@ -393,6 +406,137 @@ export class WasshExperimental extends SyscallEntry.Base {
     return this.handle_fd_dup2(oldfd, newfd);
   }
 
+  /**
+   * Allocate placeholder fds for pipe() & socketpair().
+   *
+   * @param {!WASI_t.filetype} filetype The filetype to report for the fds.
+   * @param {!WASI_t.pointer} fds_ptr Pointer to array of 2 fds.
+   * @return {!WASI_t.errno}
+   */
+  sys_fd_pipe(filetype, fds_ptr) {
+    const ret = this.handle_fd_pipe(filetype);
+    if (typeof ret === 'number') {
+      return ret;
+    }
+
+    const dv = this.getMemView_();
+    dv.setFd(fds_ptr, ret.fds[0], true);
+    dv.setFd(fds_ptr + 4, ret.fds[1], true);
+    return WASI.errno.ESUCCESS;
+  }
+
+  /**
+   * Note that a pipe changed so polls watching pipes recheck them.
+   *
+   * @return {!WASI_t.errno}
+   */
+  sys_fd_pipe_notify() {
+    return this.handle_fd_pipe_notify();
+  }
+
+  /**
+   * @param {!WASI_t.pointer} epfd_ptr Pointer to store the new epoll fd.
+   * @return {!WASI_t.errno}
+   */
+  sys_fd_epoll_create(epfd_ptr) {
+    const ret = this.handle_fd_epoll_create();
+    if (typeof ret === 'number') {
+      return ret;
+    }
+
+    const dv = this.getMemView_();
+    dv.setFd(epfd_ptr, ret.fd, true);
+    return WASI.errno.ESUCCESS;
+  }
+
+  /**
+   * @param {!WASI_t.fd} epfd The epoll fd.
+   * @param {!WASI_t.s32} op One of the EPOLL_CTL_* operations.
+   * @param {!WASI_t.fd} fd The fd to watch.
+   * @param {!WASI_t.u32} events The EPOLL* events to watch for.
+   * @param {!WASI_t.u64} data The user data to return with events.
+   * @return {!WASI_t.errno}
+   */
+  sys_fd_epoll_ctl(epfd, op, fd, events, data) {
+    return this.handle_fd_epoll_ctl(epfd, op, fd, events >>> 0, data);
+  }
+
+  /**
+   * @param {!WASI_t.fd} epfd The epoll fd.
+   * @param {!WASI_t.pointer} events_ptr Array of struct epoll_event.
+   * @param {!WASI_t.s32} maxevents Number of entries in |events_ptr|.
+   * @param {!WASI_t.s64} timeout Nanoseconds to wait, or -1 to wait forever.
+   * @param {!WASI_t.pointer} nready_ptr How many events were returned.
+   * @return {!WASI_t.errno}
+   */
+  sys_fd_epoll_wait(epfd, events_ptr, maxevents, timeout, nready_ptr) {
+    if (maxevents <= 0) {
+      return WASI.errno.EINVAL;
+    }
+
+    const msec = timeout < 0n ? -1 : Number(timeout) / kNanosecToMillisec;
+    const ret = this.handle_fd_epoll_wait(epfd, maxevents, msec);
+    if (typeof ret === 'number') {
+      return ret;
+    }
+
+    if (this.deliverSignals_(ret)) {
+      return WASI.errno.EINTR;
+    }
+
+    // struct epoll_event is 16 bytes: u32 events, 4 bytes padding, u64 data.
+    const dv = this.getMemView_();
+    ret.events.forEach(({events, data}, i) => {
+      dv.setUint32(events_ptr + i * 16, events, true);
+      dv.setBigUint64(events_ptr + i * 16 + 8, data, true);
+    });
+    dv.setUint32(nready_ptr, ret.events.length, true);
+    return WASI.errno.ESUCCESS;
+  }
+
+  /**
+   * Move data between two fds without copying it through WASM memory.
+   *
+   * @param {!WASI_t.fd} fd_in The fd to read from.
+   * @param {!WASI_t.fd} fd_out The fd to write to.
+   * @param {!WASI_t.size} len Max number of bytes to move.
+   * @param {!WASI_t.u32} flags Bitmask of SPLICE_F_* flags.
+   * @param {!WASI_t.pointer} nspliced_ptr How many bytes were moved.
+   * @return {!WASI_t.errno}
+   */
+  sys_fd_splice(fd_in, fd_out, len, flags, nspliced_ptr) {
+    if (flags & ~(Constants.SPLICE_F_MOVE | Constants.SPLICE_F_NONBLOCK |
+                  Constants.SPLICE_F_MORE)) {
+      return WASI.errno.EINVAL;
+    }
+
+    const ret = this.handle_fd_splice(fd_in, fd_out, len, flags);
+    if (typeof ret === 'number') {
+      return ret;
+    }
+
+    const dv = this.getMemView_();
+    dv.setUint32(nspliced_ptr, ret.nspliced, true);
+    return WASI.errno.ESUCCESS;
+  }
+
+  /**
+   * Register the bitmap where pending signals are queued.
+   *
+   * This runs entirely in the worker: the process remembers the pointer, and
+   * poll_oneoff sets bits in it directly rather than calling back into WASM.
+   *
+   * @param {!WASI_t.pointer} pending_ptr Pointer to a 64-bit signal bitmap.
+   * @return {!WASI_t.errno}
+   */
+  sys_signal_register(pending_ptr) {
+    if (pending_ptr % 8) {
+      return WASI.errno.EINVAL;
+    }
+    this.process_.signal_pending_ptr = pending_ptr;
+    return WASI.errno.ESUCCESS;
+  }
+
   /**
    * Get the terminal window size.
    *
@@ -407,11 +551,11 @@ export class WasshExperimental extends SyscallEntry.Base {
     }
 
     // Structure is 4 shorts (16-bit) values.
-    const dv = this.getView_(winsize_ptr);
-    dv.setUint16(0, ret.row, true);
-    dv.setUint16(2, ret.col, true);
-    dv.setUint16(4, ret.xpixel, true);
-    dv.setUint16(6, ret.ypixel, true);
+    const dv = this.getMemView_();
+    dv.setUint16(winsize_ptr, ret.row, true);
+    dv.setUint16(winsize_ptr + 2, ret.col, true);
+    dv.setUint16(winsize_ptr + 4, ret.xpixel, true);
+    dv.setUint16(winsize_ptr + 6, ret.ypixel, true);
     return WASI.errno.ESUCCESS;
   }
 
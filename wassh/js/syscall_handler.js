@@ -8,16 +8,11 @@
  * @suppress {checkTypes} module$__$wasi_js_bindings$js naming confusion.
  */
 
-import {SyscallHandler, WASI} from '../../wasi-js-bindings/index.js';
+import {SyscallHandler, util, WASI} from '../../wasi-js-bindings/index.js';
 import * as Constants from './constants.js';
 import * as Sockets from './sockets.js';
 import * as VFS from './vfs.js';
 
-/**
- * How many nanoseconds in one millisecond.
- */
-const kNanosecToMillisec = 1000000;
-
 class Tty extends VFS.FileHandle {
   constructor(term, handler) {
     super('/dev/tty', WASI.filetype.CHARACTER_DEVICE);
@@ -74,9 +69,7 @@ class Tty extends VFS.FileHandle {
     newData.set(this.data);
     newData.set(u8, this.data.length);
     this.data = newData;
-    if (this.handler.notify_) {
-      this.handler.notify_();
-    }
+    this.handler.onActivity_(this);
   }
 }
 
@@ -93,7 +86,8 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
     this.tcpSocketsOpen_ = tcpSocketsOpen;
     this.unixSocketsOpen_ = unixSocketsOpen;
     this.secureInput_ = secureInput;
-    this.notify_ = null;
+    /** @const {!Set<!VFS.EpollHandle>} */
+    this.epolls_ = new Set();
     this.fileSystem_ = fileSystem;
     this.vfs = new VFS.VFS({stdio: false});
     this.socketUdpRecv_ = null;
@@ -121,17 +115,149 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
     this.vfs.addHandler(new VFS.DevNullHandler());
 
     this.term_.io.onTerminalResize = (width, height) => {
+      this.process_.cache.invalidateWindowSize();
       // https://github.com/WebAssembly/wasi-libc/issues/272
       this.process_.send_signal(28 /* musl SIGWINCH */);
     };
   }
 
+  /**
+   * Note that |handle| has new data (or state), and wake up any waiters.
+   *
+   * @param {!VFS.PathHandle} handle
+   */
+  onActivity_(handle) {
+    this.epolls_.forEach((ep) => ep.onActivity(handle));
+    this.process_.cache.notifyReady();
+  }
+
+  /**
+   * Sleep until the timeout or the readiness word changes.
+   *
+   * Read the word (see getReady_) before checking for events: anything that
+   * happens after that ends the wait right away, so wakeups aren't lost.
+   *
+   * @param {number} ready The readiness word when we started checking.
+   * @param {number=} msec How long to sleep (may be fractional).
+   */
+  async sleep_(ready, msec = Infinity) {
+    this.debug(`poll: sleeping for ${msec} milliseconds`);
+    await this.process_.cache.waitReady(ready, msec);
+  }
+
+  /**
+   * @return {number} The readiness word for sleep_.
+   */
+  getReady_() {
+    return this.process_.cache.getReady();
+  }
+
+  /**
+   * Take all the queued signals.
+   *
+   * @return {!Array<number>|undefined} The signals, if any.
+   */
+  takeSignals_() {
+    if (this.process_.signal_queue.length === 0) {
+      return undefined;
+    }
+    const signals = Array.from(this.process_.signal_queue);
+    this.process_.signal_queue.length = 0;
+    this.process_.cache.setSignalsPending(false);
+    return signals;
+  }
+
+  /**
+   * Common code for the vectored read handlers.
+   *
+   * Like readv(), this stops at the first short read, and only returns an error
+   * if nothing was read.  It won't block once some data has been read.
+   *
+   * @param {!VFS.FileHandle} fh The handle to read from.
+   * @param {function(number, number, !Uint8Array):
+   *     !Promise<!WASI_t.errno|!Object>} read Reads a length of bytes that
+   *     starts this many bytes into the request, optionally straight into the
+   *     given buffer.
+   * @param {!Array<number>} lengths The size of each iovec.
+   * @param {!Array<!Uint8Array>=} dests Where to write each iovec: program
+   *     memory, or a staging buffer the entry copies from.
+   * @return {!Promise<!WASI_t.errno|
+   *                   {buf: !Uint8Array}|
+   *                   {nread: !WASI_t.size}>}
+   */
+  async readv_(fh, read, lengths, dests = undefined) {
+    // Without destinations, the data goes back through the syscall lock, so
+    // don't return more than the largest iovec which it has to handle anyways.
+    const limit = dests ? Infinity : Math.max(0, ...lengths);
+    const out = dests ? null : new Uint8Array(limit);
+    let nread = 0;
+    for (let i = 0; i < lengths.length && nread < limit; ++i) {
+      if (nread && fh instanceof Sockets.Socket && !fh.pendingBytes()) {
+        break;
+      }
+
+      const length = Math.min(lengths[i], limit - nread);
+      const dest = dests ? dests[i] : out.subarray(nread, nread + length);
+      const ret = util.writeReadResult(await read(length, nread, dest), dest);
+      if (typeof ret === 'number') {
+        if (nread) {
+          break;
+        }
+        return ret;
+      }
+
+      nread += ret.nread;
+      if (ret.nread < length) {
+        break;
+      }
+    }
+
+    return dests ? {nread} : {buf: out.subarray(0, nread)};
+  }
+
+  /**
+   * Common code for the vectored write handlers.
+   *
+   * Like writev(), this stops at the first short write, and only returns an
+   * error if nothing was written.
+   *
+   * @param {function(!Uint8Array, number): !Promise<!WASI_t.errno|!Object>}
+   *     write Writes a buffer that starts this many bytes into the request.
+   * @param {!Array<!Uint8Array>} bufs The iovecs to write.
+   * @return {!Promise<!WASI_t.errno|{nwritten: !WASI_t.size}>}
+   */
+  async writev_(write, bufs) {
+    let nwritten = 0;
+    for (const buf of bufs) {
+      const ret = await write(buf, nwritten);
+      if (typeof ret === 'number' && ret !== WASI.errno.ESUCCESS) {
+        if (nwritten) {
+          break;
+        }
+        return ret;
+      }
+
+      const n = typeof ret === 'number' ? buf.length : ret.nwritten;
+      nwritten += n;
+      if (n < buf.length) {
+        break;
+      }
+    }
+
+    return {nwritten};
+  }
+
   /**
    * @param {!WASI_t.fd} fd
    * @return {!WASI_t.errno}
    * @override
    */
   handle_fd_close(fd) {
+    const handle = this.vfs.getFileHandle(fd);
+    if (handle instanceof VFS.EpollHandle) {
+      this.epolls_.delete(handle);
+    }
+    this.epolls_.forEach((ep) => ep.delete(fd));
     return this.vfs.close(fd);
   }
 
@@ -226,6 +352,11 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
     // Ignore sync flags as we always sync storage.
     fdflags &= ~(WASI.fdflags.DSYNC | WASI.fdflags.RSYNC | WASI.fdflags.SYNC);
 
+    // Pipes are implemented in the C library which tracks O_NONBLOCK here.
+    if (fh instanceof VFS.PipeHandle) {
+      fh.fdflags = fdflags & WASI.fdflags.NONBLOCK;
+    }
+
     // TODO(vapier): Support O_NONBLOCK.
     fdflags &= ~WASI.fdflags.NONBLOCK;
 
@@ -236,19 +367,39 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
    * @param {!WASI_t.fd} fd
    * @param {!WASI_t.size} length
    * @param {!WASI_t.filesize} offset
+   * @param {!Uint8Array=} dest
    * @return {!WASI_t.errno|
    *          {buf: !Uint8Array, nread: !WASI_t.size}|
    *          {buf: !Uint8Array}|
    *          {nread: !WASI_t.size}}
    * @override
    */
-  async handle_fd_pread(fd, length, offset) {
+  async handle_fd_pread(fd, length, offset, dest = undefined) {
     const fh = this.vfs.getFileHandle(fd);
     if (fh === undefined) {
       return WASI.errno.EBADF;
     }
 
-    return fh.pread(length, offset);
+    return util.writeReadResult(await fh.pread(length, offset), dest);
+  }
+
+  /**
+   * @param {!WASI_t.fd} fd
+   * @param {!Array<!WASI_t.size>} lengths
+   * @param {!WASI_t.filesize} offset
+   * @param {!Array<!Uint8Array>=} dests
+   * @return {!WASI_t.errno|{buf: !Uint8Array}|{nread: !WASI_t.size}}
+   * @override
+   */
+  async handle_fd_preadv(fd, lengths, offset, dests = undefined) {
+    const fh = this.vfs.getFileHandle(fd);
+    if (fh === undefined) {
+      return WASI.errno.EBADF;
+    }
+
+    return this.readv_(
+        fh, (length, pos) => fh.pread(length, BigInt(offset) + BigInt(pos)),
+        lengths, dests);
   }
 
   /**
@@ -305,6 +456,23 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
     return fh.pwrite(buf, offset);
   }
 
+  /**
+   * @param {!WASI_t.fd} fd
+   * @param {!Array<!Uint8Array>} bufs
+   * @param {!WASI_t.filesize} offset
+   * @return {!WASI_t.errno|{nwritten: !WASI_t.size}}
+   * @override
+   */
+  async handle_fd_pwritev(fd, bufs, offset) {
+    const fh = this.vfs.getFileHandle(fd);
+    if (fh === undefined) {
+      return WASI.errno.EBADF;
+    }
+
+    return this.writev_(
+        (buf, pos) => fh.pwrite(buf, BigInt(offset) + BigInt(pos)), bufs);
+  }
+
   /**
    * @param {!WASI_t.fd} oldfd
    * @return {!WASI_t.errno}
@@ -319,7 +487,229 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
    * @return {!WASI_t.errno}
    */
   handle_fd_dup2(oldfd, newfd) {
-    return this.vfs.dup(oldfd, newfd);
+    this.process_.cache.invalidateFd(newfd);
+    return this.vfs.dup2(oldfd, newfd);
+  }
+
+  /**
+   * @param {!WASI_t.filetype} filetype
+   * @return {!WASI_t.errno|{fds: !Array<!WASI_t.fd>}}
+   */
+  handle_fd_pipe(filetype) {
+    return this.vfs.pipe(filetype);
+  }
+
+  /**
+   * Flag a pipe change so polls watching pipes end early.
+   *
+   * @return {!WASI_t.errno}
+   */
+  handle_fd_pipe_notify() {
+    this.process_.cache.setPipesPending();
+    return WASI.errno.ESUCCESS;
+  }
+
+  /**
+   * @return {!WASI_t.errno|{fd: !WASI_t.fd}}
+   */
+  handle_fd_epoll_create() {
+    const ep = new VFS.EpollHandle();
+    const fd = this.vfs.openHandle(ep);
+    if (fd < 0) {
+      return WASI.errno.EMFILE;
+    }
+    this.epolls_.add(ep);
+    return {fd};
+  }
+
+  /**
+   * @param {!WASI_t.fd} epfd
+   * @param {number} op One of the EPOLL_CTL_* operations.
+   * @param {!WASI_t.fd} fd
+   * @param {number} events The EPOLL* events to watch for.
+   * @param {bigint} data The user data to return with events.
+   * @return {!WASI_t.errno}
+   */
+  handle_fd_epoll_ctl(epfd, op, fd, events, data) {
+    const ep = this.vfs.getFileHandle(epfd);
+    const handle = this.vfs.getFileHandle(fd);
+    if (ep === undefined || handle === undefined) {
+      return WASI.errno.EBADF;
+    }
+    if (!(ep instanceof VFS.EpollHandle) || ep === handle) {
+      return WASI.errno.EINVAL;
+    }
+
+    switch (op) {
+      case Constants.EPOLL_CTL_ADD:
+      case Constants.EPOLL_CTL_MOD:
+        if ((op === Constants.EPOLL_CTL_ADD) === ep.interests.has(fd)) {
+          return op === Constants.EPOLL_CTL_ADD ?
+              WASI.errno.EEXIST : WASI.errno.ENOENT;
+        }
+        // Like Linux, only things that can block are supported.
+        if (handle.filetype !== WASI.filetype.SOCKET_STREAM &&
+            handle.filetype !== WASI.filetype.SOCKET_DGRAM &&
+            handle.filetype !== WASI.filetype.CHARACTER_DEVICE) {
+          return WASI.errno.EPERM;
+        }
+        ep.set(fd, handle, events, data);
+        return WASI.errno.ESUCCESS;
+
+      case Constants.EPOLL_CTL_DEL:
+        return ep.delete(fd) ? WASI.errno.ESUCCESS : WASI.errno.ENOENT;
+
+      default:
+        return WASI.errno.EINVAL;
+    }
+  }
+
+  /**
+   * Check whether reading |handle| would return right away.
+   *
+   * That's when data is queued, a listening socket has connections waiting,
+   * or the peer is done sending (so the read returns EOF or an error).
+   *
+   * @param {!VFS.PathHandle} handle
+   * @return {boolean}
+   */
+  readReady_(handle) {
+    if (handle.data.length || handle?.clients_?.length) {
+      return true;
+    }
+    return handle instanceof Sockets.Socket && handle.recvEnded();
+  }
+
+  /**
+   * Check which of the requested events are ready on |handle|.
+   *
+   * @param {!VFS.PathHandle} handle
+   * @param {number} events The EPOLL* events to check.
+   * @return {number} The ready EPOLL* events.
+   */
+  epollEvents_(handle, events) {
+    let ret = 0;
+    if (this.readReady_(handle)) {
+      ret |= events & (Constants.EPOLLIN | Constants.EPOLLRDNORM);
+    }
+    if (!(handle instanceof Sockets.Socket)) {
+      // Writes to other handles never block.
+      return ret | (events & (Constants.EPOLLOUT | Constants.EPOLLWRNORM));
+    }
+
+    if (handle.writeReady()) {
+      ret |= events & (Constants.EPOLLOUT | Constants.EPOLLWRNORM);
+    }
+    if (handle.recvEnded()) {
+      ret |= events & Constants.EPOLLRDHUP;
+      // Like Linux, these are reported even if they weren't requested.
+      ret |= Constants.EPOLLHUP;
+    }
+    if (handle.hasError()) {
+      ret |= Constants.EPOLLERR;
+    }
+    return ret;
+  }
+
+  /**
+   * Wait for events on an epoll fd.
+   *
+   * Only the fds that have seen activity since they were last checked are
+   * examined, so this scales with activity rather than the size of the set.
+   *
+   * @param {!WASI_t.fd} epfd
+   * @param {number} maxevents Max number of events to return.
+   * @param {number} timeout How long to wait (in milliseconds), or -1 to wait
+   *     forever.
+   * @return {!Promise<!WASI_t.errno|{
+   *           events: !Array<{events: number, data: bigint}>,
+   *           signals: (undefined|!Array<number>),
+   *         }>}
+   */
+  async handle_fd_epoll_wait(epfd, maxevents, timeout) {
+    const ep = this.vfs.getFileHandle(epfd);
+    if (ep === undefined) {
+      return WASI.errno.EBADF;
+    }
+    if (!(ep instanceof VFS.EpollHandle)) {
+      return WASI.errno.EINVAL;
+    }
+
+    const deadline = timeout < 0 ? undefined : performance.now() + timeout;
+    while (true) {
+      const ready = this.getReady_();
+      const events = [];
+      for (const fd of Array.from(ep.ready)) {
+        if (events.length >= maxevents) {
+          break;
+        }
+
+        const interest = ep.interests.get(fd);
+        const revents = this.epollEvents_(interest.handle, interest.events);
+        ep.ready.delete(fd);
+        if (revents) {
+          events.push({events: revents, data: interest.data});
+          // Events are level-triggered, so keep checking it, but move it to
+          // the back so other fds get a turn.
+          ep.ready.add(fd);
+        }
+      }
+
+      const signals = this.takeSignals_();
+      // The program watches its pipes itself, so let it recheck them.
+      if (events.length || signals || this.process_.cache.takePipesPending()) {
+        return {events, signals};
+      }
+
+      let delay = Infinity;
+      if (deadline !== undefined) {
+        delay = deadline - performance.now();
+        if (delay <= 0) {
+          return {events};
+        }
+      }
+      await this.sleep_(ready, delay);
+    }
+  }
+
+  /**
+   * Move queued data from a stream socket to another fd.
+   *
+   * The data is peeked first and only consumed once it has been written, so
+   * nothing is lost if the output fails.
+   *
+   * @param {!WASI_t.fd} fd_in
+   * @param {!WASI_t.fd} fd_out
+   * @param {!WASI_t.size} length
+   * @param {!WASI_t.u32} flags
+   * @return {!Promise<!WASI_t.errno|{nspliced: !WASI_t.size}>}
+   */
+  async handle_fd_splice(fd_in, fd_out, length, flags) {
+    const input = this.vfs.getFileHandle(fd_in);
+    const output = this.vfs.getFileHandle(fd_out);
+    if (input === undefined || output === undefined) {
+      return WASI.errno.EBADF;
+    }
+    // The C library falls back to read+write for everything else.
+    if (!(input instanceof Sockets.StreamSocket)) {
+      return WASI.errno.EINVAL;
+    }
+
+    const block = !(flags & Constants.SPLICE_F_NONBLOCK);
+    const ret = await input.read(length, block, {peek: true});
+    if (typeof ret === 'number') {
+      return ret;
+    }
+    if (ret.buf.length === 0) {
+      return {nspliced: 0};
+    }
+
+    const wret = await output.write(ret.buf);
+    if (typeof wret === 'number') {
+      return wret;
+    }
+    await input.read(wret.nwritten, false);
+    return {nspliced: wret.nwritten};
   }
 
   /**
@@ -335,19 +725,44 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
   /**
    * @param {!WASI_t.fd} fd
    * @param {!WASI_t.size} length
+   * @param {!Uint8Array=} dest
    * @return {!WASI_t.errno|
    *          {buf: !Uint8Array, nread: !WASI_t.size}|
    *          {buf: !Uint8Array}|
    *          {nread: !WASI_t.size}}
    * @override
    */
-  async handle_fd_read(fd, length) {
+  async handle_fd_read(fd, length, dest = undefined) {
     const fh = this.vfs.getFileHandle(fd);
     if (fh === undefined) {
       return WASI.errno.EBADF;
     }
 
-    return fh.read(length);
+    // Sockets can read straight into program memory.
+    if (fh instanceof Sockets.Socket) {
+      return fh.read(length, true, {dest});
+    }
+    return util.writeReadResult(await fh.read(length), dest);
+  }
+
+  /**
+   * @param {!WASI_t.fd} fd
+   * @param {!Array<!WASI_t.size>} lengths
+   * @param {!Array<!Uint8Array>=} dests
+   * @return {!WASI_t.errno|{buf: !Uint8Array}|{nread: !WASI_t.size}}
+   * @override
+   */
+  async handle_fd_readv(fd, lengths, dests = undefined) {
+    const fh = this.vfs.getFileHandle(fd);
+    if (fh === undefined) {
+      return WASI.errno.EBADF;
+    }
+
+    // Sockets can read straight into the iovecs.
+    const read = fh instanceof Sockets.Socket ?
+        (length, nread, dest) => fh.read(length, true, {dest}) :
+        (length) => fh.read(length);
+    return this.readv_(fh, read, lengths, dests);
   }
 
   /**
@@ -395,6 +810,21 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
     return fh.write(buf);
   }
 
+  /**
+   * @param {!WASI_t.fd} fd
+   * @param {!Array<!Uint8Array>} bufs
+   * @return {!WASI_t.errno|{nwritten: !WASI_t.size}}
+   * @override
+   */
+  async handle_fd_writev(fd, bufs) {
+    const fh = this.vfs.getFileHandle(fd);
+    if (fh === undefined) {
+      return WASI.errno.EBADF;
+    }
+
+    return this.writev_((buf) => fh.write(buf), bufs);
+  }
+
   /**
    * @param {!WASI_t.fd} fd
    * @param {?string} path
@@ -464,48 +894,29 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
    * @override
    */
   async handle_poll_oneoff(subscriptions) {
-    const now = BigInt(Date.now());
-
-    const sleep = async (msec) => {
-      return new Promise((resolve) => {
-        this.debug(`poll: sleeping for ${msec} milliseconds`);
-        const resolveIt = () => {
-          resolve();
-          this.notify_ = null;
-        };
-        const timeout = setTimeout(resolveIt, Number(msec));
-        this.notify_ = () => {
-          this.debug('poll: data has arrived!');
-          clearTimeout(timeout);
-          resolveIt();
-        };
-      });
-    };
-
-    // Find the earliest clock timeout.
+    // Find the earliest clock timeout.  All timeouts are tracked against the
+    // util.monotonicNow() timeline.
     let timeout;
     let userdata;
-    subscriptions.forEach((subscription) => {
+    for (const subscription of subscriptions) {
       if (subscription.tag === WASI.eventtype.CLOCK) {
-        // The standard C lib doesn't use other clocks, so this is future-proof.
-        if (subscription.clock.id !== WASI.clock.REALTIME) {
-          return WASI.errno.ENOTSUP;
+        const ret = util.clockDeadline(subscription.clock);
+        if (typeof ret === 'number') {
+          return ret;
         }
 
-        let subTimeout;
-        // The timeout is in nanoseconds.  We can do milliseconds at best.
-        subTimeout = subscription.clock.timeout / BigInt(kNanosecToMillisec);
-        if ((subscription.clock.flags & 1) === 0) {
-          // The timeout is relative.
-          subTimeout += now;
-        }
-
-        if (!timeout || subTimeout < timeout) {
+        if (timeout === undefined || ret.deadline < timeout) {
           userdata = subscription.userdata;
-          timeout = subTimeout;
+          timeout = ret.deadline;
         }
       }
-    });
+    }
+
+    // Polls that also watch pipes end early when one changes (without any
+    // events) so the program can recheck them.
+    const pipes = subscriptions.some(
+        ({userdata}) => userdata === SyscallHandler.kPipePollUserdata);
+    const pipesChanged = () => pipes && this.process_.cache.takePipesPending();
 
     // If there's only a timeout, wait for it.
     const timeoutEvent = {
@@ -518,24 +929,32 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
       },
     };
     if (subscriptions.length === 1 && timeout !== undefined) {
-      const delay = timeout - BigInt(Date.now());
-      if (delay > 0) {
-        await sleep(delay);
+      // Only signals & pipe changes interrupt the sleep; other fd activity is
+      // ignored.
+      let delay;
+      while ((delay = timeout - util.monotonicNow()) > 0) {
+        const ready = this.getReady_();
+        if (this.process_.signal_queue.length) {
+          // Without the timeout event, the program sees EINTR.
+          return {events: [], signals: this.takeSignals_()};
+        }
+        if (pipesChanged()) {
+          return {events: []};
+        }
+        await this.sleep_(ready, delay);
       }
 
       // If signals came in, return them too.
-      let signals;
-      if (this.process_.signal_queue.length) {
-        signals = Array.from(this.process_.signal_queue);
-        this.process_.signal_queue.length = 0;
-      }
-
-      return {events: [timeoutEvent], signals};
+      return {events: [timeoutEvent], signals: this.takeSignals_()};
     }
 
     // Poll for a while.
     const events = [];
     while (events.length === 0) {
+      const ready = this.getReady_();
+      if (pipesChanged()) {
+        break;
+      }
       for (let i = 0; i < subscriptions.length; ++i) {
         const subscription = subscriptions[i];
         const eventBase = {
@@ -565,11 +984,24 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
                      handle.filetype === WASI.filetype.CHARACTER_DEVICE) {
             // If it's a socket, see if any data is available.
             if (subscription.tag === WASI.eventtype.FD_READ) {
-              if (handle.data.length || handle?.clients_?.length) {
-                events.push(eventBase);
+              if (this.readReady_(handle)) {
+                // Let the C library implement FIONREAD via poll.
+                const nbytes = handle instanceof Sockets.Socket ?
+                    handle.pendingBytes() : handle.data.length;
+                const ended =
+                    handle instanceof Sockets.Socket && handle.recvEnded();
+                events.push({
+                  ...eventBase,
+                  fd_readwrite: {
+                    flags: ended ? WASI.eventrwflags.FD_READWRITE_HANGUP : 0,
+                    nbytes: BigInt(nbytes),
+                  },
+                });
               }
             } else if (subscription.tag === WASI.eventtype.FD_WRITE) {
-              events.push(eventBase);
+              if (!(handle instanceof Sockets.Socket) || handle.writeReady()) {
+                events.push(eventBase);
+              }
             }
           } else {
             events.push({...eventBase, error: WASI.errno.ENOTSUP});
@@ -578,39 +1010,25 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
       }
 
       // See if we ran into the timeout.
-      if (timeout !== undefined) {
-        if (timeout <= Date.now()) {
-          events.push(timeoutEvent);
-        }
+      if (timeout !== undefined && timeout <= util.monotonicNow()) {
+        events.push(timeoutEvent);
+      }
 
-        // If we still have work to do, wait for a wakeup or timeout.
-        if (events.length === 0) {
-          const delay = timeout - BigInt(Date.now());
-          if (delay > 0) {
-            await sleep(delay);
-          }
-        }
-      } else {
-        // If a signal came in, don't keep waiting for events.
-        if (this.process_.signal_queue.length) {
-          break;
-        }
+      // If a signal came in, don't keep waiting for events.
+      if (this.process_.signal_queue.length) {
+        break;
+      }
 
-        // If we still have work to do, wait for a wakeup.
-        if (events.length === 0) {
-          await sleep(30000);
-        }
+      // If we still have work to do, wait for a wakeup or timeout.
+      if (events.length === 0) {
+        await this.sleep_(
+            ready,
+            timeout === undefined ? Infinity : timeout - util.monotonicNow());
       }
     }
 
     // If signals came in, return them too.
-    let signals;
-    if (this.process_.signal_queue.length) {
-      signals = Array.from(this.process_.signal_queue);
-      this.process_.signal_queue.length = 0;
-    }
-
-    return {events, signals};
+    return {events, signals: this.takeSignals_()};
   }
 
   /**
@@ -630,11 +1048,7 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
     if (typeof newHandle === 'number') {
       return newHandle;
     }
-    newHandle.setReceiveListener(() => {
-      if (this.notify_) {
-        this.notify_();
-      }
-    });
+    newHandle.setReceiveListener(() => this.onActivity_(newHandle));
     // NB: The accept code already initialized the socket.
 
     const newSocket = this.vfs.openHandle(newHandle);
@@ -667,7 +1081,7 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
     }
     if (newHandle !== handle) {
       // In case the handle changes, hot swap it.
-      newHandle.receiveListener_ = handle.receiveListener_;
+      newHandle.setReceiveListener(() => this.onActivity_(newHandle));
       handle.close();
       this.vfs.fds_.set(socket, newHandle);
     }
@@ -694,8 +1108,10 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
       console.warn(`shutdown(${handle}, ${how}): Assuming SHUT_RDWR`);
     }
 
+    // Unlike close, shutdown can report that queued data never made it out.
+    const ret = await handle.drain();
     await handle.close();
-    return WASI.errno.ESUCCESS;
+    return ret;
   }
 
   /**
@@ -781,11 +1197,7 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
         return WASI.errno.EAFNOSUPPORT;
     }
 
-    handle.setReceiveListener(() => {
-      if (this.notify_) {
-        this.notify_();
-      }
-    });
+    handle.setReceiveListener(() => this.onActivity_(handle));
 
     if (await handle.init() === false) {
       return WASI.errno.ENOSYS;
@@ -911,14 +1323,16 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
    * @param {!WASI_t.fd} socket
    * @param {number} length
    * @param {!WASI_t.s32} flags
+   * @param {!Uint8Array=} dest Program memory to read into, if possible.
    * @return {!WASI_t.errno|{
-   *   nwritten: number,
+   *   buf: (!Uint8Array|undefined),
+   *   nread: (number|undefined),
    *   domain: number,
    *   address: string,
    *   port: number,
    * }}
    */
-  async handle_sock_recvfrom(socket, length, flags) {
+  async handle_sock_recvfrom(socket, length, flags, dest = undefined) {
     const handle = this.vfs.getFileHandle(socket);
     if (handle === undefined) {
       return WASI.errno.EBADF;
@@ -927,10 +1341,15 @@ export class RemoteReceiverWasiPreview1 extends SyscallHandler.Base {
       return WASI.errno.ENOTSOCK;
     }
 
-    const ret = await handle.read(length, !(flags & Constants.MSG_DONTWAIT));
+    let ret = await handle.read(length, !(flags & Constants.MSG_DONTWAIT), {
+      peek: !!(flags & Constants.MSG_PEEK),
+      waitAll: !!(flags & Constants.MSG_WAITALL),
+      dest,
+    });
     if (typeof ret === 'number') {
       return ret;
     }
+    ret = util.writeReadResult(ret, dest);
 
     ret.domain = handle.domain;
     ret.address = Sockets.strAddrToArray(handle.address);
@@ -0,0 +1,131 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import {SyscallHandler, WASI} from '../../wasi-js-bindings/index.js';
+import {SyscallCache} from '../../wasi-js-bindings/js/syscall_cache.js';
+import * as Constants from './constants.js';
+import * as Sockets from './sockets.js';
+import {RemoteReceiverWasiPreview1} from './syscall_handler.js';
+
+/**
+ * @fileoverview Test suite for the syscall handler.
+ */
+
+/**
+ * Create a handler with just enough of a process for polling.
+ *
+ * @return {!RemoteReceiverWasiPreview1}
+ */
+function newHandler() {
+  const handler = new RemoteReceiverWasiPreview1();
+  handler.setProcess(/** @type {?} */ ({
+    signal_queue: [],
+    debug: () => {},
+    cache: new SyscallCache(),
+  }));
+  return handler;
+}
+
+/**
+ * Check epoll readiness reporting.
+ */
+describe('epoll', () => {
+  /**
+   * Watch a new stream socket for |events|.
+   *
+   * @param {!RemoteReceiverWasiPreview1} handler
+   * @param {number} events
+   * @return {{epfd: number, sock: !Sockets.StreamSocket}}
+   */
+  function watch(handler, events) {
+    const sock = new Sockets.StreamSocket(
+        Constants.AF_INET, Constants.SOCK_STREAM, 0);
+    const fd = handler.vfs.openHandle(sock);
+    const {fd: epfd} = handler.handle_fd_epoll_create();
+    assert.equal(handler.handle_fd_epoll_ctl(
+        epfd, Constants.EPOLL_CTL_ADD, fd, events, 7n), WASI.errno.ESUCCESS);
+    return {epfd, sock};
+  }
+
+  it('idle', async () => {
+    const handler = newHandler();
+    const {epfd} = watch(handler, Constants.EPOLLIN);
+    assert.deepStrictEqual(await handler.handle_fd_epoll_wait(epfd, 4, 0),
+                           {events: []});
+  });
+
+  it('peer close', async () => {
+    const handler = newHandler();
+    const {epfd, sock} = watch(
+        handler, Constants.EPOLLIN | Constants.EPOLLRDHUP);
+    sock.onRecvEnd();
+    // EOF is readable, and the hangup is reported even though it wasn't
+    // requested.
+    assert.deepStrictEqual(await handler.handle_fd_epoll_wait(epfd, 4, 0), {
+      events: [{
+        events: Constants.EPOLLIN | Constants.EPOLLRDHUP | Constants.EPOLLHUP,
+        data: 7n,
+      }],
+      signals: undefined,
+    });
+  });
+
+  it('reset', async () => {
+    const handler = newHandler();
+    const {epfd, sock} = watch(handler, Constants.EPOLLOUT);
+    sock.onRecvEnd(WASI.errno.ECONNRESET);
+    const ret = await handler.handle_fd_epoll_wait(epfd, 4, 0);
+    assert.equal(ret.events[0].events,
+                 Constants.EPOLLOUT | Constants.EPOLLHUP | Constants.EPOLLERR);
+  });
+
+  it('send queue full', async () => {
+    const handler = newHandler();
+    const {epfd, sock} = watch(handler, Constants.EPOLLOUT);
+    assert.equal(
+        (await handler.handle_fd_epoll_wait(epfd, 4, 0)).events.length, 1);
+
+    // Fill the send queue without letting it flush.
+    sock.sendQueued_ = sock.sendSize_();
+    assert.deepStrictEqual(await handler.handle_fd_epoll_wait(epfd, 4, 0),
+                           {events: []});
+  });
+});
+
+/**
+ * Check pipe changes end waits that watch pipes.
+ */
+describe('pipe notify', () => {
+  it('epoll', async () => {
+    const handler = newHandler();
+    const {fd: epfd} = handler.handle_fd_epoll_create();
+    assert.equal(handler.handle_fd_pipe_notify(), WASI.errno.ESUCCESS);
+    // This would block forever otherwise.
+    assert.deepStrictEqual(await handler.handle_fd_epoll_wait(epfd, 4, -1),
+                           {events: [], signals: undefined});
+  });
+
+  it('poll_oneoff', async () => {
+    const handler = newHandler();
+    const clock = {
+      userdata: SyscallHandler.kPipePollUserdata,
+      tag: WASI.eventtype.CLOCK,
+      clock: {
+        id: WASI.clock.MONOTONIC,
+        timeout: 0xffffffffn * 1000000n,
+        precision: 0n,
+        flags: 0,
+      },
+    };
+    handler.handle_fd_pipe_notify();
+    assert.deepStrictEqual(await handler.handle_poll_oneoff([clock]),
+                           {events: []});
+
+    // Other sleeps ignore it.
+    handler.handle_fd_pipe_notify();
+    const ret = await handler.handle_poll_oneoff(
+        [{...clock, userdata: 1n, clock: {...clock.clock, timeout: 0n}}]);
+    assert.equal(ret.events.length, 1);
+  });
+});
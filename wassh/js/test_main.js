@@ -13,6 +13,8 @@ libTest.main({
   files: [
     // go/keep-sorted start
     'js/sockets_tests.js',
+    'js/syscall_handler_tests.js',
+    'js/vfs_tests.js',
     // go/keep-sorted end
   ],
 });
@@ -184,7 +184,45 @@ export class FileHandler extends PathHandler {}
 export class FileHandle extends PathHandle {
   constructor(path, type = WASI.filetype.REGULAR_FILE) {
     super(path, type);
+    /**
+     * The file contents.
+     *
+     * Writes keep this as a view of the start of a bigger buffer, so appending
+     * doesn't copy the whole file every time.  Subclasses may still replace it
+     * outright.
+     *
+     * @type {!Uint8Array}
+     */
     this.data = new Uint8Array(0);
+    // The buffer this.data is a view of.  Everything past this.data is zero.
+    this.buffer_ = this.data;
+    // The last view of buffer_ we made, to notice this.data being replaced.
+    this.view_ = this.data;
+  }
+
+  /**
+   * Make sure the file is at least this big.
+   *
+   * The buffer grows by doubling so appends copy amortized O(1) bytes each.
+   * New space (e.g. holes from writing past the end) is zero.
+   *
+   * @param {number} size The new minimum size in bytes.
+   */
+  grow_(size) {
+    if (size <= this.data.length) {
+      return;
+    }
+
+    if (this.data !== this.view_) {
+      // The contents were replaced, so we don't know what's past the end.
+      this.buffer_ = this.data;
+    }
+    if (size > this.buffer_.length) {
+      const buffer = new Uint8Array(Math.max(size, this.buffer_.length * 2));
+      buffer.set(this.data);
+      this.buffer_ = buffer;
+    }
+    this.data = this.view_ = this.buffer_.subarray(0, size);
   }
 
   /**
@@ -193,7 +231,9 @@ export class FileHandle extends PathHandle {
    * @override
    */
   async write(buf) {
-    buf = new Uint8Array(buf);
+    if (!(buf instanceof Uint8Array)) {
+      buf = new Uint8Array(buf);
+    }
     const ret = this.pwrite(buf, this.pos);
     this.pos += BigInt(buf.byteLength);
     return ret;
@@ -206,13 +246,12 @@ export class FileHandle extends PathHandle {
    * @override
    */
   async pwrite(buf, offset) {
-    buf = new Uint8Array(buf);
-    offset = Number(offset);
-    if (this.data.length < offset + buf.length) {
-      const data = new Uint8Array(offset + buf.length);
-      data.set(this.data);
-      this.data = data;
+    // Write straight from the caller's buffer rather than copying it first.
+    if (!(buf instanceof Uint8Array)) {
+      buf = new Uint8Array(buf);
     }
+    offset = Number(offset);
+    this.grow_(offset + buf.length);
     this.data.set(buf, offset);
     return {nwritten: buf.length};
   }
@@ -281,13 +320,8 @@ export class FileHandle extends PathHandle {
       return WASI.errno.EINVAL;
     }
 
-    if (newoffset > this.data.length) {
-      // If seeking beyond the end, zero pad it.
-      const data = new Uint8Array(Number(newoffset));
-      data.set(this.data);
-      this.data = data;
-    }
-
+    // Seeking past the end doesn't change the file.  Writing there leaves a
+    // hole of zeros (see grow_).
     this.pos = newoffset;
     return {newoffset: this.pos};
   }
@@ -666,6 +700,115 @@ export class DevNullHandle extends PathHandle {
   }
 }
 
+/**
+ * Placeholder for pipe() & socketpair() fds.
+ *
+ * The C library keeps all the data in WASM memory, so this only reserves the
+ * fd and remembers the fd flags.  All I/O is rejected via PathHandle.
+ */
+export class PipeHandle extends PathHandle {
+  constructor(filetype = WASI.filetype.UNKNOWN) {
+    super('pipe', filetype);
+    /** @type {!WASI_t.fdflags} */
+    this.fdflags = 0;
+  }
+
+  /**
+   * @return {!Promise<!WASI_t.errno|!WASI_t.fdstat>}
+   * @override
+   */
+  async stat() {
+    return /** @type {!WASI_t.fdstat} */ ({
+      fs_filetype: this.filetype,
+      fs_flags: this.fdflags,
+    });
+  }
+}
+
+/**
+ * An epoll instance.
+ *
+ * The interest set is registered once and lives here.  We also track which
+ * fds have seen activity since they were last checked, so waiting only has to
+ * look at those rather than every fd in the set.
+ */
+export class EpollHandle extends PathHandle {
+  constructor() {
+    super('epoll', WASI.filetype.UNKNOWN);
+    /**
+     * The watched fds.
+     *
+     * @const {!Map<!WASI_t.fd, {handle: !PathHandle, events: number,
+     *                           data: bigint}>}
+     */
+    this.interests = new Map();
+    /**
+     * The fds that might be ready.
+     *
+     * @const {!Set<!WASI_t.fd>}
+     */
+    this.ready = new Set();
+    /**
+     * Reverse map of handles to the fds watching them.
+     *
+     * @const {!Map<!PathHandle, !Set<!WASI_t.fd>>}
+     * @private
+     */
+    this.watchers_ = new Map();
+  }
+
+  /**
+   * Add or update an fd in the interest set.
+   *
+   * @param {!WASI_t.fd} fd
+   * @param {!PathHandle} handle The handle |fd| refers to.
+   * @param {number} events The EPOLL* events to watch for.
+   * @param {bigint} data The user data to return with events.
+   */
+  set(fd, handle, events, data) {
+    this.delete(fd);
+    this.interests.set(fd, {handle, events, data});
+    let fds = this.watchers_.get(handle);
+    if (fds === undefined) {
+      fds = new Set();
+      this.watchers_.set(handle, fds);
+    }
+    fds.add(fd);
+    // Check it on the next wait.
+    this.ready.add(fd);
+  }
+
+  /**
+   * Remove an fd from the interest set.
+   *
+   * @param {!WASI_t.fd} fd
+   * @return {boolean} Whether the fd was in the set.
+   */
+  delete(fd) {
+    const interest = this.interests.get(fd);
+    if (interest === undefined) {
+      return false;
+    }
+    const fds = this.watchers_.get(interest.handle);
+    fds.delete(fd);
+    if (fds.size === 0) {
+      this.watchers_.delete(interest.handle);
+    }
+    this.interests.delete(fd);
+    this.ready.delete(fd);
+    return true;
+  }
+
+  /**
+   * Mark all fds watching |handle| as possibly ready.
+   *
+   * @param {!PathHandle} handle
+   */
+  onActivity(handle) {
+    this.watchers_.get(handle)?.forEach((fd) => this.ready.add(fd));
+  }
+}
+
 class PathMap extends Map {
 }
 
@@ -961,6 +1104,25 @@ export class VFS {
     return {fd};
   }
 
+  /**
+   * @param {!WASI_t.filetype} filetype
+   * @return {!WASI_t.errno|{fds: !Array<!WASI_t.fd>}}
+   */
+  pipe(filetype) {
+    this.debug(`pipe(${filetype})`);
+
+    const fd0 = this.openHandle(new PipeHandle(filetype));
+    if (fd0 < 0) {
+      return WASI.errno.EMFILE;
+    }
+    const fd1 = this.openHandle(new PipeHandle(filetype));
+    if (fd1 < 0) {
+      this.close(fd0);
+      return WASI.errno.EMFILE;
+    }
+    return {fds: [fd0, fd1]};
+  }
+
   dup2(oldfd, newfd) {
     this.debug(`dup2(${oldfd}, ${newfd})`);
 
@@ -0,0 +1,104 @@
+// Copyright 2026 The ChromiumOS Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import {WASI} from '../../wasi-js-bindings/index.js';
+import * as VFS from './vfs.js';
+
+/**
+ * @fileoverview Test suite for VFS code.
+ */
+
+/**
+ * Check epoll interest & activity tracking.
+ */
+describe('EpollHandle', () => {
+  it('set', () => {
+    const ep = new VFS.EpollHandle();
+    const handle = new VFS.PathHandle('sock', WASI.filetype.SOCKET_STREAM);
+    ep.set(3, handle, 1, 10n);
+    assert.deepStrictEqual(ep.interests.get(3), {handle, events: 1, data: 10n});
+    // New interests get checked on the next wait.
+    assert.deepStrictEqual(Array.from(ep.ready), [3]);
+  });
+
+  it('delete', () => {
+    const ep = new VFS.EpollHandle();
+    const handle = new VFS.PathHandle('sock', WASI.filetype.SOCKET_STREAM);
+    ep.set(3, handle, 1, 0n);
+    assert.isTrue(ep.delete(3));
+    assert.isFalse(ep.delete(3));
+    assert.equal(ep.interests.size, 0);
+    assert.equal(ep.ready.size, 0);
+
+    // Activity on the handle shouldn't resurrect it.
+    ep.onActivity(handle);
+    assert.equal(ep.ready.size, 0);
+  });
+
+  it('onActivity', () => {
+    const ep = new VFS.EpollHandle();
+    const handle1 = new VFS.PathHandle('sock1', WASI.filetype.SOCKET_STREAM);
+    const handle2 = new VFS.PathHandle('sock2', WASI.filetype.SOCKET_STREAM);
+    ep.set(3, handle1, 1, 0n);
+    ep.set(4, handle1, 1, 0n);
+    ep.set(5, handle2, 1, 0n);
+    ep.ready.clear();
+
+    // Only fds watching the active handle are marked.
+    ep.onActivity(handle1);
+    assert.deepStrictEqual(Array.from(ep.ready).sort(), [3, 4]);
+  });
+});
+
+/**
+ * Check file storage.
+ */
+describe('FileHandle', () => {
+  it('append', async () => {
+    const fh = new VFS.FileHandle('file');
+    for (let i = 0; i < 100; ++i) {
+      assert.deepStrictEqual(await fh.write(new Uint8Array([i])),
+                             {nwritten: 1});
+    }
+    assert.equal(fh.data.length, 100);
+    assert.deepStrictEqual(fh.data, new Uint8Array(100).map((_, i) => i));
+    // Appends reuse spare space rather than copying every time.
+    assert.isAbove(fh.buffer_.length, 100);
+  });
+
+  it('pread', async () => {
+    const fh = new VFS.FileHandle('file');
+    await fh.write(new Uint8Array([1, 2, 3, 4]));
+    const {buf} = await fh.pread(2, 1);
+    assert.deepStrictEqual(buf, new Uint8Array([2, 3]));
+    // Reads don't copy.
+    assert.strictEqual(buf.buffer, fh.data.buffer);
+    assert.deepStrictEqual(await fh.pread(2, 10), {buf: new Uint8Array(0)});
+  });
+
+  it('holes', async () => {
+    const fh = new VFS.FileHandle('file');
+    await fh.write(new Uint8Array([1, 2]));
+
+    // Seeking past the end doesn't change the file.
+    assert.deepStrictEqual(fh.seek(6, WASI.whence.SET), {newoffset: 6n});
+    assert.equal(fh.data.length, 2);
+    assert.deepStrictEqual(fh.seek(0, WASI.whence.END), {newoffset: 2n});
+
+    // But writing there fills the gap with zeros.
+    fh.seek(6, WASI.whence.SET);
+    await fh.write(new Uint8Array([3]));
+    assert.deepStrictEqual(fh.data, new Uint8Array([1, 2, 0, 0, 0, 0, 3]));
+  });
+
+  it('replaced data', async () => {
+    const fh = new VFS.FileHandle('file');
+    await fh.write(new Uint8Array(10).fill(9));
+
+    // Subclasses may load or trim the contents themselves.
+    fh.data = new Uint8Array([1, 2, 3, 4]).subarray(0, 2);
+    await fh.pwrite(new Uint8Array([5]), 3);
+    assert.deepStrictEqual(fh.data, new Uint8Array([1, 2, 0, 5]));
+  });
+});
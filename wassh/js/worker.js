@@ -15,20 +15,30 @@ import * as WasshProcess from './process.js';
 import * as WasshSyscallEntry from './syscall_entry.js';
 
 class WasshWorker extends BackgroundWorker.Base {
-  newProcess(executable, argv, environ, sab, handler_ids) {
+  newProcess(executable, argv, environ, sab, handler_ids, cache_sab,
+             slot) {
     const trace = (params.get('trace') ?? 'false') === 'true';
     const debug = trace;
+    const profile = (params.get('profile') ?? 'false') === 'true';
+    const record = (params.get('record') ?? 'false') === 'true';
 
-    const sys_handlers = [
-      new SyscallHandler.ProxyWasiPreview1(this, sab, handler_ids),
+    const proxy = new SyscallHandler.ProxyWasiPreview1(
+        this, sab, handler_ids, slot);
+    let sys_handlers = [
+      new SyscallHandler.CachedWasiPreview1(cache_sab, proxy),
+      proxy,
       new SyscallHandler.DirectWasiPreview1(),
     ];
+    if (record) {
+      sys_handlers = [new SyscallHandler.RecordWasiPreview1(sys_handlers)];
+    }
     const sys_entries = [
       new SyscallEntry.WasiPreview1({sys_handlers, debug, trace}),
       new WasshSyscallEntry.WasshExperimental({sys_handlers, debug, trace}),
     ];
-    return new WasshProcess.Foreground(
-        {executable, argv, environ, sys_handlers, sys_entries, debug});
+    return new WasshProcess.Foreground({
+      executable, argv, environ, sys_handlers, sys_entries, debug, profile,
+    });
   }
 }
 